@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gameplay/station/orders.hpp"
+#include "tools/hash.hpp"
+
+namespace {
+
+/**
+ * Number of merchs traded.
+ */
+const types::id merchCount = 64;
+
+/**
+ * Place random orders from several threads.
+ * @param book Order book to place the orders in.
+ * @param count Number of orders.
+ * @param threadCount Number of threads.
+ */
+void place(station::OrderBook& book, const std::size_t count, const std::size_t threadCount) {
+    std::vector<std::thread> threads;
+
+    for (std::size_t thread = 0; thread < threadCount; thread++) {
+        threads.emplace_back([&book, count, threadCount, thread]() {
+            // orders only depend on their index, not on the threads
+            for (std::size_t index = thread; index < count; index += threadCount) {
+                std::uint64_t value = hash::mix(index);
+                station::Side side = index % 2 ? station::Side::buy : station::Side::sell;
+                book.submit({static_cast<types::id>(index % 4096),
+                             static_cast<types::id>(value % merchCount + 1), side,
+                             static_cast<types::price>(50 + (value >> 16) % 100),
+                             static_cast<types::quantity>(1 + (value >> 32) % 40)
+                            });
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}
+
+/**
+ * Time placing and matching orders with an increasing number of threads.
+ * Usage: `benchmark-orders [ORDERS [THREADS]]`, using all the cores by default.
+ */
+int main(int argc, char* argv[]) {
+    std::size_t orderCount = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::size_t maxThreadCount = argc > 2 ? std::stoul(argv[2]) :
+                                 std::max(1u, std::thread::hardware_concurrency());
+
+    if (!orderCount || !maxThreadCount) {
+        std::cerr << "Usage: " << argv[0] << " [ORDERS [THREADS]]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::size_t expectedCount = 0;
+    std::cout << "orders: " << orderCount << " over " << merchCount << " merchs" << std::endl;
+
+    for (std::size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+        station::OrderBook book;
+        auto start = std::chrono::steady_clock::now();
+        place(book, orderCount, threadCount);
+        auto placed = std::chrono::steady_clock::now();
+        std::size_t tradeCount = book.match(threadCount).size();
+        auto matched = std::chrono::steady_clock::now();
+
+        std::chrono::duration<double, std::milli> placing = placed - start;
+        std::chrono::duration<double, std::milli> matching = matched - placed;
+        std::cout << "threads: " << threadCount << ", placing: " << placing.count() <<
+                  " ms, matching: " << matching.count() << " ms, trades: " << tradeCount <<
+                  std::endl;
+
+        if (threadCount == 1) expectedCount = tradeCount;
+
+        if (tradeCount != expectedCount) {
+            std::cerr << "Matching depends on threads" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
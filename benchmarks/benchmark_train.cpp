@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gameplay/train/train.hpp"
+
+namespace {
+
+/**
+ * Number of passes over all the trains.
+ */
+const std::size_t passCount = 20;
+
+/**
+ * Train able to pass over its car objects.
+ */
+class Train : public train::Train {
+  public:
+
+    /**
+     * Sum the weight and the power of the train car by car.
+     * This is how whole-train passes were done before trains kept the hot
+     * state of their cars packed.
+     * @return Traction characteristics of the train.
+     */
+    traction::Traction computeByCar() const {
+        types::weight weight = 0;
+        types::power power = 0;
+
+        for (const auto index : consist) {
+            const cars::Car* car = slots[index].car;
+            weight += car->getWeight();
+
+            auto locomotive = dynamic_cast<const cars::Locomotive*>(car);
+
+            if (locomotive) power += locomotive->getPower();
+        }
+
+        return traction::compute(weight, power);
+    }
+};
+
+/**
+ * Time passes over all the trains.
+ * @param trains Trains.
+ * @param pass Function computing the traction of a train.
+ * @param weight Total weight found, to check both passes agree.
+ * @return Duration of a pass per car, in nanoseconds.
+ */
+template <typename Pass>
+double time(const std::vector<std::unique_ptr<Train>>& trains, Pass pass,
+            types::weight& weight) {
+    std::size_t carCount = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t index = 0; index < passCount; index++) {
+        weight = 0;
+
+        for (const auto& train : trains) {
+            weight += pass(*train).weight;
+            carCount += train->getSize();
+        }
+    }
+
+    std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / carCount;
+}
+
+}
+
+/**
+ * Compare whole-train passes over car objects and over packed hot states.
+ * Usage: `benchmark-train [CARS [TRAINS]]`.
+ */
+int main(int argc, char* argv[]) {
+    std::size_t carCount = argc > 1 ? std::stoul(argv[1]) : 64;
+    std::size_t trainCount = argc > 2 ? std::stoul(argv[2]) : 4096;
+
+    if (!carCount || !trainCount) {
+        std::cerr << "Usage: " << argv[0] << " [CARS [TRAINS]]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::unique_ptr<Train>> trains;
+
+    for (std::size_t index = 0; index < trainCount; index++) {
+        trains.emplace_back(new Train());
+        trains.back()->makeOwnedCar<cars::Locomotive>(1, "locomotive", 100, 1000);
+    }
+
+    // add cars to the trains in turn, so that the cars of a train are spread
+    // in memory as in a long game
+    for (std::size_t position = 1; position < carCount; position++) {
+        for (const auto& train : trains) {
+            merchandises::MerchLoad merchLoad(merchandises::wood, 10, 10);
+            train->makeOwnedCar<cars::LoadCar>(cars::Merchandise(merchLoad));
+        }
+    }
+
+    types::weight byCarWeight = 0;
+    types::weight packedWeight = 0;
+    double byCar = time(trains, [](const Train & train) {
+        return train.computeByCar();
+    }, byCarWeight);
+    double packed = time(trains, [](const Train & train) {
+        return train.computeTraction();
+    }, packedWeight);
+
+    std::cout << "trains: " << trainCount << " of " << carCount << " cars" << std::endl;
+    std::cout << "car by car: " << byCar << " ns/car" << std::endl;
+    std::cout << "packed states: " << packed << " ns/car" << std::endl;
+    std::cout << "speedup: " << byCar / packed << std::endl;
+
+    if (std::abs(byCarWeight - packedWeight) > byCarWeight * 1e-6) {
+        std::cerr << "Passes disagree: " << byCarWeight << " and " << packedWeight << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
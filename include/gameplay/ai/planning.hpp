@@ -0,0 +1,412 @@
+#ifndef PLANNING_HPP
+#define PLANNING_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/station/warehouse.hpp"
+#include "gameplay/train/merchandises.hpp"
+#include "gameplay/train/train.hpp"
+#include "types.hpp"
+
+/**
+ * Planning of the decisions of trains driven by the AI.
+ * Plans are computed on worker threads against a snapshot of the train, so
+ * that the tick is not stalled, then applied to the train at the next tick
+ * boundary, unless the train changed in the meantime.
+ */
+namespace ai {
+
+/**
+ * Snapshot of a car.
+ * The fields of the load are left to 0 for destroyed cars.
+ */
+struct CarSnapshot {
+    /**
+     * Unique ID of the car.
+     */
+    types::id carId;
+
+    /**
+     * Weight of the car, including its load.
+     */
+    types::weight weight;
+
+    /**
+     * Tell if the car is destroyed.
+     */
+    bool isDestroyed;
+
+    /**
+     * Tell if the car is a load car.
+     */
+    bool isLoadCar;
+
+    /**
+     * Type of merch the car accepts, if it is a load car.
+     */
+    merchandises::MerchTypes merchType;
+
+    /**
+     * ID of the merch loaded, or 0 if the car is empty.
+     */
+    types::id merch;
+
+    /**
+     * Quantity loaded.
+     */
+    types::quantity quantity;
+
+    /**
+     * Highest quantity the car holds.
+     */
+    types::quantity maxQuantity;
+
+    /**
+     * Average price of the load.
+     */
+    types::price price;
+};
+
+/**
+ * Immutable snapshot of a train.
+ */
+struct Snapshot {
+    /**
+     * Hash of the state of the train when the snapshot was taken.
+     */
+    std::uint64_t hash;
+
+    /**
+     * Cars, in the order of the train.
+     */
+    std::vector<CarSnapshot> cars;
+};
+
+/**
+ * Take a snapshot of a train.
+ * @param train Train to consider.
+ * @return Snapshot.
+ */
+Snapshot takeSnapshot(const train::Train& train);
+
+/**
+ * Type of a planned action.
+ */
+enum class ActionType {
+    /**
+     * Load merchandise from the warehouse in a car.
+     */
+    load,
+
+    /**
+     * Unload merchandise from a car to the warehouse.
+     */
+    unLoad,
+
+    /**
+     * Move a car to another position.
+     */
+    moveCar
+};
+
+/**
+ * Planned action on a train.
+ */
+struct Action {
+    /**
+     * Type of the action.
+     */
+    ActionType type;
+
+    /**
+     * Unique ID of the car.
+     */
+    types::id carId;
+
+    /**
+     * ID of the merch to load.
+     */
+    types::id merch;
+
+    /**
+     * Quantity to load or to unload.
+     */
+    types::quantity quantity;
+
+    /**
+     * Position to move the car to.
+     */
+    std::size_t position;
+};
+
+/**
+ * Planner of the actions of a train.
+ * Planners are called from worker threads and must not share state between
+ * calls without synchronization.
+ */
+class Planner {
+  public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Planner() {}
+
+    /**
+     * Plan the actions of a train.
+     * Long plannings should check the cancellation flag from time to time and
+     * give up when it is set.
+     * @param snapshot Snapshot of the train.
+     * @param isCancelled Flag set when the plan is not needed anymore.
+     * @return Actions, applied in order.
+     */
+    virtual std::vector<Action> plan(const Snapshot& snapshot,
+                                     const std::atomic<bool>& isCancelled) const = 0;
+};
+
+/**
+ * Outcome of the plans applied at a tick boundary.
+ */
+struct Report {
+    /**
+     * Number of plans applied.
+     */
+    std::size_t applied;
+
+    /**
+     * Number of plans dropped, because the train changed or the plan was
+     * cancelled.
+     */
+    std::size_t stale;
+
+    /**
+     * Number of plans that could not be applied, or whose planner failed.
+     * Trains and warehouses are left untouched by these plans.
+     */
+    std::size_t failed;
+};
+
+/**
+ * System running planning jobs on worker threads.
+ * Jobs are submitted and plans applied from the game thread only. Each train
+ * has at most one job: submitting a new job cancels the previous one, and so
+ * does any change of the train before its plan is applied. Plans completed
+ * during a tick are applied at the next call to `update`, in the order the
+ * jobs were submitted, so that the outcome does not depend on the threads.
+ *
+ * Trains and warehouses must outlive their jobs, or their jobs must be
+ * cancelled before they are destroyed.
+ */
+class JobSystem {
+    /**
+     * Job shared between the game thread and the workers.
+     */
+    struct Job {
+        /**
+         * Order of submission.
+         */
+        std::uint64_t sequence;
+
+        /**
+         * Train to plan for.
+         */
+        train::Train* train;
+
+        /**
+         * Warehouse to trade with.
+         */
+        station::Warehouse* warehouse;
+
+        /**
+         * Snapshot of the train.
+         */
+        Snapshot snapshot;
+
+        /**
+         * Planner.
+         */
+        std::shared_ptr<const Planner> planner;
+
+        /**
+         * Flag set when the job is cancelled.
+         */
+        std::shared_ptr<std::atomic<bool>> isCancelled;
+
+        /**
+         * Planned actions.
+         */
+        std::vector<Action> actions;
+
+        /**
+         * Tell if the planner failed.
+         */
+        bool isFailed;
+    };
+
+    /**
+     * Job of a train not applied yet.
+     */
+    struct Tracking {
+        /**
+         * Hash of the train when the job was submitted.
+         */
+        std::uint64_t hash;
+
+        /**
+         * Flag set when the job is cancelled.
+         */
+        std::shared_ptr<std::atomic<bool>> isCancelled;
+    };
+
+    /**
+     * Lock of the queues.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * Condition notified when a job is queued or the system stops.
+     */
+    std::condition_variable jobQueued;
+
+    /**
+     * Condition notified when a job is completed.
+     */
+    std::condition_variable jobCompleted;
+
+    /**
+     * Jobs waiting for a worker.
+     */
+    std::deque<Job> jobs;
+
+    /**
+     * Jobs completed since the last update.
+     */
+    std::vector<Job> completed;
+
+    /**
+     * Number of jobs being planned by workers.
+     */
+    std::size_t runningCount;
+
+    /**
+     * Tell if the workers must stop.
+     */
+    bool isStopping;
+
+    /**
+     * Jobs not applied yet, by train.
+     * Only used by the game thread.
+     */
+    std::unordered_map<const train::Train*, Tracking> tracked;
+
+    /**
+     * Number of jobs submitted.
+     */
+    std::uint64_t submittedCount;
+
+    /**
+     * Worker threads.
+     */
+    std::vector<std::thread> workers;
+
+    /**
+     * Run jobs until the system stops.
+     */
+    void work();
+
+    /**
+     * Apply the actions of a job.
+     * The application is all or nothing.
+     * @param job Completed job.
+     */
+    static void apply(const Job& job);
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param threadCount Number of worker threads, or 0 to use all the cores.
+     */
+    explicit JobSystem(const std::size_t threadCount = 0);
+
+    /**
+     * Deleted copy constructor.
+     */
+    JobSystem(const JobSystem&) = delete;
+
+    /**
+     * Deleted copy assignment operator.
+     */
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Destructor.
+     * Jobs not started are dropped, jobs being planned are waited for.
+     */
+    ~JobSystem();
+
+    /**
+     * Submit a planning job for a train.
+     * The snapshot of the train is taken at once. The previous job of the
+     * train is cancelled.
+     * @param train Train to plan for.
+     * @param warehouse Warehouse to load from and unload to.
+     * @param planner Planner.
+     */
+    void submit(train::Train& train, station::Warehouse& warehouse,
+                std::shared_ptr<const Planner> planner);
+
+    /**
+     * Cancel the job of a train.
+     * @param train Train to consider.
+     * @return True if the train had a job.
+     */
+    bool cancel(const train::Train& train);
+
+    /**
+     * Tell if a train has a job not applied yet.
+     * @param train Train to consider.
+     * @return True if the train has a job.
+     */
+    bool hasJob(const train::Train& train) const;
+
+    /**
+     * Apply the completed plans.
+     * To call at tick boundaries. Jobs of trains that changed since their
+     * submission are cancelled, and their plans dropped.
+     * @return Outcome of the plans.
+     */
+    Report update();
+
+    /**
+     * Wait for all the submitted jobs to be completed.
+     * The plans are not applied.
+     */
+    void wait();
+};
+
+/**
+ * Error class used when an action cannot be applied.
+ */
+struct InvalidActionError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Action cannot be applied to train";
+    }
+};
+
+}
+
+#endif // ifndef PLANNING_HPP
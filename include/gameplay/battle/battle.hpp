@@ -0,0 +1,231 @@
+#ifndef BATTLE_HPP
+#define BATTLE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/train/train.hpp"
+#include "types.hpp"
+
+/**
+ * Battles between trains.
+ * In each round, every car still standing shoots at a random car of the
+ * other train, both trains shooting at the same time. A train is defeated
+ * when all its cars are destroyed, or when all its locomotives are.
+ */
+namespace battle {
+
+/**
+ * Rules of a battle.
+ */
+struct Rules {
+    /**
+     * Lowest dammage of a shot.
+     */
+    types::health minAttack;
+
+    /**
+     * Highest dammage of a shot.
+     */
+    types::health maxAttack;
+
+    /**
+     * Number of rounds after which the battle is a draw.
+     */
+    unsigned int maxRounds;
+};
+
+/**
+ * Default rules.
+ */
+const Rules defaultRules = {5, 25, 50};
+
+/**
+ * Number of engagements simulated with the same random stream.
+ * Streams do not depend on the number of threads, so neither do the odds.
+ */
+const std::size_t batchSize = 256;
+
+/**
+ * Expected losses of a train.
+ */
+struct Losses {
+    /**
+     * Number of cars destroyed.
+     */
+    float cars;
+
+    /**
+     * Quantity of cargo lost with the destroyed cars.
+     */
+    float cargo;
+
+    /**
+     * Value of the cargo lost.
+     */
+    float value;
+};
+
+/**
+ * Predicted outcome of a battle.
+ */
+struct Odds {
+    /**
+     * Probability to defeat the enemy.
+     */
+    float win;
+
+    /**
+     * Probability to be defeated.
+     */
+    float loss;
+
+    /**
+     * Probability that both trains are defeated or that none is.
+     */
+    float draw;
+
+    /**
+     * Expected losses of the train.
+     */
+    Losses losses;
+
+    /**
+     * Expected losses of the enemy.
+     */
+    Losses enemyLosses;
+};
+
+/**
+ * Monte Carlo battle simulator.
+ * Trains are copied once in flat arrays, so that engagements are simulated
+ * without touching the cars and the trains can change afterwards.
+ * Engagements are split in batches, run in parallel, each batch having its
+ * own random stream seeded by the seed and the index of the batch.
+ */
+class Simulator {
+    /**
+     * Cars of a train, as flat arrays.
+     */
+    struct Side {
+        /**
+         * Health points of each car.
+         */
+        std::vector<types::health> healths;
+
+        /**
+         * Tell if each car is a locomotive.
+         */
+        std::vector<bool> locomotives;
+
+        /**
+         * Quantity of cargo of each car.
+         */
+        std::vector<types::quantity> cargos;
+
+        /**
+         * Value of the cargo of each car.
+         */
+        std::vector<float> values;
+
+        /**
+         * Number of locomotives standing at the start.
+         */
+        std::size_t locomotiveCount;
+    };
+
+    /**
+     * Outcomes of a batch of engagements.
+     */
+    struct Tally;
+
+    /**
+     * Working memory of an engagement.
+     */
+    struct Fight;
+
+    /**
+     * Rules of the battle.
+     */
+    Rules rules;
+
+    /**
+     * Cars of the train.
+     */
+    Side side;
+
+    /**
+     * Cars of the enemy.
+     */
+    Side enemy;
+
+    /**
+     * Copy the cars of a train.
+     * @param train Train to copy.
+     * @return Cars of the train.
+     */
+    static Side copy(const train::Train& train);
+
+    /**
+     * Simulate a batch of engagements.
+     * @param seed Seed of the battle.
+     * @param batch Index of the batch.
+     * @param count Number of engagements.
+     * @param fight Working memory.
+     * @return Outcomes of the batch.
+     */
+    Tally simulate(const std::uint32_t seed, const std::size_t batch, const std::size_t count,
+                   Fight& fight) const;
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param train Train to predict the odds of.
+     * @param enemy Train to fight.
+     * @param rules Rules of the battle.
+     */
+    Simulator(const train::Train& train, const train::Train& enemy,
+              const Rules& rules = defaultRules);
+
+    /**
+     * Predict the outcome of the battle.
+     * @param count Number of engagements to simulate.
+     * @param seed Seed of the random streams.
+     * @param threadCount Number of threads, or 0 to use all the cores.
+     * @return Odds of the train.
+     */
+    Odds predict(const std::size_t count, const std::uint32_t seed,
+                 const std::size_t threadCount = 0) const;
+};
+
+/**
+ * Error class used when the rules of a battle are inconsistent.
+ */
+struct InvalidRulesError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Invalid battle rules";
+    }
+};
+
+/**
+ * Error class used when predicting a battle without engagements.
+ */
+struct NoEngagementError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "At least one engagement must be simulated";
+    }
+};
+
+}
+
+#endif // ifndef BATTLE_HPP
@@ -0,0 +1,258 @@
+#ifndef CLIMATE_HPP
+#define CLIMATE_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/train/train.hpp"
+#include "types.hpp"
+
+/**
+ * Cold of the frozen world.
+ * The temperature inside each car follows the outside temperature, more or
+ * less slowly depending on the insulation of the car. Drinkable liquids
+ * freeze and living vegetals die when their car is too cold, a part of the
+ * cargo being lost for each degree and each hour below their threshold.
+ */
+namespace climate {
+
+/**
+ * Temperature of the cars when they are first tracked.
+ */
+const types::temperature initialTemperature = 10;
+
+/**
+ * Temperature below which drinkable liquids freeze.
+ */
+const types::temperature freezingPoint = -2;
+
+/**
+ * Temperature below which living vegetals are damaged.
+ */
+const types::temperature chillingPoint = 4;
+
+/**
+ * Part of a drinkable load lost per degree and per hour below the freezing
+ * point.
+ */
+const float freezingLoss = 0.01;
+
+/**
+ * Part of a vegetal load lost per degree and per hour below the chilling
+ * point.
+ */
+const float chillingLoss = 0.02;
+
+/**
+ * Climate of the world.
+ * The cars of all the trains tracked are copied in flat arrays, one value per
+ * car in each, so that a tick is a single pass without branches over
+ * contiguous memory, which the compiler vectorizes. Cars are only touched
+ * again when a whole unit of their load is lost.
+ *
+ * Trains are copied again when their hash changed since the last tick: in
+ * place if they kept their number of cars, otherwise the arrays are laid out
+ * again. Cars keep their temperature as long as they stay in their train.
+ * Tracked trains must outlive the climate, or be untracked first.
+ */
+class Climate {
+    /**
+     * Train tracked.
+     */
+    struct Tracked {
+        /**
+         * Train.
+         */
+        train::Train* train;
+
+        /**
+         * Hash of the train when its cars were copied.
+         */
+        std::uint64_t hash;
+
+        /**
+         * Index of the first car of the train in the arrays.
+         */
+        std::size_t first;
+
+        /**
+         * Number of cars of the train.
+         */
+        std::size_t count;
+    };
+
+    /**
+     * Cars, as flat arrays.
+     */
+    struct Rows {
+        /**
+         * Unique ID of each car.
+         */
+        std::vector<types::id> carIds;
+
+        /**
+         * Each car, if it is a load car whose load can be lost, or null
+         * pointer.
+         */
+        std::vector<cars::LoadCar*> loadCars;
+
+        /**
+         * Temperature inside each car.
+         */
+        std::vector<types::temperature> temperatures;
+
+        /**
+         * Inverse of the insulation of each car, per hour.
+         */
+        std::vector<float> conductances;
+
+        /**
+         * Temperature below which the load of each car is damaged.
+         */
+        std::vector<types::temperature> thresholds;
+
+        /**
+         * Quantity of the load of each car lost per degree and per hour below
+         * the threshold, 0 for cars with nothing to lose.
+         */
+        std::vector<float> lossRates;
+
+        /**
+         * Quantity of the load of each car lost and not removed yet.
+         */
+        std::vector<float> losses;
+
+        /**
+         * Change the number of cars.
+         * @param size New number of cars.
+         */
+        void resize(const std::size_t size);
+
+        /**
+         * Copy cars from other arrays.
+         * @param other Arrays to copy from.
+         * @param from Index of the first car to copy.
+         * @param to Index to copy the first car to.
+         * @param count Number of cars to copy.
+         */
+        void copy(const Rows& other, const std::size_t from, const std::size_t to,
+                  const std::size_t count);
+
+        /**
+         * Remove cars.
+         * @param first Index of the first car to remove.
+         * @param count Number of cars to remove.
+         */
+        void erase(const std::size_t first, const std::size_t count);
+    };
+
+    /**
+     * Trains tracked.
+     */
+    std::vector<Tracked> trains;
+
+    /**
+     * Index of the trains tracked, by address.
+     */
+    std::unordered_map<const train::Train*, std::size_t> indexes;
+
+    /**
+     * Cars of the trains tracked, train after train.
+     */
+    Rows rows;
+
+    /**
+     * Read the cars of a train.
+     * Cars that were already in the train keep their temperature and their
+     * loss.
+     * @param before Train as last read.
+     * @param after Train to read, giving where to write its cars.
+     * @param old Arrays the train was last read in.
+     * @param target Arrays to write the cars to, which can be the same.
+     */
+    static void read(const Tracked& before, const Tracked& after, const Rows& old,
+                     Rows& target);
+
+    /**
+     * Copy the trains that changed since the last tick.
+     */
+    void refresh();
+
+    /**
+     * Remove the whole units of load lost from the cars.
+     * @return Quantity removed.
+     */
+    types::quantity spoil();
+
+  public:
+
+    /**
+     * Default constructor.
+     */
+    Climate();
+
+    /**
+     * Track a train.
+     * @param train Train to consider.
+     * @return True if the train was not tracked yet.
+     */
+    bool track(train::Train& train);
+
+    /**
+     * Stop tracking a train.
+     * @param train Train to consider.
+     * @return True if the train was tracked.
+     */
+    bool untrack(const train::Train& train);
+
+    /**
+     * Tell if a train is tracked.
+     * @param train Train to consider.
+     * @return True if the train is tracked.
+     */
+    bool isTracked(const train::Train& train) const;
+
+    /**
+     * Getter for car count.
+     * @return Number of cars of the trains tracked, as of the last tick.
+     */
+    std::size_t getCarCount() const;
+
+    /**
+     * Getter for temperature.
+     * @param train Train of the car.
+     * @param carId Unique ID of the car.
+     * @return Temperature inside the car, as of the last tick.
+     * @throw UntrackedTrainError If the train is not tracked.
+     * @throw train::CarNotFoundError If the car was not in the train at the
+     * last tick.
+     */
+    types::temperature getTemperature(const train::Train& train, const types::id carId) const;
+
+    /**
+     * Advance the temperatures and the damages of the loads.
+     * @param outside Outside temperature.
+     * @param duration Duration of the tick.
+     * @return Quantity of load lost by all the trains.
+     */
+    types::quantity tick(const types::temperature outside, const types::duration duration);
+};
+
+/**
+ * Error class used when a train is not tracked.
+ */
+struct UntrackedTrainError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Train is not tracked by the climate";
+    }
+};
+
+}
+
+#endif // ifndef CLIMATE_HPP
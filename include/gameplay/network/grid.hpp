@@ -0,0 +1,237 @@
+#ifndef GRID_HPP
+#define GRID_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/network/network.hpp"
+#include "types.hpp"
+
+namespace network {
+
+/**
+ * Spatial index of points on the map.
+ * The map is divided into square cells, only the cells containing points are
+ * stored. Points are identified by dense indexes chosen by the caller, usually
+ * the index of a train, and moved incrementally when their train moves.
+ *
+ * As long as cells hold a bounded number of points, radius queries cost a
+ * constant time and finding all pairs of close points costs a linear time.
+ * The best results are obtained with cells as large as the usual radius.
+ */
+class Grid {
+    /**
+     * Point in the grid.
+     */
+    struct Entry {
+        /**
+         * Location of the point.
+         */
+        Point point;
+
+        /**
+         * Key of the cell containing the point.
+         */
+        std::uint64_t cell;
+
+        /**
+         * Position of the point in its cell.
+         */
+        std::uint32_t slot;
+
+        /**
+         * Tell if the point is in the grid.
+         */
+        bool present;
+    };
+
+    /**
+     * Size of the side of a cell.
+     */
+    types::distance cellSize;
+
+    /**
+     * Points, by index.
+     */
+    std::vector<Entry> entries;
+
+    /**
+     * Indexes of the points of each non-empty cell.
+     */
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> cells;
+
+    /**
+     * Number of points in the grid.
+     */
+    std::size_t size;
+
+    /**
+     * Get the coordinates of the cell containing a point.
+     * @param point Point to locate.
+     * @return Horizontal and vertical coordinates of the cell.
+     */
+    std::pair<std::int32_t, std::int32_t> getCell(const Point point) const;
+
+    /**
+     * Get the key of a cell.
+     * @param x Horizontal coordinate of the cell.
+     * @param y Vertical coordinate of the cell.
+     * @return Key of the cell.
+     */
+    static std::uint64_t getKey(const std::int32_t x, const std::int32_t y);
+
+    /**
+     * Put a point in a cell.
+     * @param index Index of the point.
+     * @param cell Key of the cell.
+     */
+    void link(const std::uint32_t index, const std::uint64_t cell);
+
+    /**
+     * Take a point out of its cell.
+     * @param index Index of the point.
+     */
+    void unlink(const std::uint32_t index);
+
+    /**
+     * Get a point in the grid.
+     * @param index Index of the point.
+     * @return Point.
+     */
+    const Entry& getEntry(const std::uint32_t index) const;
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param cellSize Size of the side of a cell.
+     * @throw InvalidCellSizeError If the cells are empty.
+     */
+    explicit Grid(const types::distance cellSize);
+
+    /**
+     * Add a point.
+     * @param index Index of the point, not in the grid yet.
+     * @param point Location of the point.
+     */
+    void insert(const std::uint32_t index, const Point point);
+
+    /**
+     * Move a point.
+     * Points staying in the same cell are only updated.
+     * @param index Index of the point.
+     * @param point New location of the point.
+     */
+    void update(const std::uint32_t index, const Point point);
+
+    /**
+     * Move a point to the position of a train.
+     * @param index Index of the point.
+     * @param network Network the train is on.
+     * @param train Train to follow.
+     */
+    void update(const std::uint32_t index, const Network& network, const train::Train& train);
+
+    /**
+     * Remove a point.
+     * @param index Index of the point.
+     */
+    void remove(const std::uint32_t index);
+
+    /**
+     * Tell if a point is in the grid.
+     * @param index Index of the point.
+     * @return True if the point is in the grid.
+     */
+    bool contains(const std::uint32_t index) const;
+
+    /**
+     * Getter for size.
+     * @return Number of points in the grid.
+     */
+    std::size_t getSize() const;
+
+    /**
+     * Getter for point.
+     * @param index Index of the point.
+     * @return Location of the point.
+     */
+    Point getPoint(const std::uint32_t index) const;
+
+    /**
+     * Find the points close to a location.
+     * @param point Location to search around.
+     * @param radius Distance of the search.
+     * @param found Indexes of the points found, in no particular order. The
+     * vector is cleared first.
+     */
+    void findNear(const Point point, const types::distance radius,
+                  std::vector<std::uint32_t>& found) const;
+
+    /**
+     * Find the points close to another point.
+     * @param index Index of the point to search around, it is not part of the
+     * result.
+     * @param radius Distance of the search.
+     * @param found Indexes of the points found, in no particular order. The
+     * vector is cleared first.
+     */
+    void findNear(const std::uint32_t index, const types::distance radius,
+                  std::vector<std::uint32_t>& found) const;
+
+    /**
+     * Find all the pairs of close points.
+     * Each pair is given once.
+     * @param radius Highest distance between the points of a pair.
+     * @param pairs Pairs of indexes found, in no particular order. The vector
+     * is cleared first.
+     */
+    void findPairs(const types::distance radius,
+                   std::vector<std::pair<std::uint32_t, std::uint32_t>>& pairs) const;
+};
+
+/**
+ * Error class used when a point is not in the grid.
+ */
+struct PointNotFoundError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Point not found in grid";
+    }
+};
+
+/**
+ * Error class used when a point is added twice to the grid.
+ */
+struct PointExistsError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Point already in grid";
+    }
+};
+
+/**
+ * Error class used when a grid is created with empty cells.
+ */
+struct InvalidCellSizeError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Grid cells must have a positive size";
+    }
+};
+
+}
+
+#endif // ifndef GRID_HPP
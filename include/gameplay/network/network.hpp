@@ -0,0 +1,483 @@
+#ifndef NETWORK_HPP
+#define NETWORK_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/train/traction.hpp"
+#include "gameplay/train/train.hpp"
+#include "types.hpp"
+
+/**
+ * Rail network.
+ * Stations and junctions are nodes of a graph, rails are its edges. Each
+ * rail is stored as two arcs, one for each direction, in compressed sparse
+ * row form once the network is built.
+ */
+namespace network {
+
+/**
+ * Types of nodes.
+ */
+enum class NodeTypes {
+    /**
+     * Station where trains can stop and trade.
+     */
+    station,
+
+    /**
+     * Junction between rails.
+     */
+    junction,
+};
+
+/**
+ * Node of the network.
+ */
+struct Node {
+    /**
+     * Human-readable name of the node.
+     */
+    std::string name;
+
+    /**
+     * Type of the node.
+     */
+    NodeTypes type;
+
+    /**
+     * Horizontal coordinate.
+     */
+    types::coordinate x;
+
+    /**
+     * Vertical coordinate.
+     */
+    types::coordinate y;
+};
+
+/**
+ * Point on the map.
+ */
+struct Point {
+    /**
+     * Horizontal coordinate.
+     */
+    types::coordinate x;
+
+    /**
+     * Vertical coordinate.
+     */
+    types::coordinate y;
+};
+
+/**
+ * Route on the network.
+ */
+struct Route {
+    /**
+     * Arcs to follow, in order.
+     */
+    std::vector<std::uint32_t> arcs;
+
+    /**
+     * Cost of the route, either a distance or a duration.
+     */
+    float cost;
+};
+
+/**
+ * Default number of landmarks used to speed up queries.
+ */
+const std::size_t defaultLandmarkCount = 8;
+
+/**
+ * Rail network.
+ * Nodes and rails are added first, then the network is built. A built network
+ * is immutable and can be queried from several threads, each one using its
+ * own `Router`.
+ */
+class Network {
+    /**
+     * Rail waiting for the network to be built.
+     */
+    struct Rail {
+        /**
+         * Index of the first node.
+         */
+        std::uint32_t from;
+
+        /**
+         * Index of the second node.
+         */
+        std::uint32_t to;
+
+        /**
+         * Length of the rail.
+         */
+        types::distance length;
+
+        /**
+         * Highest speed allowed on the rail.
+         */
+        types::speed speedLimit;
+    };
+
+    /**
+     * Nodes.
+     */
+    std::vector<Node> nodes;
+
+    /**
+     * Rails added since the last build.
+     */
+    std::vector<Rail> rails;
+
+    /**
+     * Index of the first arc of each node, plus the total number of arcs.
+     */
+    std::vector<std::uint32_t> offsets;
+
+    /**
+     * Start node of each arc.
+     */
+    std::vector<std::uint32_t> sources;
+
+    /**
+     * End node of each arc.
+     */
+    std::vector<std::uint32_t> targets;
+
+    /**
+     * Length of each arc.
+     */
+    std::vector<types::distance> lengths;
+
+    /**
+     * Speed limit of each arc.
+     */
+    std::vector<types::speed> speedLimits;
+
+    /**
+     * Highest speed limit of the network.
+     */
+    types::speed maxSpeedLimit;
+
+    /**
+     * Number of landmarks.
+     */
+    std::size_t landmarkCount;
+
+    /**
+     * Distances from each landmark to each node, landmark by landmark.
+     */
+    std::vector<types::distance> landmarkDistances;
+
+    /**
+     * Tell if the network is built.
+     */
+    bool built;
+
+    /**
+     * Compute the distances from a node to all the others.
+     * @param from Index of the start node.
+     * @param distances Distances to fill, infinite for unreachable nodes.
+     */
+    void computeDistances(const std::uint32_t from, types::distance* distances) const;
+
+    /**
+     * Check the network is built.
+     */
+    void checkBuilt() const;
+
+  public:
+
+    /**
+     * Default constructor.
+     */
+    Network();
+
+    /**
+     * Add a node.
+     * The network must be built again afterwards.
+     * @param name Human-readable name of the node.
+     * @param type Type of the node.
+     * @param x Horizontal coordinate.
+     * @param y Vertical coordinate.
+     * @return Index of the node.
+     */
+    std::uint32_t addNode(const std::string name, const NodeTypes type,
+                          const types::coordinate x, const types::coordinate y);
+
+    /**
+     * Add a rail between two nodes, usable in both directions.
+     * The network must be built again afterwards.
+     * @param from Index of the first node.
+     * @param to Index of the second node.
+     * @param length Length of the rail.
+     * @param speedLimit Highest speed allowed on the rail.
+     */
+    void addRail(const std::uint32_t from, const std::uint32_t to,
+                 const types::distance length,
+                 const types::speed speedLimit = traction::speedLimit);
+
+    /**
+     * Build the network.
+     * Arcs are packed by start node and the distances from a few landmarks
+     * are precomputed, the landmarks being chosen as far as possible from
+     * each other.
+     * @param landmarkCount Number of landmarks.
+     */
+    void build(const std::size_t landmarkCount = defaultLandmarkCount);
+
+    /**
+     * Tell if the network is built.
+     * @return True if the network can be queried.
+     */
+    bool isBuilt() const;
+
+    /**
+     * Getter for nodes count.
+     * @return Number of nodes.
+     */
+    std::size_t getNodeCount() const;
+
+    /**
+     * Getter for arcs count.
+     * @return Number of arcs, twice the number of rails.
+     */
+    std::size_t getArcCount() const;
+
+    /**
+     * Getter for node.
+     * @param node Index of the node.
+     * @return Node.
+     */
+    const Node& getNode(const std::uint32_t node) const;
+
+    /**
+     * Getter for arcs leaving a node.
+     * @param node Index of the node.
+     * @return Indexes of the first arc and past the last arc.
+     */
+    std::pair<std::uint32_t, std::uint32_t> getArcs(const std::uint32_t node) const;
+
+    /**
+     * Getter for start of arc.
+     * @param arc Index of the arc.
+     * @return Index of the start node.
+     */
+    std::uint32_t getSource(const std::uint32_t arc) const;
+
+    /**
+     * Getter for end of arc.
+     * @param arc Index of the arc.
+     * @return Index of the end node.
+     */
+    std::uint32_t getTarget(const std::uint32_t arc) const;
+
+    /**
+     * Getter for length of arc.
+     * @param arc Index of the arc.
+     * @return Length of the arc.
+     */
+    types::distance getLength(const std::uint32_t arc) const;
+
+    /**
+     * Getter for speed limit of arc.
+     * @param arc Index of the arc.
+     * @return Highest speed allowed on the arc.
+     */
+    types::speed getSpeedLimit(const std::uint32_t arc) const;
+
+    /**
+     * Getter for highest speed limit.
+     * @return Highest speed allowed on the network.
+     */
+    types::speed getMaxSpeedLimit() const;
+
+    /**
+     * Get a lower bound of the distance between two nodes.
+     * @param from Index of the start node.
+     * @param to Index of the end node.
+     * @return Distance no longer than the shortest path.
+     */
+    types::distance getLowerBound(const std::uint32_t from, const std::uint32_t to) const;
+
+    /**
+     * Put a train on an arc.
+     * @param train Train to place.
+     * @param arc Index of the arc.
+     * @param offset Distance from the start of the arc.
+     */
+    void place(train::Train& train, const std::uint32_t arc,
+               const types::distance offset = 0) const;
+
+    /**
+     * Get the point of a position.
+     * @param position Position on the network.
+     * @return Point on the map.
+     */
+    Point getPoint(const train::Position& position) const;
+
+    /**
+     * Move a train along its route.
+     * The train stops at the end of the route.
+     * @param train Train to move. It must be on the first arc of the route, or
+     * be following it already.
+     * @param route Route to follow.
+     * @param distance Distance to travel.
+     * @return True if the train reached the end of the route.
+     */
+    bool advance(train::Train& train, const Route& route, types::distance distance) const;
+};
+
+/**
+ * Path finder on a network.
+ * It keeps its working memory between queries, so that queries do not
+ * allocate. A router must only be used by one thread at a time.
+ */
+class Router {
+    /**
+     * Network to search.
+     */
+    const Network& network;
+
+    /**
+     * Best known cost to reach each node.
+     */
+    std::vector<float> costs;
+
+    /**
+     * Arc used to reach each node.
+     */
+    std::vector<std::uint32_t> parents;
+
+    /**
+     * Query in which each node has been reached.
+     * Avoids clearing the other arrays between queries.
+     */
+    std::vector<std::uint32_t> stamps;
+
+    /**
+     * Query in which each node has been settled.
+     */
+    std::vector<std::uint32_t> settled;
+
+    /**
+     * Current query.
+     */
+    std::uint32_t stamp;
+
+    /**
+     * Nodes to visit, as pairs of estimated cost and node index.
+     */
+    std::vector<std::pair<float, std::uint32_t>> heap;
+
+    /**
+     * Find the path of lowest cost.
+     * @param from Index of the start node.
+     * @param to Index of the end node.
+     * @param speed Speed of the train, or 0 to minimize the distance.
+     * @param route Route to fill.
+     */
+    void search(const std::uint32_t from, const std::uint32_t to, const types::speed speed,
+                Route& route);
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param network Built network to search.
+     */
+    explicit Router(const Network& network);
+
+    /**
+     * Find the shortest path between two nodes.
+     * @param from Index of the start node.
+     * @param to Index of the end node.
+     * @param route Route to fill, its cost is the distance.
+     */
+    void findShortestPath(const std::uint32_t from, const std::uint32_t to, Route& route);
+
+    /**
+     * Find the fastest path between two nodes for a given speed.
+     * The speed on each arc is limited by the speed limit of the arc.
+     * @param from Index of the start node.
+     * @param to Index of the end node.
+     * @param speed Highest speed of the train.
+     * @param route Route to fill, its cost is the duration.
+     */
+    void findFastestPath(const std::uint32_t from, const std::uint32_t to,
+                         const types::speed speed, Route& route);
+
+    /**
+     * Find the fastest path between two nodes for a train.
+     * The speed of the train depends on its weight and power.
+     * @param from Index of the start node.
+     * @param to Index of the end node.
+     * @param train Train to route.
+     * @param route Route to fill, its cost is the duration.
+     */
+    void findFastestPath(const std::uint32_t from, const std::uint32_t to,
+                         const train::Train& train, Route& route);
+};
+
+/**
+ * Error class used when querying a network that is not built.
+ */
+struct NotBuiltError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Network must be built first";
+    }
+};
+
+/**
+ * Error class used when a node or an arc does not exist.
+ */
+struct InvalidIndexError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "No node or arc at this index";
+    }
+};
+
+/**
+ * Error class used when no route exists between two nodes.
+ */
+struct NoRouteError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "No route between these nodes";
+    }
+};
+
+/**
+ * Error class used when a train does not follow a route.
+ */
+struct NotOnRouteError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Train is not on this route";
+    }
+};
+
+}
+
+#endif // ifndef NETWORK_HPP
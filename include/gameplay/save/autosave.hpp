@@ -0,0 +1,345 @@
+#ifndef AUTOSAVE_HPP
+#define AUTOSAVE_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/train/train.hpp"
+#include "types.hpp"
+
+/**
+ * Saves of the world.
+ * The state of the trains is copied at a tick boundary into a flat buffer,
+ * which is cheap and does not allocate once the buffer is large enough. The
+ * buffer is then written to disk by a background thread, so that saving a
+ * big world does not stall the simulation.
+ */
+namespace save {
+
+/**
+ * Saved state of a train.
+ * Followed in the save by the records of its cars, in the order of the
+ * train.
+ */
+struct TrainRecord {
+    /**
+     * Number of cars.
+     */
+    std::uint32_t carCount;
+
+    /**
+     * Index of the rail arc the train is on.
+     */
+    std::uint32_t arc;
+
+    /**
+     * Index of the arc in the route followed by the train.
+     */
+    std::uint32_t leg;
+
+    /**
+     * Distance from the start of the arc.
+     */
+    types::distance offset;
+
+    /**
+     * Current speed.
+     */
+    types::speed speed;
+
+    /**
+     * Coal in the tender.
+     */
+    types::weight coal;
+
+    /**
+     * Fraction of the power used.
+     */
+    float throttle;
+};
+
+/**
+ * Saved state of a car.
+ */
+struct CarRecord {
+    /**
+     * Unique ID of the car.
+     */
+    types::id carId;
+
+    /**
+     * ID of the model of the car.
+     */
+    types::id model;
+
+    /**
+     * Base weight of the car.
+     */
+    types::weight weight;
+
+    /**
+     * Power of the car, for locomotives.
+     */
+    types::power power;
+
+    /**
+     * Quantity of payload, for load cars.
+     */
+    types::quantity quantity;
+
+    /**
+     * ID of the merch loaded, or 0 if the car is empty.
+     */
+    types::id merch;
+
+    /**
+     * Average cost of a unit of the load.
+     */
+    types::money cost;
+
+    /**
+     * Health points.
+     */
+    types::health health;
+
+    /**
+     * Reserved, always 0, so that the compiler adds no padding.
+     */
+    char reserved[6];
+};
+
+static_assert(sizeof(TrainRecord) == 28, "Train records must not be padded");
+static_assert(sizeof(CarRecord) == 40, "Car records must not be padded");
+
+/**
+ * Content of a save.
+ */
+struct Save {
+    /**
+     * Number of the snapshot, counting from 1.
+     */
+    std::uint64_t sequence;
+
+    /**
+     * Trains.
+     */
+    std::vector<TrainRecord> trains;
+
+    /**
+     * Cars of all the trains, train after train.
+     */
+    std::vector<CarRecord> cars;
+};
+
+/**
+ * Read a save file.
+ * @param path Path of the save file.
+ * @return Content of the save.
+ * @throw SaveFileError If the file cannot be read or is corrupted.
+ */
+Save read(const std::string& path);
+
+/**
+ * Background saving of the world.
+ * Snapshots are taken from the game thread, at tick boundaries, in one of two
+ * buffers, while the other one may still be written by the background
+ * thread. A snapshot waiting to be written is replaced by a newer one, so
+ * that saving never falls behind the game. Files are written next to their
+ * path first, synchronized to disk, then renamed, so that a crash never
+ * leaves a save half written.
+ */
+class Autosave {
+    /**
+     * State of a buffer.
+     */
+    enum class State {
+        /**
+         * Buffer free.
+         */
+        free,
+
+        /**
+         * Snapshot being taken in the buffer.
+         */
+        filling,
+
+        /**
+         * Snapshot waiting to be written.
+         */
+        pending,
+
+        /**
+         * Snapshot being written.
+         */
+        writing
+    };
+
+    /**
+     * Buffer of a snapshot.
+     */
+    struct Buffer {
+        /**
+         * Snapshot, as a header followed by the records of the trains and of
+         * the cars.
+         */
+        std::vector<char> data;
+
+        /**
+         * State of the buffer.
+         */
+        State state;
+    };
+
+    /**
+     * Path of the save file.
+     */
+    std::string path;
+
+    /**
+     * Tell if saves are compressed.
+     */
+    bool isCompressed;
+
+    /**
+     * Lock of the states of the buffers and of the counters.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * Condition notified when a snapshot is pending or the writer stops.
+     */
+    std::condition_variable snapshotPending;
+
+    /**
+     * Condition notified when a snapshot is written.
+     */
+    std::condition_variable snapshotWritten;
+
+    /**
+     * Buffers.
+     */
+    Buffer buffers[2];
+
+    /**
+     * Compressed snapshot, only used by the writer.
+     */
+    std::vector<char> packed;
+
+    /**
+     * Number of snapshots taken.
+     */
+    std::uint64_t capturedCount;
+
+    /**
+     * Number of snapshots written.
+     */
+    std::uint64_t writtenCount;
+
+    /**
+     * Number of snapshots that could not be written.
+     */
+    std::uint64_t failedCount;
+
+    /**
+     * Tell if the writer must stop.
+     */
+    bool isStopping;
+
+    /**
+     * Writer thread.
+     */
+    std::thread writer;
+
+    /**
+     * Take a snapshot of trains.
+     * @param data Buffer of the snapshot.
+     * @param sequence Number of the snapshot.
+     * @param trains Trains to save.
+     */
+    static void fill(std::vector<char>& data, const std::uint64_t sequence,
+                     const std::vector<const train::Train*>& trains);
+
+    /**
+     * Write pending snapshots until the writer stops.
+     */
+    void work();
+
+    /**
+     * Write a snapshot to the save file.
+     * @param data Snapshot.
+     * @return True if the save file was written.
+     */
+    bool write(const std::vector<char>& data);
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param path Path of the save file.
+     * @param isCompressed Compress the runs of zeros of the saves.
+     */
+    explicit Autosave(const std::string& path, const bool isCompressed = false);
+
+    /**
+     * Deleted copy constructor.
+     */
+    Autosave(const Autosave&) = delete;
+
+    /**
+     * Deleted copy assignment operator.
+     */
+    Autosave& operator=(const Autosave&) = delete;
+
+    /**
+     * Destructor.
+     * The pending snapshot, if any, is written first.
+     */
+    ~Autosave();
+
+    /**
+     * Take a snapshot of trains and queue it for writing.
+     * To call at tick boundaries, from the game thread only.
+     * @param trains Trains to save.
+     * @return Number of the snapshot.
+     */
+    std::uint64_t capture(const std::vector<const train::Train*>& trains);
+
+    /**
+     * Wait for the snapshots taken to be written or dropped.
+     */
+    void wait();
+
+    /**
+     * Getter for written count.
+     * @return Number of snapshots written.
+     */
+    std::uint64_t getWrittenCount() const;
+
+    /**
+     * Getter for failed count.
+     * @return Number of snapshots that could not be written.
+     */
+    std::uint64_t getFailedCount() const;
+};
+
+/**
+ * Error class used when a save file cannot be read.
+ */
+struct SaveFileError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Cannot read save file";
+    }
+};
+
+}
+
+#endif // ifndef AUTOSAVE_HPP
@@ -0,0 +1,253 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/train/train.hpp"
+#include "types.hpp"
+
+/**
+ * Headless scenarios.
+ * A scenario is a text file describing trains and a script of operations on
+ * them, run without display to measure the performance of the whole game.
+ *
+ * Each line holds a command followed by its arguments, separated by spaces;
+ * empty lines and lines starting with `#` are ignored. Trains are set up with:
+ *
+ * - `train NAME [BLOCK_SIZE]`: create a train, allocated in an arena if a
+ *   block size is given;
+ * - `locomotive WEIGHT POWER`: add a locomotive to the last train;
+ * - `car MODEL [COUNT]`: add load cars of a model to the last train;
+ * - `cargo MERCH QUANTITY PRICE`: load merchandise in the last train;
+ * - `coal WEIGHT`: add coal to the last train;
+ * - `throttle VALUE`: set the throttle of the last train.
+ *
+ * The script is made of:
+ *
+ * - `buy TRAIN MERCH QUANTITY PRICE`: buy merchandise;
+ * - `sell TRAIN MERCH QUANTITY`: sell merchandise;
+ * - `damage TRAIN POSITION ATTACK`: damage a car;
+ * - `repair TRAIN POSITION`: repair a car;
+ * - `move TRAIN POSITION NEW_POSITION`: move a car in its train;
+ * - `tick HOURS`: move all the trains;
+ * - `repeat COUNT` and `end`: repeat the commands in between.
+ *
+ * Car models and merchs are given by ID or by name, names with spaces are
+ * quoted, as `"oil tank"`.
+ */
+namespace scenario {
+
+/**
+ * Types of operations of a script.
+ */
+enum class Operations {
+    /**
+     * Buy merchandise.
+     */
+    buy,
+
+    /**
+     * Sell merchandise.
+     */
+    sell,
+
+    /**
+     * Damage a car.
+     */
+    damage,
+
+    /**
+     * Repair a car.
+     */
+    repair,
+
+    /**
+     * Move a car in its train.
+     */
+    move,
+
+    /**
+     * Move all the trains.
+     */
+    tick,
+
+    /**
+     * Start of a repeated block.
+     */
+    repeat,
+
+    /**
+     * End of a repeated block.
+     */
+    end,
+};
+
+/**
+ * Operation of a script.
+ */
+struct Operation {
+    /**
+     * Type of the operation.
+     */
+    Operations type;
+
+    /**
+     * Index of the train.
+     */
+    std::uint32_t train;
+
+    /**
+     * First argument: merch ID, car position or repeat count.
+     * For the end of a block, index of its start.
+     */
+    std::uint32_t first;
+
+    /**
+     * Second argument: quantity, attack or new car position.
+     * For the start of a block, index of its end.
+     */
+    std::uint32_t second;
+
+    /**
+     * Price of a purchase.
+     */
+    types::price price;
+
+    /**
+     * Duration of a tick.
+     */
+    types::duration duration;
+};
+
+/**
+ * Statistics of a run.
+ */
+struct Statistics {
+    /**
+     * Number of operations on trains, ticks excluded.
+     */
+    std::uint64_t operations;
+
+    /**
+     * Number of ticks.
+     */
+    std::uint64_t ticks;
+
+    /**
+     * Number of operations that failed, as buying without space.
+     */
+    std::uint64_t failures;
+
+    /**
+     * Duration of the run, in seconds.
+     */
+    double seconds;
+};
+
+/**
+ * Scenario.
+ */
+class Scenario {
+    /**
+     * Names of the trains.
+     */
+    std::vector<std::string> names;
+
+    /**
+     * Trains.
+     */
+    std::vector<std::unique_ptr<train::Train>> trains;
+
+    /**
+     * Script.
+     */
+    std::vector<Operation> operations;
+
+    /**
+     * Find a train by name.
+     * @param name Name of the train.
+     * @return Index of the train, or the number of trains if not found.
+     */
+    std::uint32_t findTrain(const std::string& name) const;
+
+    /**
+     * Apply an operation.
+     * @param operation Operation to apply.
+     */
+    void apply(const Operation& operation);
+
+  public:
+
+    /**
+     * Default constructor.
+     */
+    Scenario();
+
+    /**
+     * Load a scenario.
+     * Trains are set up at once, the script is kept for running.
+     * @param stream Stream to read the scenario from.
+     */
+    void load(std::istream& stream);
+
+    /**
+     * Getter for trains count.
+     * @return Number of trains.
+     */
+    std::size_t getTrainCount() const;
+
+    /**
+     * Getter for train.
+     * @param index Index of the train.
+     * @return Train.
+     */
+    train::Train& getTrain(const std::size_t index) const;
+
+    /**
+     * Getter for operations count.
+     * @return Number of operations of the script, as written.
+     */
+    std::size_t getOperationCount() const;
+
+    /**
+     * Run the script.
+     * @return Statistics of the run.
+     */
+    Statistics run();
+};
+
+/**
+ * Error class used when a scenario cannot be read.
+ */
+class ParseError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     */
+    std::string message;
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param line Number of the line, starting at 1.
+     * @param reason Reason of the error.
+     */
+    ParseError(const std::size_t line, const std::string& reason);
+
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return message.c_str();
+    }
+};
+
+}
+
+#endif // ifndef SCENARIO_HPP
@@ -0,0 +1,193 @@
+#ifndef DEPOT_HPP
+#define DEPOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/train/cars.hpp"
+#include "types.hpp"
+
+namespace station {
+
+/**
+ * Repair depot of a station.
+ * Damaged cars wait in a queue until one of the repair crews of the depot is
+ * free. Cars of trains leaving first are repaired first, then the cars with
+ * the most value at stake, that is their value times their missing health.
+ * Crews repair a fixed number of health points per hour, a bit at each tick.
+ *
+ * The queue is a heap: submitting a car or giving it to a crew costs a
+ * logarithmic time, and ticks never sort the queue again, so that depots can
+ * hold tens of thousands of cars. Cars must stay alive while in the depot, or
+ * be withdrawn first.
+ */
+class Depot {
+    /**
+     * Car waiting for repair.
+     */
+    struct Entry {
+        /**
+         * Departure time of the train of the car.
+         */
+        types::duration departure;
+
+        /**
+         * Value at stake, the value of the car times its missing health.
+         */
+        float stake;
+
+        /**
+         * Order of submission.
+         */
+        std::uint64_t sequence;
+
+        /**
+         * Unique ID of the car.
+         */
+        types::id carId;
+
+        /**
+         * Car, only used if the entry is still valid.
+         */
+        cars::Car* car;
+    };
+
+    /**
+     * Comparison of the entries of the queue.
+     */
+    struct IsLater {
+        /**
+         * Tell if an entry comes after another one.
+         * @param first First entry.
+         * @param second Second entry.
+         * @return True if the first entry is repaired after the second one.
+         */
+        bool operator()(const Entry& first, const Entry& second) const;
+    };
+
+    /**
+     * Repair crew.
+     */
+    struct Crew {
+        /**
+         * Car being repaired, or null pointer if the crew is free.
+         */
+        cars::Car* car;
+
+        /**
+         * Health points repaired on the car but not restored yet.
+         */
+        float progress;
+    };
+
+    /**
+     * Cars waiting for repair.
+     * Entries of withdrawn or submitted again cars are skipped when they come
+     * out.
+     */
+    std::priority_queue<Entry, std::vector<Entry>, IsLater> queue;
+
+    /**
+     * Order of submission of the cars in the depot, by unique ID.
+     */
+    std::unordered_map<types::id, std::uint64_t> sequences;
+
+    /**
+     * Crews.
+     */
+    std::vector<Crew> crews;
+
+    /**
+     * Health points a crew repairs per hour.
+     */
+    float rate;
+
+    /**
+     * Number of cars submitted.
+     */
+    std::uint64_t submittedCount;
+
+    /**
+     * Give the next car of the queue to a crew.
+     * Cars destroyed while waiting leave the depot.
+     * @param crew Free crew.
+     * @return True if the crew got a car.
+     */
+    bool assign(Crew& crew);
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param crewCount Number of repair crews.
+     * @param rate Health points a crew repairs per hour.
+     * @throw InvalidCrewError If there is no crew or they do not repair.
+     */
+    Depot(const std::size_t crewCount, const float rate);
+
+    /**
+     * Put a car in the depot.
+     * A car already waiting is queued again with its new priority; a car
+     * already being repaired is left to its crew.
+     * @param car Car to repair.
+     * @param value Value of the car.
+     * @param departure Departure time of the train of the car, in hours of
+     * game time.
+     * @throw cars::DestroyedCarError If the car is destroyed.
+     */
+    void submit(cars::Car& car, const float value, const types::duration departure);
+
+    /**
+     * Take a car out of the depot, repaired or not.
+     * @param carId Unique ID of the car.
+     * @return True if the car was in the depot.
+     */
+    bool withdraw(const types::id carId);
+
+    /**
+     * Tell if a car is in the depot.
+     * @param carId Unique ID of the car.
+     * @return True if the car is waiting or being repaired.
+     */
+    bool contains(const types::id carId) const;
+
+    /**
+     * Getter for size.
+     * @return Number of cars waiting or being repaired.
+     */
+    std::size_t getSize() const;
+
+    /**
+     * Getter for busy crews.
+     * @return Number of crews repairing a car.
+     */
+    std::size_t getBusyCrewCount() const;
+
+    /**
+     * Repair cars for a while.
+     * @param duration Duration of the tick, in hours of game time.
+     * @return Unique IDs of the cars fully repaired, which leave the depot.
+     */
+    std::vector<types::id> tick(const types::duration duration);
+};
+
+/**
+ * Error class used when a depot has no crew able to repair.
+ */
+struct InvalidCrewError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Depot must have crews repairing health points";
+    }
+};
+
+}
+
+#endif // ifndef DEPOT_HPP
@@ -0,0 +1,232 @@
+#ifndef ORDERS_HPP
+#define ORDERS_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/train/merchandises.hpp"
+#include "types.hpp"
+
+namespace station {
+
+/**
+ * Side of an order.
+ */
+enum class Side {
+    /**
+     * Order to buy merchandise.
+     */
+    buy,
+
+    /**
+     * Order to sell merchandise.
+     */
+    sell
+};
+
+/**
+ * Order to trade merchandise at a station.
+ */
+struct Order {
+    /**
+     * ID of the trader placing the order, usually a train.
+     */
+    types::id trader;
+
+    /**
+     * ID of the merch to trade.
+     */
+    types::id merch;
+
+    /**
+     * Side of the order.
+     */
+    Side side;
+
+    /**
+     * Highest price to buy at, or lowest price to sell at.
+     */
+    types::price price;
+
+    /**
+     * Quantity to trade.
+     */
+    types::quantity quantity;
+};
+
+/**
+ * Trade resulting from matching a buy order and a sell order.
+ */
+struct Trade {
+    /**
+     * ID of the merch traded.
+     */
+    types::id merch;
+
+    /**
+     * ID of the trader buying.
+     */
+    types::id buyer;
+
+    /**
+     * ID of the trader selling.
+     */
+    types::id seller;
+
+    /**
+     * Price of the trade, halfway between the prices of the orders.
+     */
+    types::price price;
+
+    /**
+     * Quantity traded.
+     */
+    types::quantity quantity;
+};
+
+/**
+ * Default number of shards of an order book.
+ */
+const std::size_t defaultShardCount = 16;
+
+/**
+ * Order book of a station.
+ * Orders are placed from any thread during a tick. They are spread over
+ * shards by trader, each shard having its own lock, so that trains placing
+ * orders at once rarely wait for each other. At the end of the tick, all the
+ * orders are matched in one batch and the book is emptied; orders not matched
+ * expire.
+ *
+ * Matching does not depend on the order in which orders were placed, nor on
+ * the number of threads: orders of each merch are sorted by price, then by
+ * trader, and each merch is matched independently, possibly on its own
+ * thread. Within a merch, the highest buy order meets the lowest sell order
+ * as long as their prices cross.
+ */
+class OrderBook {
+    /**
+     * Orders placed in the book, with their lock.
+     */
+    struct Shard;
+
+    /**
+     * Shards.
+     */
+    std::unique_ptr<Shard[]> shards;
+
+    /**
+     * Number of shards.
+     */
+    std::size_t shardCount;
+
+    /**
+     * Match the orders of one merch.
+     * @param orders Orders of the merch, sorted in place.
+     * @param trades Trades to add to.
+     */
+    static void matchMerch(std::vector<Order>& orders, std::vector<Trade>& trades);
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param shardCount Number of shards, more shards letting more threads
+     * place orders at once.
+     * @throw InvalidShardCountError If there is no shard.
+     */
+    explicit OrderBook(const std::size_t shardCount = defaultShardCount);
+
+    /**
+     * Deleted copy constructor.
+     */
+    OrderBook(const OrderBook&) = delete;
+
+    /**
+     * Deleted copy assignment operator.
+     */
+    OrderBook& operator=(const OrderBook&) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~OrderBook();
+
+    /**
+     * Place an order.
+     * Thread-safe.
+     * @param order Order to place.
+     * @throw InvalidOrderError If the order has no quantity.
+     */
+    void submit(const Order& order);
+
+    /**
+     * Place an order to buy merchandise.
+     * Thread-safe.
+     * @param trader ID of the trader.
+     * @param merch Merch to buy.
+     * @param price Highest price to buy at.
+     * @param quantity Quantity to buy.
+     * @throw InvalidOrderError If the order has no quantity.
+     */
+    void buy(const types::id trader, const merchandises::Merch& merch,
+             const types::price price, const types::quantity quantity);
+
+    /**
+     * Place an order to sell merchandise.
+     * Thread-safe.
+     * @param trader ID of the trader.
+     * @param merch Merch to sell.
+     * @param price Lowest price to sell at.
+     * @param quantity Quantity to sell.
+     * @throw InvalidOrderError If the order has no quantity.
+     */
+    void sell(const types::id trader, const merchandises::Merch& merch,
+              const types::price price, const types::quantity quantity);
+
+    /**
+     * Getter for size.
+     * Thread-safe.
+     * @return Number of orders placed since the last match.
+     */
+    std::size_t getSize() const;
+
+    /**
+     * Match the orders placed since the last match, and empty the book.
+     * It must not be called while orders are placed.
+     * @param threadCount Number of threads, or 0 to use all the cores.
+     * @return Trades, sorted by merch ID.
+     */
+    std::vector<Trade> match(const std::size_t threadCount = 0);
+};
+
+/**
+ * Error class used when an order cannot be placed.
+ */
+struct InvalidOrderError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Order must have a quantity";
+    }
+};
+
+/**
+ * Error class used when an order book is created without shards.
+ */
+struct InvalidShardCountError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Order book must have shards";
+    }
+};
+
+}
+
+#endif // ifndef ORDERS_HPP
@@ -0,0 +1,175 @@
+#ifndef WAREHOUSE_HPP
+#define WAREHOUSE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "gameplay/train/merchandises.hpp"
+#include "gameplay/train/train.hpp"
+#include "types.hpp"
+
+/**
+ * Stations of the rail network.
+ */
+namespace station {
+
+/**
+ * Stock of a merch in a warehouse.
+ */
+struct Stock {
+    /**
+     * Quantity stored.
+     */
+    types::quantity quantity;
+
+    /**
+     * Average cost of a unit of the quantity stored.
+     */
+    types::money cost;
+};
+
+/**
+ * Warehouse of a station.
+ * The warehouse holds one stock per merch, indexed by the dense index of the
+ * merch in the catalog of merchs rather than by its ID. Stocks are created up
+ * to the last merch stored only, so that a world with thousands of stations
+ * stays small, and transfers add whole arrays of stocks at once.
+ */
+class Warehouse {
+    /**
+     * Stocks, by index of merch in the catalog.
+     */
+    std::vector<Stock> stocks;
+
+    /**
+     * Get the stock of a merch, creating it if needed.
+     * @param merch Merch of the stock.
+     * @return Stock.
+     * @throw catalog::EntryNotFoundError If the merch is not in the catalog.
+     */
+    Stock& getStock(const merchandises::Merch& merch);
+
+    /**
+     * Find the stock of a merch.
+     * @param merch Merch of the stock.
+     * @return Stock, or null pointer if the merch was never stored.
+     * @throw catalog::EntryNotFoundError If the merch is not in the catalog.
+     */
+    const Stock* findStock(const merchandises::Merch& merch) const;
+
+    /**
+     * Add stocks, index by index.
+     * @param others Stocks to add, by index of merch in the catalog.
+     */
+    void add(const std::vector<Stock>& others);
+
+  public:
+
+    /**
+     * Default constructor.
+     * The warehouse is empty.
+     */
+    Warehouse();
+
+    /**
+     * Store merchandise.
+     * The price of the stock is averaged with the price of the merchandise.
+     * @param merch Merch to store.
+     * @param quantity Quantity to store.
+     * @param price Price of the merchandise.
+     * @throw catalog::EntryNotFoundError If the merch is not in the catalog.
+     */
+    void store(const merchandises::Merch& merch, const types::quantity quantity,
+               const types::price price);
+
+    /**
+     * Store a load of merchandise.
+     * @param merchLoad Load to store.
+     * @throw catalog::EntryNotFoundError If the merch is not in the catalog.
+     */
+    void store(const merchandises::MerchLoad& merchLoad);
+
+    /**
+     * Take merchandise.
+     * @param merch Merch to take.
+     * @param quantity Quantity to take.
+     * @return Load taken, at the average cost of the stock.
+     * @throw NotEnoughStockError If the warehouse does not hold enough
+     * merchandise.
+     */
+    merchandises::MerchLoad take(const merchandises::Merch& merch,
+                                 const types::quantity quantity);
+
+    /**
+     * Getter for quantity.
+     * @param merch Merch of the stock.
+     * @return Quantity stored.
+     */
+    types::quantity getQuantity(const merchandises::Merch& merch) const;
+
+    /**
+     * Getter for price.
+     * @param merch Merch of the stock.
+     * @return Average price of the quantity stored, rounded down.
+     */
+    types::price getPrice(const merchandises::Merch& merch) const;
+
+    /**
+     * Getter for cost.
+     * @param merch Merch of the stock.
+     * @return Average cost of a unit of the quantity stored.
+     */
+    types::money getCost(const merchandises::Merch& merch) const;
+
+    /**
+     * Unload all the merchandise of a train.
+     * The cargo of the cars is gathered in one pass over the train, then added
+     * to the stocks at once. The transfer is all or nothing.
+     * @param train Train to unload.
+     * @return Quantity unloaded.
+     */
+    types::quantity unloadTrain(train::Train& train);
+
+    /**
+     * Load merchandise in a train.
+     * The transfer is all or nothing.
+     * @param train Train to load.
+     * @param merch Merch to load.
+     * @param quantity Quantity to load.
+     * @throw NotEnoughStockError If the warehouse does not hold enough
+     * merchandise.
+     * @throw train::CannotBuyError If the train has not enough space.
+     */
+    void loadTrain(train::Train& train, const merchandises::Merch& merch,
+                   const types::quantity quantity);
+
+    /**
+     * Move all the merchandise to another warehouse.
+     * @param other Warehouse receiving the merchandise.
+     */
+    void moveTo(Warehouse& other);
+
+    /**
+     * Getter for memory usage.
+     * @return Memory used by the warehouse, in bytes.
+     */
+    std::size_t getMemoryUsage() const;
+};
+
+/**
+ * Error class used when a warehouse does not hold enough merchandise.
+ */
+struct NotEnoughStockError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Not enough merchandise in warehouse";
+    }
+};
+
+}
+
+#endif // ifndef WAREHOUSE_HPP
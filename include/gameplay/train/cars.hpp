@@ -1,16 +1,165 @@
 #ifndef CARS_HPP
 #define CARS_HPP
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "exceptions.hpp"
 #include "gameplay/train/merchandises.hpp"
+#include "tools/arena.hpp"
 #include "types.hpp"
 
 namespace cars {
 
+class Car;
+
+/**
+ * Kinds of change of a car.
+ * Values are bit flags that can be combined.
+ */
+enum class Change : unsigned char {
+    /**
+     * No change.
+     */
+    none = 0,
+
+    /**
+     * Health points changed.
+     */
+    health = 1 << 0,
+
+    /**
+     * Load changed.
+     */
+    load = 1 << 1,
+
+    /**
+     * Car added to the train.
+     */
+    added = 1 << 2,
+
+    /**
+     * Car removed from the train.
+     */
+    removed = 1 << 3,
+
+    /**
+     * Car moved in the train.
+     */
+    position = 1 << 4,
+};
+
+/**
+ * Combine changes.
+ * @param change First change.
+ * @param other Second change.
+ * @return Both changes.
+ */
+inline Change operator |(const Change change, const Change other) {
+    return static_cast<Change>(static_cast<unsigned char>(change) |
+                               static_cast<unsigned char>(other));
+}
+
+/**
+ * Intersect changes.
+ * @param change First change.
+ * @param other Second change.
+ * @return Changes present in both.
+ */
+inline Change operator &(const Change change, const Change other) {
+    return static_cast<Change>(static_cast<unsigned char>(change) &
+                               static_cast<unsigned char>(other));
+}
+
+/**
+ * Interface for objects notified when a car changes.
+ * A car has at most one observer, usually the train it belongs to.
+ */
+class CarObserver {
+  public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~CarObserver() {}
+
+    /**
+     * Called after the health or the load of the car changed.
+     * @param car Car that changed.
+     * @param change Kind of change.
+     */
+    virtual void onCarChanged(Car& car, const Change change) = 0;
+};
+
+/**
+ * Hot state of a car.
+ * Fields read or written by passes over whole trains, packed together so
+ * that such passes do not bring the cold data of cars into cache.
+ */
+struct CarState {
+    /**
+     * Base weight of the car.
+     * It does not include weight of the payload.
+     */
+    types::weight weight;
+
+    /**
+     * Power of the car, for locomotives.
+     */
+    types::power power;
+
+    /**
+     * Quantity of payload, for load cars.
+     */
+    types::quantity quantity;
+
+    /**
+     * Health points.
+     * The car is destroyed if the value is lower than or equal to 0.
+     */
+    types::health health;
+
+    /**
+     * Value of the payload, for load cars.
+     */
+    types::money value;
+};
+
+/**
+ * Cold data of a car.
+ * Data seldom used, shared by the cars created from the same model.
+ */
+struct CarInfo {
+    /**
+     * ID of the car.
+     */
+    types::id id;
+
+    /**
+     * Human-readable name of the car.
+     */
+    std::string name;
+
+    /**
+     * Capacity of the car, for load cars.
+     */
+    types::quantity maxQuantity;
+
+    /**
+     * Type of merch accepted in the car, for load cars.
+     */
+    merchandises::MerchTypes merchType;
+
+    /**
+     * Insulation of the car.
+     * Time, in hours, the temperature inside the car takes to follow the
+     * outside temperature.
+     */
+    float insulation;
+};
+
 /**
  * Generic car object.
  * This class is abstract.
@@ -27,33 +176,57 @@ class Car {
     const types::id carId;
 
     /**
-     * Maximum health points.
+     * Observer notified of changes.
+     * It is not copied with the car.
      */
-    const static types::health maxHealth;
+    CarObserver* observer;
+
+    /**
+     * Key given by the observer to find the car back.
+     * It is not copied with the car.
+     */
+    std::uint32_t observerKey;
+
+    /**
+     * Changes not yet reported to the consumer of the observer.
+     * It is not copied with the car.
+     */
+    Change changes;
+
+    /**
+     * Hash of the state of the car, as last accounted by the observer.
+     * It is not copied with the car.
+     */
+    std::uint64_t observedHash;
 
   protected:
 
     /**
-     * ID of the car.
+     * Maximum health points.
      */
-    types::id id;
+    const static types::health maxHealth;
 
     /**
-     * Human-readable name of the car.
+     * Arena to allocate loads from.
+     * Null pointer to allocate them on the heap.
      */
-    std::string name;
+    arena::Arena* region;
 
     /**
-     * Health points.
-     * The car is destroyed if the value is lower than or equal to 0.
+     * Hot state.
      */
-    types::health health;
+    CarState state;
 
     /**
-     * Base weight of the car.
-     * It does not include weight of the payload.
+     * Cold data.
      */
-    types::weight weight;
+    std::shared_ptr<const CarInfo> info;
+
+    /**
+     * Notify the observer, if any, that the car changed.
+     * @param change Kind of change.
+     */
+    void notifyChanged(const Change change);
 
   public:
 
@@ -80,12 +253,27 @@ class Car {
      */
     Car(const types::id id, const std::string name, const types::weight weight);
 
+    /**
+     * Constructor sharing cold data.
+     * @param info Cold data of the car.
+     * @param health Health points of the car.
+     * @param weight Base weight of the car.
+     */
+    Car(const std::shared_ptr<const CarInfo>& info, const types::health health,
+        const types::weight weight);
+
     /**
      * Copy constructor.
+     * Cold data are shared with the copied car.
      * @param car Car to construct from.
      */
     Car(const Car& car);
 
+    /**
+     * Destructor.
+     */
+    virtual ~Car() {}
+
     /**
      * Getter for the ID of the car.
      */
@@ -115,6 +303,13 @@ class Car {
      */
     types::health getHealth() const;
 
+    /**
+     * Getter for insulation.
+     * @return Time, in hours, the temperature inside the car takes to follow
+     * the outside temperature.
+     */
+    float getInsulation() const;
+
     /**
      * Getter for weight.
      * @return Total weight of the car.
@@ -137,6 +332,110 @@ class Car {
      * Repair car and restore full helth points.
      */
     void repair();
+
+    /**
+     * Repair some health points of the car, up to full health points.
+     * @param points Health points to restore.
+     */
+    void repair(const types::health points);
+
+    /**
+     * Getter for observer.
+     * @return Observer of the car, or null pointer.
+     */
+    CarObserver* getObserver() const;
+
+    /**
+     * Setter for observer.
+     * @param observer Observer to notify of changes, or null pointer.
+     * @param key Key to find the car back, as the index of its slot.
+     */
+    void setObserver(CarObserver* observer, const std::uint32_t key = 0);
+
+    /**
+     * Getter for observer key.
+     * @return Key given by the observer.
+     */
+    std::uint32_t getObserverKey() const;
+
+    /**
+     * Getter for hot state.
+     * @return Hot state of the car.
+     */
+    const CarState& getState() const;
+
+    /**
+     * Getter for cold data.
+     * @return Cold data of the car, possibly shared with other cars.
+     */
+    const std::shared_ptr<const CarInfo>& getInfo() const;
+
+    /**
+     * Getter for arena.
+     * @return Arena the car allocates its loads from, or null pointer.
+     */
+    arena::Arena* getArena() const;
+
+    /**
+     * Setter for arena.
+     * The arena must outlive the car, which is the case if the car itself is
+     * allocated from it.
+     * @param arena Arena to allocate loads from, or null pointer for the
+     * heap.
+     */
+    void setArena(arena::Arena* arena);
+
+    /**
+     * Getter for memory usage.
+     * Cold data are owned by the models and shared by their cars, so they are
+     * never counted per car.
+     * @return Approximate memory used by the car and its load, in bytes.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
+    /**
+     * Getter for changes.
+     * @return Changes not yet reported.
+     */
+    Change getChanges() const;
+
+    /**
+     * Tell if the car has changes not yet reported.
+     * @return True if the car changed.
+     */
+    bool isDirty() const;
+
+    /**
+     * Mark the car as changed.
+     * @param change Kind of change.
+     */
+    void addChanges(const Change change);
+
+    /**
+     * Mark the car as reported.
+     */
+    void clearChanges();
+
+    /**
+     * Compute the hash of the state of the car.
+     * It only depends on the model, the health and the load of the car, not
+     * on its unique ID, so that it is the same between runs. It is computed
+     * in constant time.
+     * @return Hash of the car.
+     */
+    virtual std::uint64_t computeHash() const;
+
+    /**
+     * Getter for observed hash.
+     * @return Hash of the car as last accounted by the observer.
+     */
+    std::uint64_t getObservedHash() const;
+
+    /**
+     * Setter for observed hash.
+     * @param hash Hash of the car accounted by the observer.
+     */
+    void setObservedHash(const std::uint64_t hash);
 };
 
 /**
@@ -161,6 +460,52 @@ class SpecialCar : public Car {
     using Car::Car;
 };
 
+/**
+ * Locomotive object.
+ * Special car that pulls the train.
+ */
+class Locomotive : public SpecialCar {
+  public:
+
+    /**
+     * Default constructor.
+     */
+    Locomotive();
+
+    /**
+     * Usual constructor.
+     * @param id ID of the car.
+     * @param name Human-readable name of the car.
+     * @param health Health points of the car.
+     * @param weight Base weight of the car.
+     * @param power Power of the engine.
+     */
+    Locomotive(const types::id id, const std::string name, const types::health health,
+               const types::weight weight, const types::power power);
+
+    /**
+     * Usual constructor with maximum health.
+     * @param id ID of the car.
+     * @param name Human-readable name of the car.
+     * @param weight Base weight of the car.
+     * @param power Power of the engine.
+     */
+    Locomotive(const types::id id, const std::string name, const types::weight weight,
+               const types::power power);
+
+    /**
+     * Getter for power.
+     * @return Power of the engine, or 0 if the locomotive is destroyed.
+     */
+    types::power getPower() const;
+
+    /**
+     * Getter for weight.
+     * It simply returns the base weight.
+     */
+    types::weight getWeight() const;
+};
+
 /**
  * Normal car object.
  * Cars that can be purchased, used, and destroyed.
@@ -185,19 +530,14 @@ class LoadCar : public Car {
   protected:
 
     /**
-     * Maximum quantity of merchandise loads.
-     */
-    types::quantity maxQuantity;
-
-    /**
-     * Type of merch accepted.
+     * Merchandise.
      */
-    const merchandises::MerchTypes merchType;
+    std::shared_ptr<merchandises::MerchLoad> merchLoad;
 
     /**
-     * Merchandise.
+     * Copy the quantity and the value of the merch load to the hot state.
      */
-    std::shared_ptr<merchandises::MerchLoad> merchLoad;
+    void updateQuantity();
 
     /**
      * Setter for merch load.
@@ -209,6 +549,8 @@ class LoadCar : public Car {
 
     /**
      * Setter for merch load.
+     * The load is copied rather than shared, so that it is only changed
+     * through the car, which keeps its hot state in sync.
      * @param merchLoad Merch load to put in the car.
      */
     void setMerchLoad(const std::shared_ptr<merchandises::MerchLoad>& merchLoad);
@@ -322,12 +664,55 @@ class LoadCar : public Car {
             const types::quantity maxQuantity,
             const merchandises::MerchTypes merchType);
 
+    /**
+     * Constructor sharing cold data.
+     * @param info Cold data of the car, with its capacity and type of merch.
+     * @param health Health points of the car.
+     * @param weight Base weight of the car.
+     */
+    LoadCar(const std::shared_ptr<const CarInfo>& info, const types::health health,
+            const types::weight weight);
+
+    /**
+     * Constructor sharing cold data, with a load.
+     * @param info Cold data of the car, with its capacity and type of merch.
+     * @param health Health points of the car.
+     * @param weight Base weight of the car.
+     * @param merchLoad Load in the car.
+     */
+    LoadCar(const std::shared_ptr<const CarInfo>& info, const types::health health,
+            const types::weight weight, merchandises::MerchLoad& merchLoad);
+
+    /**
+     * Copy constructor.
+     * Cold data are shared with the copied car, the load is copied.
+     * @param car Car to construct from.
+     */
+    LoadCar(const LoadCar& car);
+
+    /**
+     * Deleted copy assignment operator.
+     */
+    LoadCar& operator=(const LoadCar&) = delete;
+
     /**
      * Getter for weight.
      * @return Base weight of the car and the weight of the load.
      */
     types::weight getWeight() const;
 
+    /**
+     * Getter for memory usage.
+     * @return Approximate memory used by the car and its load, in bytes.
+     */
+    std::size_t getMemoryUsage() const;
+
+    /**
+     * Compute the hash of the state of the car, load included.
+     * @return Hash of the car.
+     */
+    std::uint64_t computeHash() const;
+
     /**
      * Getter for max quantity of merch load.
      * @return Total capacity of the car.
@@ -354,9 +739,11 @@ class LoadCar : public Car {
 
     /**
      * Getter for merch load.
+     * The load is read-only: it is only changed through the car, which keeps
+     * its hot state in sync.
      * @return Load in the car.
      */
-    std::shared_ptr<merchandises::MerchLoad> getMerchLoad();
+    std::shared_ptr<const merchandises::MerchLoad> getMerchLoad() const;
 
     /**
      * Tell if the car is empty.
@@ -384,6 +771,13 @@ class LoadCar : public Car {
      */
     bool canLoad(const std::shared_ptr<merchandises::MerchLoad>& merchLoad) const;
 
+    /**
+     * Tell if the car can load this merch.
+     * @param merch Merch to consider.
+     * @return True if the merch can be loaded.
+     */
+    bool canLoad(const merchandises::Merch& merch) const;
+
     /**
      * Load a merch load in the car.
      * @param merchLoad Load to load in the car. After the call, the merch load
@@ -420,6 +814,30 @@ class LoadCar : public Car {
      * @return Load unloaded, containing the required quantity.
      */
     merchandises::MerchLoad unLoad(const types::quantity quantity);
+
+    /**
+     * Transfer a certain quantity of the load of the car to another car.
+     * The quantity is moved and the price averaged in place, without
+     * intermediate loads. A whole load moved to an empty car using the same
+     * arena is handed over as is.
+     * @param destination Car receiving the load.
+     * @param quantity Quantity to transfer.
+     * @throw DestroyedCarError If one of the cars is destroyed.
+     * @throw NotEnoughLoadError If the car does not hold the quantity.
+     * @throw CannotLoadError If the other car does not accept the merch.
+     * @throw NotEnoughSpaceError If the other car has not enough space.
+     */
+    void transfer(LoadCar& destination, const types::quantity quantity);
+
+    /**
+     * Restore a previous state of the load of the car.
+     * Used to roll back load and unload operations without copying loads.
+     * @param merch Merch of the load, used if the car is currently empty.
+     * @param quantity Quantity to restore, the car is emptied if 0.
+     * @param cost Average cost of a unit to restore.
+     */
+    void restoreLoad(const merchandises::Merch& merch, const types::quantity quantity,
+                     const types::money cost);
 };
 
 /**
@@ -5,14 +5,30 @@
 
 namespace cars {
 
+/**
+ * Table of the built-in load car models.
+ * Each row gives the variable, ID, name, weight, maximum quantity and type of
+ * merch of a model.
+ */
 // *INDENT-OFF*
-const LoadCarModel Merchandise   ( 101 , "merchandise"    , 45 , 20 , merchandises::MerchTypes::box       ) ;
-const LoadCarModel MerchandiseXL ( 102 , "merchandise XL" , 55 , 40 , merchandises::MerchTypes::box       ) ;
-const LoadCarModel BioGreenhouse ( 103 , "bio greenhouse" , 40 , 10 , merchandises::MerchTypes::vegetal   ) ;
-const LoadCarModel Tank          ( 104 , "tank"           , 40 , 20 , merchandises::MerchTypes::drinkable ) ;
-const LoadCarModel OilTank       ( 105 , "oil tank"       , 45 , 20 , merchandises::MerchTypes::toxic     ) ;
+#define CARS_TABLE(ROW) \
+    ROW( Merchandise   , 101 , "merchandise"    , 45 , 20 , box       ) \
+    ROW( MerchandiseXL , 102 , "merchandise XL" , 55 , 40 , box       ) \
+    ROW( BioGreenhouse , 103 , "bio greenhouse" , 40 , 10 , vegetal   ) \
+    ROW( Tank          , 104 , "tank"           , 40 , 20 , drinkable ) \
+    ROW( OilTank       , 105 , "oil tank"       , 45 , 20 , toxic     )
 // *INDENT-ON*
 
+/**
+ * Define a built-in load car model.
+ */
+#define CARS_DEFINE(variable, id, name, weight, maxQuantity, type) \
+    const LoadCarModel variable(id, name, weight, maxQuantity, merchandises::MerchTypes::type);
+
+CARS_TABLE(CARS_DEFINE)
+
+#undef CARS_DEFINE
+
 }
 
 #endif // ifndef CARS_DATA_HPP
@@ -0,0 +1,41 @@
+#ifndef CATALOGS_HPP
+#define CATALOGS_HPP
+
+#include "gameplay/train/cars.hpp"
+#include "gameplay/train/merchandises.hpp"
+#include "tools/catalog.hpp"
+
+/**
+ * Catalogs of merchs and load car models.
+ * Catalogs hold the built-in entries, whose perfect hash is found at compile
+ * time, and the entries added by mods.
+ */
+namespace catalogs {
+
+/**
+ * Catalog of merchs.
+ */
+using MerchCatalog = catalog::Catalog<merchandises::Merch>;
+
+/**
+ * Catalog of load car models.
+ */
+using CarModelCatalog = catalog::Catalog<cars::LoadCarModel>;
+
+/**
+ * Get the catalog of merchs.
+ * The catalog is created on first use.
+ * @return Catalog of merchs.
+ */
+MerchCatalog& getMerchs();
+
+/**
+ * Get the catalog of load car models.
+ * The catalog is created on first use.
+ * @return Catalog of load car models.
+ */
+CarModelCatalog& getCarModels();
+
+}
+
+#endif // ifndef CATALOGS_HPP
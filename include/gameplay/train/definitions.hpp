@@ -0,0 +1,99 @@
+#ifndef DEFINITIONS_HPP
+#define DEFINITIONS_HPP
+
+#include <cstddef>
+#include <istream>
+#include <string>
+
+#include "exceptions.hpp"
+#include "gameplay/train/catalogs.hpp"
+
+/**
+ * Definitions of catalog entries, loaded at runtime.
+ * Definitions are text files adding merchs and load car models to the
+ * catalogs, so that mods do not need to recompile the game. Each line holds a
+ * definition, empty lines and lines starting with `#` are ignored:
+ *
+ * - `merch ID NAME TYPE`: define a merch;
+ * - `car ID NAME WEIGHT MAX_QUANTITY TYPE`: define a load car model.
+ *
+ * Names with spaces are quoted, as `"flat car"`. Types are `box`,
+ * `drinkable`, `toxic` or `vegetal`.
+ *
+ * Text files are compiled to a binary cache, memory-mapped on later loads
+ * instead of parsing the text again. The cache is compiled again when the
+ * size or the modification time of the text file changes.
+ */
+namespace definitions {
+
+/**
+ * Load definitions from a text stream, without cache.
+ * @param stream Stream to read the definitions from.
+ * @param merchs Catalog to add the merchs to.
+ * @param carModels Catalog to add the car models to.
+ * @return Number of entries added.
+ * @throw DefinitionError If a definition cannot be read.
+ * @throw catalog::DuplicateEntryError If a name or an ID is already used.
+ */
+std::size_t loadText(std::istream& stream, catalogs::MerchCatalog& merchs,
+                     catalogs::CarModelCatalog& carModels);
+
+/**
+ * Load definitions from a text file, through its binary cache.
+ * The cache is written if missing or outdated; failing to write it is not an
+ * error.
+ * @param path Path of the text file.
+ * @param cachePath Path of the cache file.
+ * @param merchs Catalog to add the merchs to.
+ * @param carModels Catalog to add the car models to.
+ * @return True if the definitions were loaded from the cache.
+ * @throw FileError If the text file cannot be read.
+ * @throw DefinitionError If a definition cannot be read.
+ * @throw catalog::DuplicateEntryError If a name or an ID is already used.
+ */
+bool load(const std::string& path, const std::string& cachePath,
+          catalogs::MerchCatalog& merchs, catalogs::CarModelCatalog& carModels);
+
+/**
+ * Error class used when a definition cannot be read.
+ */
+class DefinitionError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     */
+    std::string message;
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param line Number of the line, starting at 1.
+     * @param reason Reason of the error.
+     */
+    DefinitionError(const std::size_t line, const std::string& reason);
+
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return message.c_str();
+    }
+};
+
+/**
+ * Error class used when a definitions file cannot be read.
+ */
+struct FileError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Cannot read definitions file";
+    }
+};
+
+}
+
+#endif // ifndef DEFINITIONS_HPP
@@ -121,6 +121,24 @@ class Merch {
  */
 const Merch nullMerch;
 
+/**
+ * Amount of money worth one price unit.
+ */
+const types::money moneyScale = 10000;
+
+/**
+ * Average the costs of two quantities of merchandise.
+ * The weighted sum is accumulated on 64 bits and rounded to the nearest unit
+ * of money, which cannot overflow for costs of valid prices.
+ * @param quantity First quantity.
+ * @param cost Average cost of a unit of the first quantity.
+ * @param otherQuantity Second quantity.
+ * @param otherCost Average cost of a unit of the second quantity.
+ * @return Average cost of a unit of both quantities, or 0 if they are empty.
+ */
+types::money averageCost(const types::quantity quantity, const types::money cost,
+                         const types::quantity otherQuantity, const types::money otherCost);
+
 /**
  * Load of merch object.
  */
@@ -146,9 +164,10 @@ class MerchLoad {
     types::quantity quantity;
 
     /**
-     * Price.
+     * Average cost of a unit of merchandise.
+     * Kept in fixed point, so that repeated merges do not truncate it.
      */
-    types::price price;
+    types::money cost;
 
   public:
 
@@ -173,6 +192,16 @@ class MerchLoad {
      */
     MerchLoad(const MerchLoad& merchLoad);
 
+    /**
+     * Create a load at a given cost.
+     * @param merch Merch of the load.
+     * @param quantity Quantity of merch in the load.
+     * @param cost Average cost of a unit of the load.
+     * @return Load.
+     */
+    static MerchLoad atCost(const Merch& merch, const types::quantity quantity,
+                            const types::money cost);
+
     /**
      * Getter for load ID.
      * @return ID of the load.
@@ -193,10 +222,22 @@ class MerchLoad {
 
     /**
      * Getter for price.
-     * @return Average price of the load.
+     * @return Average price of the load, rounded down.
      */
     types::price getPrice() const;
 
+    /**
+     * Getter for cost.
+     * @return Average cost of a unit of the load.
+     */
+    types::money getCost() const;
+
+    /**
+     * Get the value of the load.
+     * @return Quantity times average cost of the load.
+     */
+    types::money getValue() const;
+
     /**
      * Add merchandise loads.
      * @param otherQuantity Quantity to add to the load.
@@ -205,6 +246,14 @@ class MerchLoad {
      */
     void add(const types::quantity otherQuantity, const types::price otherPrice);
 
+    /**
+     * Add merchandise loads at a given cost.
+     * The final cost is the weighted average of the costs, see `averageCost`.
+     * @param otherQuantity Quantity to add to the load.
+     * @param otherCost Average cost of a unit of the quantity to add.
+     */
+    void addAtCost(const types::quantity otherQuantity, const types::money otherCost);
+
     /**
      * Add merchandise loads.
      * @param other Load to add.
@@ -235,6 +284,14 @@ class MerchLoad {
      */
     MerchLoad split(const MerchLoad& other);
 
+    /**
+     * Restore a previous state of the load.
+     * Used to roll back operations, the cost is not averaged.
+     * @param otherQuantity Quantity to restore.
+     * @param otherCost Average cost of a unit to restore.
+     */
+    void restore(const types::quantity otherQuantity, const types::money otherCost);
+
     /**
      * Check two merchandise loads have the same merchandise.
      * @param other Load to compare the merch with.
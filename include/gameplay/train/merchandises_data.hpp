@@ -5,25 +5,40 @@
 
 namespace merchandises {
 
+/**
+ * Table of the built-in merchs.
+ * Each row gives the variable, ID, name and type of a merch.
+ */
 // *INDENT-OFF*
-const Merch alcohol  ( 1  , "alcohol"             , MerchTypes::drinkable ) ;
-const Merch antiques ( 2  , "antiques"            , MerchTypes::box       ) ;
-const Merch caviar   ( 3  , "caviar"              , MerchTypes::box       ) ;
-const Merch fish     ( 4  , "fish"                , MerchTypes::box       ) ;
-const Merch rods     ( 5  , "fishing rods"        , MerchTypes::box       ) ;
-const Merch furs     ( 6  , "furs"                , MerchTypes::box       ) ;
-const Merch gasoline ( 7  , "gasoline"            , MerchTypes::toxic     ) ;
-const Merch draisine ( 8  , "line inspection car" , MerchTypes::box       ) ;
-const Merch dung     ( 9  , "mammoth dung"        , MerchTypes::box       ) ;
-const Merch missiles ( 10 , "missiles"            , MerchTypes::box       ) ;
-const Merch oil      ( 11 , "oil"                 , MerchTypes::toxic     ) ;
-const Merch plants   ( 12 , "plants"              , MerchTypes::vegetal   ) ;
-const Merch rails    ( 13 , "rails"               , MerchTypes::box       ) ;
-const Merch salt     ( 14 , "salt"                , MerchTypes::box       ) ;
-const Merch meat     ( 15 , "wolf meat"           , MerchTypes::box       ) ;
-const Merch wood     ( 16 , "wood"                , MerchTypes::box       ) ;
+#define MERCHANDISES_TABLE(ROW) \
+    ROW( alcohol  , 1  , "alcohol"             , drinkable ) \
+    ROW( antiques , 2  , "antiques"            , box       ) \
+    ROW( caviar   , 3  , "caviar"              , box       ) \
+    ROW( fish     , 4  , "fish"                , box       ) \
+    ROW( rods     , 5  , "fishing rods"        , box       ) \
+    ROW( furs     , 6  , "furs"                , box       ) \
+    ROW( gasoline , 7  , "gasoline"            , toxic     ) \
+    ROW( draisine , 8  , "line inspection car" , box       ) \
+    ROW( dung     , 9  , "mammoth dung"        , box       ) \
+    ROW( missiles , 10 , "missiles"            , box       ) \
+    ROW( oil      , 11 , "oil"                 , toxic     ) \
+    ROW( plants   , 12 , "plants"              , vegetal   ) \
+    ROW( rails    , 13 , "rails"               , box       ) \
+    ROW( salt     , 14 , "salt"                , box       ) \
+    ROW( meat     , 15 , "wolf meat"           , box       ) \
+    ROW( wood     , 16 , "wood"                , box       )
 // *INDENT-ON*
 
+/**
+ * Define a built-in merch.
+ */
+#define MERCHANDISES_DEFINE(variable, id, name, type) \
+    const Merch variable(id, name, MerchTypes::type);
+
+MERCHANDISES_TABLE(MERCHANDISES_DEFINE)
+
+#undef MERCHANDISES_DEFINE
+
 }
 
 #endif // ifndef MERCHANDISES_DATA_HPP
@@ -0,0 +1,105 @@
+#ifndef TRACTION_HPP
+#define TRACTION_HPP
+
+#include "types.hpp"
+
+/**
+ * Movement of trains.
+ * The model is a simple first order one: the engine power fights against a
+ * resistance proportional to the weight and to the speed of the train.
+ */
+namespace traction {
+
+/**
+ * Resistance of the rails.
+ * Power needed to move 1 ton at 1 km/h, in kW.
+ */
+const float resistance = 0.05;
+
+/**
+ * Inertia of the trains.
+ * Power needed to accelerate 1 ton by 1 km/h in 1 hour, in kW.
+ */
+const float inertia = 0.0033;
+
+/**
+ * Coal burnt by the engine.
+ * Tons of coal per kWh.
+ */
+const float coalPerEnergy = 0.0003;
+
+/**
+ * Highest speed the rails allow, in km/h.
+ */
+const types::speed speedLimit = 120;
+
+/**
+ * Traction characteristics of a train.
+ * They only depend on the total weight and on the power of the train, so
+ * they are computed once and kept until one of them changes.
+ */
+struct Traction {
+    /**
+     * Total weight of the train, cars and loads included.
+     */
+    types::weight weight;
+
+    /**
+     * Total power of the engines.
+     */
+    types::power power;
+
+    /**
+     * Speed reached at full throttle.
+     */
+    types::speed maxSpeed;
+
+    /**
+     * Acceleration from standstill at full throttle, in km/h per hour.
+     */
+    float acceleration;
+
+    /**
+     * Coal burnt at full throttle, in tons per hour.
+     */
+    types::weight coalConsumption;
+};
+
+/**
+ * Movement state of a train.
+ */
+struct Motion {
+    /**
+     * Current speed.
+     */
+    types::speed speed;
+
+    /**
+     * Coal in the tender, in tons.
+     */
+    types::weight coal;
+};
+
+/**
+ * Compute traction characteristics.
+ * @param weight Total weight of the train.
+ * @param power Total power of the engines.
+ * @return Traction characteristics.
+ */
+Traction compute(const types::weight weight, const types::power power);
+
+/**
+ * Advance the movement of a train.
+ * The speed tends toward the speed allowed by the throttle and the coal is
+ * consumed accordingly. Without coal, the train slows down.
+ * @param traction Traction characteristics of the train.
+ * @param motion Movement state to update.
+ * @param throttle Fraction of the power used, between 0 and 1.
+ * @param duration Time elapsed.
+ */
+void step(const Traction& traction, Motion& motion, const float throttle,
+          const types::duration duration);
+
+}
+
+#endif // ifndef TRACTION_HPP
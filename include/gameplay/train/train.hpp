@@ -1,47 +1,613 @@
 #ifndef TRAIN_HPP
 #define TRAIN_HPP
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "cars.hpp"
 #include "merchandises.hpp"
+#include "tools/arena.hpp"
+#include "tools/containers.hpp"
+#include "traction.hpp"
 #include "types.hpp"
 
 namespace train {
 
-class Train {
+class Transaction;
+
+/**
+ * Change of a car reported to the consumer of a train.
+ */
+struct CarChange {
+    /**
+     * Unique ID of the car.
+     */
+    types::id carId;
+
+    /**
+     * Changes since the last report.
+     */
+    cars::Change changes;
+};
+
+/**
+ * Handle to a car of a train.
+ * It is as cheap to copy as an integer and gives access to the car without
+ * reference counting. It is checked against cars removed from the train
+ * after its creation.
+ */
+struct CarHandle {
+    /**
+     * Index of the slot of the car.
+     */
+    std::uint32_t index;
+
+    /**
+     * Generation of the slot when the handle was created.
+     */
+    std::uint32_t generation;
+};
+
+/**
+ * Position of a train on the rail network.
+ */
+struct Position {
+    /**
+     * Index of the rail arc the train is on.
+     * `noArc` if the train is not on the network.
+     */
+    std::uint32_t arc;
+
+    /**
+     * Index of the arc in the route followed by the train.
+     */
+    std::uint32_t leg;
+
+    /**
+     * Distance from the start of the arc.
+     */
+    types::distance offset;
+};
+
+/**
+ * Arc index of trains that are not on the network.
+ */
+const std::uint32_t noArc = UINT32_MAX;
+
+/**
+ * Outcome of the consolidation of the cargo of a train.
+ */
+struct Consolidation {
+    /**
+     * Number of load cars emptied.
+     */
+    std::size_t freedCars;
+
+    /**
+     * Capacity of the load cars emptied.
+     */
+    types::quantity freedCapacity;
+};
+
+/**
+ * Number of cars a train holds before allocating its storage on the heap.
+ * Most trains are shorter than that.
+ */
+const std::size_t inlineCarCount = 16;
+
+class Train : public cars::CarObserver {
   protected:
 
-    std::vector<std::shared_ptr<cars::Car>> cars;
+    /**
+     * Storage of a car of the train.
+     * A car is either shared with the rest of the game, or owned by the train
+     * alone.
+     */
+    struct Slot {
+        /**
+         * Car, or null pointer if the slot is free.
+         */
+        cars::Car* car;
+
+        /**
+         * Shared car.
+         */
+        std::shared_ptr<cars::Car> shared;
+
+        /**
+         * Owned car.
+         */
+        std::unique_ptr<cars::Car> owned;
+
+        /**
+         * Generation of the slot, increased each time it is freed.
+         */
+        std::uint32_t generation;
+    };
+
+    /**
+     * Arena the cars created by the train and their loads are allocated
+     * from.
+     * Null pointer if they are allocated on the heap.
+     */
+    std::shared_ptr<arena::Arena> region;
+
+    /**
+     * Slots of the cars, in no particular order.
+     */
+    containers::SmallVector<Slot, inlineCarCount> slots;
+
+    /**
+     * Indexes of free slots.
+     */
+    containers::SmallVector<std::uint32_t, inlineCarCount> freeSlots;
+
+    /**
+     * Indexes of the slots of the cars, in the order of the train.
+     */
+    containers::SmallVector<std::uint32_t, inlineCarCount> consist;
+
+    /**
+     * Hot states of the cars, by slot.
+     * Copies kept up to date when cars change, so that passes over the whole
+     * train read one packed array. States of free slots are zeroed.
+     */
+    containers::SmallVector<cars::CarState, inlineCarCount> states;
+
+    /**
+     * Cached traction characteristics.
+     * Only valid if `isTractionValid` is true.
+     */
+    mutable traction::Traction traction;
+
+    /**
+     * Tell if the cached traction characteristics are up to date.
+     * They are invalidated when the consist or a car changes.
+     */
+    mutable bool isTractionValid;
+
+    /**
+     * Movement state.
+     */
+    traction::Motion motion;
+
+    /**
+     * Fraction of the power used.
+     */
+    float throttle;
+
+    /**
+     * Position on the rail network.
+     */
+    Position position;
+
+    /**
+     * Changes not yet drained, in order of first change.
+     * Changes of cars still in the train are only gathered when draining.
+     */
+    containers::SmallVector<CarChange, inlineCarCount> changes;
+
+    /**
+     * Cars of the pending changes.
+     * Null pointer if the car has been removed from the train.
+     */
+    containers::SmallVector<cars::Car*, inlineCarCount> changedCars;
+
+    /**
+     * Hash of the state of the train, updated at each change.
+     * It sums the hashes of the cars and the hashes of the links between
+     * consecutive cars, so that it depends on the order of the train.
+     */
+    std::uint64_t stateHash;
+
+    /**
+     * Mark a car as changed.
+     * The car is added to the pending changes on its first change only.
+     * @param car Car that changed.
+     * @param change Kind of change.
+     */
+    void markChanged(cars::Car& car, const cars::Change change);
+
+    /**
+     * Find a car in the train.
+     * @param carId Unique ID of the car.
+     * @return Position of the car in the train.
+     */
+    std::size_t getCarPosition(const std::size_t carId) const;
+
+    /**
+     * Put a car in a free slot at the end of the train.
+     * @param car Car to add.
+     * @return Slot of the car.
+     */
+    Slot& attachCar(cars::Car* car);
 
-    std::vector<std::shared_ptr<cars::Car>>::iterator getCarIterator(const std::size_t carId);
+    /**
+     * Take a car out of the train and free its slot.
+     * @param position Position of the car in the train.
+     */
+    void detachCar(const std::size_t position);
+
+    /**
+     * Get the slot of a handle.
+     * @param handle Handle to check.
+     * @return Slot of the car.
+     */
+    const Slot& getSlot(const CarHandle handle) const;
+
+    /**
+     * Get the ID of the car at a position, for hashing links.
+     * The handle of the car is used rather than its unique ID, which depends
+     * on all the cars created before in the process.
+     * @param position Position in the train, plus one.
+     * @return Handle of the car, or special IDs for the ends of the train.
+     */
+    std::uint64_t getLinkId(const std::size_t position) const;
+
+    /**
+     * Update the hash of the links around a car.
+     * @param position Position of the car in the train.
+     * @param isInserted True if the car has just been inserted, false if it
+     * is about to be taken out.
+     */
+    void updateLinks(const std::size_t position, const bool isInserted);
 
   public:
 
     Train();
 
+    /**
+     * Constructor for train using an arena.
+     * The cars created with `makeCar` and their loads are allocated from
+     * blocks of the arena, all released at once when the train and its cars
+     * are destroyed.
+     * @param blockSize Size of the blocks of the arena, in bytes.
+     */
+    explicit Train(const std::size_t blockSize);
+
+    /**
+     * Trains cannot be copied, as their cars refer to them.
+     */
+    Train(const Train&) = delete;
+
+    /**
+     * Trains cannot be copied, as their cars refer to them.
+     */
+    Train& operator=(const Train&) = delete;
+
+    /**
+     * Destructor.
+     * Detach the cars from the train.
+     */
+    ~Train();
+
     const std::vector<const merchandises::MerchLoad&> getMerchLoads() const;
 
     const std::vector<const cars::Car&> getCars() const;
 
+    /**
+     * Buy merchandise.
+     * The merchandise is spread over the cars that accept it, in the order of
+     * the train. The purchase is all or nothing.
+     * @param merchLoad Load to buy from.
+     * @param quantity Quantity to buy.
+     */
     void buy(merchandises::MerchLoad& merchLoad, const types::quantity quantity);
 
-    bool canBuy(merchandises::MerchLoad& merchLoad, const types::quantity quantity);
+    /**
+     * Tell if merchandise can be bought.
+     * @param merchLoad Load to buy from.
+     * @param quantity Quantity to buy.
+     * @return True if the load has enough merchandise and the train enough
+     * space.
+     */
+    bool canBuy(const merchandises::MerchLoad& merchLoad, const types::quantity quantity) const;
+
+    /**
+     * Sell merchandise.
+     * The merchandise is taken from the cars that hold it, in the order of the
+     * train. The sale is all or nothing.
+     * @param merch Merch to sell.
+     * @param quantity Quantity to sell.
+     * @return Load sold, at the average price it was bought.
+     */
+    merchandises::MerchLoad sell(const merchandises::Merch& merch,
+                                 const types::quantity quantity);
+
+    /**
+     * Tell if merchandise can be sold.
+     * @param merch Merch to sell.
+     * @param quantity Quantity to sell.
+     * @return True if the train holds enough merchandise.
+     */
+    bool canSell(const merchandises::Merch& merch, const types::quantity quantity) const;
+
+    /**
+     * Tell if merchandise fits in the train.
+     * @param merch Merch to consider.
+     * @param quantity Quantity to consider.
+     * @return True if the cars accepting the merch have enough space.
+     */
+    bool canReceive(const merchandises::Merch& merch, const types::quantity quantity) const;
+
+    /**
+     * Transfer merchandise to another train, as in the same station.
+     * The merchandise is moved from car to car in place, in the order of the
+     * trains, without intermediate loads. The space and the quantity are
+     * checked once for the whole transfer, which is all or nothing.
+     * @param destination Train receiving the merchandise.
+     * @param merch Merch to transfer.
+     * @param quantity Quantity to transfer.
+     * @throw CannotTransferError If this train does not hold enough
+     * merchandise or the other train has not enough space.
+     */
+    void transfer(Train& destination, const merchandises::Merch& merch,
+                  const types::quantity quantity);
+
+    /**
+     * Repack the cargo by merch into the fewest cars.
+     * For each merch, the cars kept are the largest of the cars holding it,
+     * the fullest first, until they can hold the whole quantity. Empty cars
+     * are left untouched, so that the capacity freed is never spent again.
+     * The plan is computed in one pass, then the other cars are emptied into
+     * the kept ones with in-place transfers.
+     * @return Cars and capacity freed.
+     */
+    Consolidation consolidate();
+
+    /**
+     * Add a car shared with the rest of the game at the end of the train.
+     * @param car Car to add.
+     * @return Handle to the car.
+     */
+    CarHandle addCar(std::shared_ptr<cars::Car> car);
+
+    /**
+     * Add a car owned by the train alone at the end of the train.
+     * The car is destroyed with the train, unless it is removed before.
+     * @param car Car to add.
+     * @return Handle to the car.
+     */
+    CarHandle addCar(std::unique_ptr<cars::Car> car);
+
+    /**
+     * Create a car owned by the train alone and add it to the train.
+     * @param args Arguments of the constructor of the car.
+     * @return Handle to the car.
+     */
+    template <typename T, typename... Args>
+    CarHandle makeOwnedCar(Args&& ... args) {
+        return addCar(std::unique_ptr<cars::Car>(new T(std::forward<Args>(args)...)));
+    }
 
-    void sell(merchandises::Merch& merch, const types::quantity quantity);
+    /**
+     * Create a car and add it to the train.
+     * The car is allocated from the arena of the train, if any.
+     * @param args Arguments of the constructor of the car.
+     * @return Created car.
+     */
+    template <typename T, typename... Args>
+    std::shared_ptr<T> makeCar(Args&& ... args) {
+        auto car = arena::makeShared<T>(region.get(), std::forward<Args>(args)...);
+        car->setArena(region.get());
+        addCar(car);
+        return car;
+    }
 
-    bool canSell(merchandises::Merch& merch, const types::quantity quantity);
+    /**
+     * Getter for arena.
+     * @return Arena of the train, or null pointer.
+     */
+    std::shared_ptr<arena::Arena> getArena() const;
 
-    void addCar(std::shared_ptr<cars::Car> car);
+    /**
+     * Getter for memory usage.
+     * With an arena, the blocks of the arena are counted, otherwise the
+     * approximate memory used by each car.
+     * @return Memory used by the train, its cars and their loads, in bytes.
+     */
+    std::size_t getMemoryUsage() const;
 
+    /**
+     * Remove a car from the train.
+     * A car owned by the train is given to the caller.
+     * @param carId Unique ID of the car.
+     * @return Removed car.
+     */
     std::shared_ptr<cars::Car> removeCar(const std::size_t carId);
 
+    /**
+     * Remove a car owned by the train alone.
+     * @param handle Handle to the car.
+     * @return Removed car.
+     */
+    std::unique_ptr<cars::Car> releaseCar(const CarHandle handle);
+
     void moveCar(const std::size_t carId, const std::size_t position);
 
+    /**
+     * Getter for car.
+     * For a car owned by the train, the returned pointer does not own the
+     * car and must not outlive its presence in the train.
+     * @param carId Unique ID of the car.
+     * @return Car.
+     */
     std::shared_ptr<cars::Car> getCar(const std::size_t carId);
+
+    /**
+     * Getter for handle.
+     * @param carId Unique ID of the car.
+     * @return Handle to the car.
+     */
+    CarHandle getHandle(const std::size_t carId) const;
+
+    /**
+     * Getter for handle by position.
+     * @param position Position of the car in the train.
+     * @return Handle to the car.
+     */
+    CarHandle getHandleAt(const std::size_t position) const;
+
+    /**
+     * Tell if a handle refers to a car still in the train.
+     * @param handle Handle to check.
+     * @return True if the car is still in the train.
+     */
+    bool isValid(const CarHandle handle) const;
+
+    /**
+     * Access a car by handle.
+     * @param handle Handle to the car.
+     * @return Car.
+     */
+    cars::Car& get(const CarHandle handle) const;
+
+    /**
+     * Getter for size.
+     * @return Number of cars in the train.
+     */
+    std::size_t getSize() const;
+
+    /**
+     * Start a transaction on the cars of the train.
+     * @return Empty transaction.
+     */
+    Transaction beginTransaction();
+
+    /**
+     * Invalidate the cached traction characteristics and mark the car as
+     * changed.
+     * @param car Car that changed.
+     * @param change Kind of change.
+     */
+    void onCarChanged(cars::Car& car, const cars::Change change);
+
+    /**
+     * Tell if there are changes not yet drained.
+     * @return True if a car changed since the last drain.
+     */
+    bool hasChanges() const;
+
+    /**
+     * Get and forget the changes since the last drain.
+     * Each changed car appears once, with all its changes combined, so the
+     * cost only depends on the number of changed cars.
+     * @return Changes of cars, in order of first change.
+     */
+    std::vector<CarChange> drainChanges();
+
+    /**
+     * Getter for hash.
+     * The hash is updated in constant time at each change of a car or of the
+     * order of the cars, and only depends on the handles and the models of
+     * the cars, their order, their health and their loads. It is the same
+     * between runs doing the same operations on the train.
+     * @return Hash of the state of the train.
+     */
+    std::uint64_t getHash() const;
+
+    /**
+     * Compute the hash of the state of the train from scratch.
+     * Used to check the updated hash.
+     * @return Hash of the state of the train.
+     */
+    std::uint64_t computeHash() const;
+
+    /**
+     * Getter for traction characteristics.
+     * They are computed again only if the consist or a car changed since the
+     * last call.
+     * @return Traction characteristics of the train.
+     */
+    const traction::Traction& getTraction() const;
+
+    /**
+     * Compute traction characteristics.
+     * Always passes over all the cars, unlike `getTraction`.
+     * @return Traction characteristics of the train.
+     */
+    traction::Traction computeTraction() const;
+
+    /**
+     * Compute the value of the cargo.
+     * Reduces the packed states of the cars in a single pass, without
+     * reaching their loads.
+     * @return Total value of the loads of the cars that are not destroyed.
+     */
+    types::money computeValue() const;
+
+    /**
+     * Getter for weight.
+     * @return Total weight of the cars and their loads.
+     */
+    types::weight getWeight() const;
+
+    /**
+     * Getter for power.
+     * @return Total power of the locomotives that are not destroyed.
+     */
+    types::power getPower() const;
+
+    /**
+     * Getter for speed.
+     * @return Current speed of the train.
+     */
+    types::speed getSpeed() const;
+
+    /**
+     * Getter for coal.
+     * @return Coal in the tender, in tons.
+     */
+    types::weight getCoal() const;
+
+    /**
+     * Add coal in the tender.
+     * @param coal Coal to add, in tons.
+     */
+    void addCoal(const types::weight coal);
+
+    /**
+     * Getter for throttle.
+     * @return Fraction of the power used.
+     */
+    float getThrottle() const;
+
+    /**
+     * Setter for throttle.
+     * @param throttle Fraction of the power used, between 0 and 1.
+     */
+    void setThrottle(const float throttle);
+
+    /**
+     * Getter for position.
+     * @return Position on the rail network.
+     */
+    const Position& getPosition() const;
+
+    /**
+     * Setter for position.
+     * The position is not checked against the rail network.
+     * @param position Position on the rail network.
+     */
+    void setPosition(const Position& position);
+
+    /**
+     * Advance the movement of the train.
+     * @param duration Time elapsed.
+     */
+    void tick(const types::duration duration);
 };
 
+/**
+ * Compute the value of the cargo of several trains.
+ * Used for reports over the whole world.
+ * @param trains Trains to consider.
+ * @return Total value of the loads of the cars that are not destroyed.
+ */
+types::money computeValue(const std::vector<const Train*>& trains);
+
 /**
  * Error class when a car cannot be found.
  */
@@ -68,6 +634,45 @@ struct CarInvalidPositionError : public exceptions::TransarcticaRebirthError {
     }
 };
 
+/**
+ * Error class used when the throttle is out of range.
+ */
+struct InvalidThrottleError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Throttle must be between 0 and 1";
+    }
+};
+
+/**
+ * Error class used when a handle refers to a car not in the train anymore.
+ */
+struct StaleHandleError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Car handle is not valid anymore";
+    }
+};
+
+/**
+ * Error class used when trying to release a car not owned by the train.
+ */
+struct NotOwnedCarError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Car is shared and cannot be released";
+    }
+};
+
 /**
  * Error class used when trying to remove a special car.
  */
@@ -82,6 +687,45 @@ struct SpecialCarRemoveError : public exceptions::TransarcticaRebirthError {
     }
 };
 
+/**
+ * Error class used when merchandise cannot be bought.
+ */
+struct CannotBuyError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Not enough merchandise or space to buy";
+    }
+};
+
+/**
+ * Error class used when merchandise cannot be transferred between trains.
+ */
+struct CannotTransferError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Merchandise cannot be transferred";
+    }
+};
+
+/**
+ * Error class used when merchandise cannot be sold.
+ */
+struct CannotSellError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Not enough merchandise to sell";
+    }
+};
+
 }
 
 #endif //ifndef TRAIN_HPP
@@ -0,0 +1,200 @@
+#ifndef TRANSACTION_HPP
+#define TRANSACTION_HPP
+
+#include <vector>
+
+#include "cars.hpp"
+#include "merchandises.hpp"
+#include "train.hpp"
+#include "types.hpp"
+
+namespace train {
+
+/**
+ * Set of load and unload operations on the cars of a train, applied all
+ * together or not at all.
+ * Operations are staged, then applied in order on commit. If one of them
+ * fails, the operations already applied are rolled back from an undo log,
+ * without any copy of the cars or of the loads, and the error is thrown
+ * again.
+ */
+class Transaction {
+    /**
+     * Kinds of operations.
+     */
+    enum class Operation {
+        /**
+         * Load merch in a car.
+         */
+        load,
+
+        /**
+         * Unload merch from a car.
+         */
+        unLoad,
+    };
+
+    /**
+     * Staged operation.
+     */
+    struct Step {
+        /**
+         * Kind of operation.
+         */
+        Operation operation;
+
+        /**
+         * Handle to the car to load or unload.
+         * The car is looked up again when the operation is applied, in case
+         * it left the train meanwhile.
+         */
+        CarHandle handle;
+
+        /**
+         * Load to take merch from when loading, or to put merch in when
+         * unloading.
+         */
+        merchandises::MerchLoad* merchLoad;
+
+        /**
+         * Quantity to move.
+         */
+        types::quantity quantity;
+    };
+
+    /**
+     * Record of an applied operation.
+     */
+    struct UndoRecord {
+        /**
+         * Applied operation.
+         */
+        Step step;
+
+        /**
+         * Car of the operation, valid until the end of the commit.
+         */
+        cars::LoadCar* car;
+
+        /**
+         * Average cost of the load of the car before the operation.
+         */
+        types::money carCost;
+
+        /**
+         * Average cost of the other load before the operation.
+         */
+        types::money merchLoadCost;
+    };
+
+    /**
+     * Train of the cars.
+     */
+    Train& train;
+
+    /**
+     * Staged operations.
+     */
+    std::vector<Step> steps;
+
+    /**
+     * Applied operations of the current commit.
+     */
+    std::vector<UndoRecord> undoLog;
+
+    /**
+     * Get a load car of the train.
+     * @param handle Handle to the car.
+     * @return Car.
+     * @throw StaleHandleError If the car is not in the train anymore.
+     * @throw NotLoadCarError If the car is not a load car.
+     */
+    cars::LoadCar* getLoadCar(const CarHandle handle);
+
+    /**
+     * Stage an operation.
+     * @param operation Kind of operation.
+     * @param carId Unique ID of the car.
+     * @param merchLoad Load to take merch from or to put merch in.
+     * @param quantity Quantity to move.
+     */
+    void stage(const Operation operation, const std::size_t carId,
+               merchandises::MerchLoad& merchLoad, const types::quantity quantity);
+
+    /**
+     * Apply an operation.
+     * The operation is recorded in the undo log once it has been applied.
+     * @param step Operation to apply.
+     * @throw StaleHandleError If the car left the train since the operation
+     * was staged.
+     */
+    void apply(const Step& step);
+
+    /**
+     * Undo the applied operations, in reverse order.
+     */
+    void rollBack();
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param train Train of the cars.
+     */
+    explicit Transaction(Train& train);
+
+    /**
+     * Stage the load of a certain quantity of a merch load in a car.
+     * @param carId Unique ID of the car.
+     * @param merchLoad Load to take merch from.
+     * @param quantity Quantity to load.
+     */
+    void load(const std::size_t carId, merchandises::MerchLoad& merchLoad,
+              const types::quantity quantity);
+
+    /**
+     * Stage the unload of a certain quantity of merch from a car.
+     * @param carId Unique ID of the car.
+     * @param merchLoad Load to put merch in. It must have the same merch as
+     * the car.
+     * @param quantity Quantity to unload.
+     */
+    void unLoad(const std::size_t carId, merchandises::MerchLoad& merchLoad,
+                const types::quantity quantity);
+
+    /**
+     * Getter for size.
+     * @return Number of staged operations.
+     */
+    std::size_t getSize() const;
+
+    /**
+     * Discard the staged operations.
+     */
+    void cancel();
+
+    /**
+     * Apply all the staged operations.
+     * If one of them fails, or if one of the cars left the train, the train
+     * and the loads are restored as they were before the call and the error
+     * is thrown again. The staged operations are discarded in any case.
+     */
+    void commit();
+};
+
+/**
+ * Error class used when a car is not a load car.
+ */
+struct NotLoadCarError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Car cannot carry loads";
+    }
+};
+
+}
+
+#endif // ifndef TRANSACTION_HPP
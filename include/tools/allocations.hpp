@@ -0,0 +1,28 @@
+#ifndef ALLOCATIONS_HPP
+#define ALLOCATIONS_HPP
+
+#include <cstdint>
+
+/**
+ * Counting of heap allocations.
+ * Linking the `allocations` library replaces the global `operator new` and
+ * `operator delete` of the whole executable with counting versions, so it is
+ * only meant for the tools measuring a run, not for the libraries.
+ */
+namespace allocations {
+
+/**
+ * Get the number of allocations since the start.
+ * @return Number of allocations.
+ */
+std::uint64_t getCount();
+
+/**
+ * Get the size of the allocations since the start.
+ * @return Size of the allocations, in bytes.
+ */
+std::uint64_t getSize();
+
+}
+
+#endif // ALLOCATIONS_HPP
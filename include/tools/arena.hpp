@@ -0,0 +1,227 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Region-based memory allocation.
+ * Objects of an arena are allocated in large blocks, all released at once
+ * when the arena is destroyed. Freed memory is kept in free lists per size,
+ * to be reused by the next allocations of the same size.
+ *
+ * An arena is not thread safe.
+ */
+namespace arena {
+
+/**
+ * Alignment of all the allocations.
+ */
+const std::size_t alignment = alignof(std::max_align_t);
+
+/**
+ * Default size of a block, in bytes.
+ */
+const std::size_t defaultBlockSize = 4096;
+
+/**
+ * Memory region.
+ * Arenas are always handled by shared pointers, so that allocators can keep
+ * them alive as long as an object allocated from them exists.
+ */
+class Arena : public std::enable_shared_from_this<Arena> {
+    /**
+     * Size of a block, in bytes.
+     */
+    std::size_t blockSize;
+
+    /**
+     * Blocks of memory.
+     */
+    std::vector<std::unique_ptr<char[]>> blocks;
+
+    /**
+     * Next free byte in the current block.
+     */
+    char* current;
+
+    /**
+     * Free bytes remaining in the current block.
+     */
+    std::size_t remaining;
+
+    /**
+     * Free lists, as pairs of allocation size and first free chunk.
+     * Each free chunk starts with a pointer to the next one.
+     */
+    std::vector<std::pair<std::size_t, void*>> freeLists;
+
+    /**
+     * Total size of the blocks, in bytes.
+     */
+    std::size_t reserved;
+
+    /**
+     * Size of the live allocations, in bytes.
+     */
+    std::size_t used;
+
+    /**
+     * Number of live allocations.
+     */
+    std::size_t count;
+
+    /**
+     * Get the free list of a size.
+     * @param size Rounded size of the allocation.
+     * @return Free list, created if needed.
+     */
+    void*& getFreeList(const std::size_t size);
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param blockSize Size of a block, in bytes.
+     */
+    explicit Arena(const std::size_t blockSize = defaultBlockSize);
+
+    /**
+     * Arenas cannot be copied.
+     */
+    Arena(const Arena&) = delete;
+
+    /**
+     * Arenas cannot be copied.
+     */
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Allocate memory.
+     * @param size Size of the allocation, in bytes.
+     * @return Pointer to the memory.
+     */
+    void* allocate(const std::size_t size);
+
+    /**
+     * Give back memory.
+     * The memory is only reused by the next allocations of the same size.
+     * @param pointer Pointer to the memory.
+     * @param size Size of the allocation, in bytes.
+     */
+    void deallocate(void* pointer, const std::size_t size);
+
+    /**
+     * Getter for reserved memory.
+     * @return Total size of the blocks, in bytes.
+     */
+    std::size_t getReserved() const;
+
+    /**
+     * Getter for used memory.
+     * @return Size of the live allocations, in bytes.
+     */
+    std::size_t getUsed() const;
+
+    /**
+     * Getter for allocations count.
+     * @return Number of live allocations.
+     */
+    std::size_t getCount() const;
+};
+
+/**
+ * Standard allocator using an arena.
+ * The allocator keeps the arena alive, so the arena is released when the
+ * last object allocated from it is destroyed.
+ */
+template <typename T>
+class Allocator {
+    template <typename U>
+    friend class Allocator;
+
+    /**
+     * Arena to allocate from.
+     */
+    std::shared_ptr<Arena> arena;
+
+  public:
+
+    /**
+     * Type of allocated objects.
+     */
+    using value_type = T;
+
+    /**
+     * Usual constructor.
+     * @param arena Arena to allocate from.
+     */
+    explicit Allocator(const std::shared_ptr<Arena>& arena) :
+        arena(arena) {}
+
+    /**
+     * Converting constructor.
+     * @param other Allocator of another type, with the same arena.
+     */
+    template <typename U>
+    Allocator(const Allocator<U>& other) :
+        arena(other.arena) {}
+
+    /**
+     * Allocate memory for objects.
+     * @param n Number of objects.
+     * @return Pointer to the memory.
+     */
+    T* allocate(const std::size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T)));
+    }
+
+    /**
+     * Give back memory of objects.
+     * @param pointer Pointer to the memory.
+     * @param n Number of objects.
+     */
+    void deallocate(T* pointer, const std::size_t n) {
+        arena->deallocate(pointer, n * sizeof(T));
+    }
+
+    /**
+     * Equality operator.
+     * @param other Other allocator.
+     * @return True if both allocators use the same arena.
+     */
+    template <typename U>
+    bool operator ==(const Allocator<U>& other) const {
+        return arena == other.arena;
+    }
+
+    /**
+     * Inequality operator.
+     * @param other Other allocator.
+     * @return True if the allocators use different arenas.
+     */
+    template <typename U>
+    bool operator !=(const Allocator<U>& other) const {
+        return arena != other.arena;
+    }
+};
+
+/**
+ * Create an object in an arena, or on the heap.
+ * @param arena Arena to allocate from, or null pointer for the heap.
+ * @param args Arguments of the constructor of the object.
+ * @return Shared pointer to the object.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> makeShared(Arena* arena, Args&& ... args) {
+    if (!arena) return std::make_shared<T>(std::forward<Args>(args)...);
+
+    return std::allocate_shared<T>(Allocator<T>(arena->shared_from_this()),
+                                   std::forward<Args>(args)...);
+}
+
+}
+
+#endif // ifndef ARENA_HPP
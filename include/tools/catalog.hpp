@@ -0,0 +1,561 @@
+#ifndef CATALOG_HPP
+#define CATALOG_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "tools/hash.hpp"
+#include "types.hpp"
+
+/**
+ * Catalogs of entries looked up by name and by ID.
+ * Lookups use perfect hashing: each key has its own slot, so that finding an
+ * entry costs one hash and one comparison, without scanning. The seed of the built-in entries is
+ * found at compile time, entries added at runtime, as mods, rebuild the hash
+ * when needed.
+ */
+namespace catalog {
+
+/**
+ * Value telling no seed was found.
+ */
+const std::uint64_t noSeed = UINT64_MAX;
+
+/**
+ * Number of seeds tried for a bucket before growing the table.
+ */
+const std::uint64_t maxSeed = 256;
+
+/**
+ * Number of slots per bucket.
+ * Tables being at most a quarter full, buckets have at most 4 keys on average.
+ */
+const std::size_t bucketSlots = 16;
+
+/**
+ * Value of empty slots.
+ */
+const std::int32_t emptySlot = -1;
+
+/**
+ * Get the number of slots for keys.
+ * Tables are kept at most a quarter full, so that seeds are found quickly.
+ * @param count Number of keys.
+ * @param size Smallest size.
+ * @return Number of slots, as a power of 2.
+ */
+constexpr std::size_t getTableSize(const std::size_t count, const std::size_t size = 1) {
+    return size >= count * 4 ? size : getTableSize(count, size * 2);
+}
+
+/**
+ * Hash a name.
+ * @param key Name.
+ * @param seed Seed of the hash.
+ * @return Hash of the name.
+ */
+constexpr std::uint64_t hashKey(const char* key, const std::uint64_t seed) {
+    return hash::hashString(key, seed);
+}
+
+/**
+ * Hash a name.
+ * @param key Name.
+ * @param seed Seed of the hash.
+ * @return Hash of the name.
+ */
+inline std::uint64_t hashKey(const std::string& key, const std::uint64_t seed) {
+    return hash::hashString(key, seed);
+}
+
+/**
+ * Hash an ID.
+ * @param key ID.
+ * @param seed Seed of the hash.
+ * @return Hash of the ID.
+ */
+constexpr std::uint64_t hashKey(const types::id key, const std::uint64_t seed) {
+    return hash::combine(seed, key);
+}
+
+/**
+ * Tell if two keys use the same slot.
+ * Pairs of keys are checked from the given pair on.
+ * @param keys Keys.
+ * @param count Number of keys.
+ * @param seed Seed of the hash.
+ * @param mask Mask of the slots.
+ * @param first Index of the first key of the pair.
+ * @param second Index of the second key of the pair.
+ * @return True if two keys collide.
+ */
+template <typename Key>
+constexpr bool hasCollision(const Key* keys, const std::size_t count, const std::uint64_t seed,
+                            const std::size_t mask, const std::size_t first,
+                            const std::size_t second) {
+    return first + 1 >= count ? false :
+           second >= count ? hasCollision(keys, count, seed, mask, first + 1, first + 2) :
+           (hashKey(keys[first], seed) & mask) == (hashKey(keys[second], seed) & mask) ||
+           hasCollision(keys, count, seed, mask, first, second + 1);
+}
+
+/**
+ * Find a seed giving each key its own slot.
+ * Meant to be evaluated at compile time for small sets of keys, which fit in
+ * one bucket.
+ * @param keys Keys.
+ * @param count Number of keys.
+ * @param seed First seed to try.
+ * @return Seed, or `noSeed` if none was found, as for duplicate keys.
+ */
+template <typename Key>
+constexpr std::uint64_t findSeed(const Key* keys, const std::size_t count,
+                                 const std::uint64_t seed = 0) {
+    return seed == maxSeed ? noSeed :
+           !hasCollision(keys, count, seed, getTableSize(count) - 1, 0, 1) ? seed :
+           findSeed(keys, count, seed + 1);
+}
+
+/**
+ * Perfect hash table of keys.
+ * Keys are spread in buckets, each bucket has a seed placing its keys in
+ * free slots (hash and displace). When an inserted key collides, only its
+ * bucket is placed again; the table is rebuilt larger when it gets a quarter
+ * full.
+ */
+template <typename Key>
+class Table {
+    /**
+     * Keys, in the order of their entries.
+     */
+    std::vector<Key> keys;
+
+    /**
+     * Indexes of the keys of each bucket.
+     */
+    std::vector<std::vector<std::int32_t>> buckets;
+
+    /**
+     * Seeds of the buckets.
+     */
+    std::vector<std::uint64_t> seeds;
+
+    /**
+     * Index of the key of each slot, or `emptySlot`.
+     */
+    std::vector<std::int32_t> slots;
+
+    /**
+     * Get the bucket of a key.
+     * Uses the high bits of the hash, slots use the low bits.
+     * @param key Key.
+     * @return Index of the bucket.
+     */
+    std::size_t getBucket(const Key& key) const {
+        return (hashKey(key, 0) >> 32) & (seeds.size() - 1);
+    }
+
+    /**
+     * Get the slot of a key.
+     * @param key Key.
+     * @param seed Seed of the bucket of the key.
+     * @return Index of the slot.
+     */
+    std::size_t getSlot(const Key& key, const std::uint64_t seed) const {
+        return hashKey(key, seed) & (slots.size() - 1);
+    }
+
+    /**
+     * Try to place the keys of all the buckets.
+     * @param size Number of slots.
+     * @return True if all the keys were placed.
+     */
+    bool place(const std::size_t size) {
+        std::size_t bucketCount = std::max<std::size_t>(size / bucketSlots, 1);
+
+        seeds.assign(bucketCount, 0);
+        slots.assign(size, emptySlot);
+        buckets.assign(bucketCount, std::vector<std::int32_t>());
+
+        for (std::size_t index = 0; index < keys.size(); index++) {
+            buckets[getBucket(keys[index])].push_back(index);
+        }
+
+        // place the largest buckets first, while the table is empty
+        std::vector<std::size_t> order(bucketCount);
+
+        for (std::size_t bucket = 0; bucket < bucketCount; bucket++) {
+            order[bucket] = bucket;
+        }
+
+        std::stable_sort(order.begin(), order.end(),
+        [this](const std::size_t first, const std::size_t second) {
+            return buckets[first].size() > buckets[second].size();
+        });
+
+        for (const std::size_t bucket : order) {
+            if (!placeBucket(bucket)) return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Try to place the keys of a bucket.
+     * The slots of the bucket must be free.
+     * @param bucket Index of the bucket.
+     * @return True if a seed placing all the keys was found.
+     */
+    bool placeBucket(const std::size_t bucket) {
+        const std::vector<std::int32_t>& indexes = buckets[bucket];
+
+        for (std::uint64_t seed = 0; seed < maxSeed; seed++) {
+            std::size_t placed = 0;
+
+            for (; placed < indexes.size(); placed++) {
+                std::int32_t& slot = slots[getSlot(keys[indexes[placed]], seed)];
+
+                if (slot != emptySlot) break;
+
+                slot = indexes[placed];
+            }
+
+            if (placed == indexes.size()) {
+                seeds[bucket] = seed;
+                return true;
+            }
+
+            // free the slots taken by this seed
+            for (std::size_t index = 0; index < placed; index++) {
+                slots[getSlot(keys[indexes[index]], seed)] = emptySlot;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Place all the keys again.
+     * @param size Smallest number of slots, grown until the keys fit.
+     */
+    void rebuild(std::size_t size) {
+        while (!place(size)) {
+            size *= 2;
+        }
+    }
+
+  public:
+
+    /**
+     * Default constructor.
+     * The table is empty.
+     */
+    Table() :
+        keys(), buckets(1), seeds(1, 0), slots(1, emptySlot) {}
+
+    /**
+     * Build the table.
+     * @param newKeys Keys, different from each other.
+     */
+    void build(const std::vector<Key>& newKeys) {
+        keys = newKeys;
+        rebuild(getTableSize(keys.size()));
+    }
+
+    /**
+     * Build the table with a known seed.
+     * The keys fit in one bucket, the seed is usually found at compile time
+     * with `findSeed`. The table is built as usual if the seed does not fit.
+     * @param newKeys Keys, different from each other.
+     * @param seed Seed placing the keys in their own slot.
+     */
+    void build(const std::vector<Key>& newKeys, const std::uint64_t seed) {
+        keys = newKeys;
+        buckets.assign(1, std::vector<std::int32_t>());
+        seeds.assign(1, seed);
+        slots.assign(getTableSize(keys.size()), emptySlot);
+
+        for (std::size_t index = 0; index < keys.size(); index++) {
+            std::int32_t& slot = slots[getSlot(keys[index], seed)];
+
+            if (slot != emptySlot) return rebuild(slots.size());
+
+            slot = index;
+            buckets[0].push_back(index);
+        }
+    }
+
+    /**
+     * Make room for keys.
+     * @param count Number of keys that fit without rebuilding the table.
+     */
+    void reserve(const std::size_t count) {
+        std::size_t size = getTableSize(count);
+
+        if (size > slots.size()) rebuild(size);
+
+        keys.reserve(count);
+    }
+
+    /**
+     * Insert a key.
+     * @param key Key, not in the table.
+     * @return Index of the key.
+     */
+    std::int32_t insert(const Key& key) {
+        std::int32_t index = keys.size();
+        keys.push_back(key);
+
+        if (keys.size() * 4 > slots.size()) {
+            rebuild(slots.size() * 2);
+            return index;
+        }
+
+        std::size_t bucket = getBucket(key);
+        buckets[bucket].push_back(index);
+        std::int32_t& slot = slots[getSlot(key, seeds[bucket])];
+
+        if (slot == emptySlot) {
+            slot = index;
+            return index;
+        }
+
+        // find another seed for the bucket
+        for (const std::int32_t other : buckets[bucket]) {
+            if (other != index) slots[getSlot(keys[other], seeds[bucket])] = emptySlot;
+        }
+
+        if (!placeBucket(bucket)) rebuild(slots.size());
+
+        return index;
+    }
+
+    /**
+     * Find a key.
+     * @param key Key.
+     * @return Index of the key, or `emptySlot` if not found.
+     */
+    std::int32_t find(const Key& key) const {
+        std::int32_t index = slots[getSlot(key, seeds[getBucket(key)])];
+        return index != emptySlot && keys[index] == key ? index : emptySlot;
+    }
+
+    /**
+     * Getter for size.
+     * @return Number of slots.
+     */
+    std::size_t getSize() const {
+        return slots.size();
+    }
+};
+
+/**
+ * Error class used when adding an entry with a name or an ID already used.
+ */
+struct DuplicateEntryError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Name or ID already in catalog";
+    }
+};
+
+/**
+ * Error class used when an entry is not in the catalog.
+ */
+struct EntryNotFoundError : public exceptions::TransarcticaRebirthError {
+    /**
+     * Error message.
+     * @return Error message.
+     */
+    const char* what() const throw() {
+        return "Entry not found in catalog";
+    }
+};
+
+/**
+ * Catalog of entries.
+ * Entries have a name and an ID, given by `getName` and `getId`, both unique
+ * in the catalog. Entries are never moved, references stay valid while
+ * entries are added. Adding entries is not thread-safe.
+ */
+template <typename T>
+class Catalog {
+    /**
+     * Entries.
+     */
+    std::vector<std::unique_ptr<T>> entries;
+
+    /**
+     * Table of names.
+     */
+    Table<std::string> names;
+
+    /**
+     * Table of IDs.
+     */
+    Table<types::id> ids;
+
+  public:
+
+    /**
+     * Default constructor.
+     * The catalog is empty.
+     */
+    Catalog() :
+        entries(), names(), ids() {}
+
+    /**
+     * Constructor with built-in entries.
+     * @param builtIns Entries, with unique names and IDs.
+     * @param nameSeed Seed placing the names in their own slot.
+     * @param idSeed Seed placing the IDs in their own slot.
+     */
+    Catalog(std::vector<std::unique_ptr<T>> builtIns, const std::uint64_t nameSeed,
+            const std::uint64_t idSeed) :
+        entries(std::move(builtIns)), names(), ids() {
+        std::vector<std::string> entryNames;
+        std::vector<types::id> entryIds;
+
+        for (const auto& entry : entries) {
+            entryNames.push_back(entry->getName());
+            entryIds.push_back(entry->getId());
+        }
+
+        names.build(entryNames, nameSeed);
+        ids.build(entryIds, idSeed);
+    }
+
+    /**
+     * Make room for entries.
+     * Adding many entries at once, as from a mod, then does not rebuild the
+     * tables on the way.
+     * @param count Number of entries that fit without rebuilding the tables.
+     */
+    void reserve(const std::size_t count) {
+        entries.reserve(count);
+        names.reserve(count);
+        ids.reserve(count);
+    }
+
+    /**
+     * Add an entry.
+     * @param entry Entry to add.
+     * @return Entry in the catalog.
+     * @throw DuplicateEntryError If the name or the ID is already used.
+     */
+    const T& add(std::unique_ptr<T> entry) {
+        if (findByName(entry->getName()) || findById(entry->getId())) {
+            throw DuplicateEntryError();
+        }
+
+        names.insert(entry->getName());
+        ids.insert(entry->getId());
+        entries.push_back(std::move(entry));
+        return *entries.back();
+    }
+
+    /**
+     * Create an entry and add it.
+     * @param args Arguments of the constructor of the entry.
+     * @return Entry in the catalog.
+     * @throw DuplicateEntryError If the name or the ID is already used.
+     */
+    template <typename... Args>
+    const T& emplace(Args&& ... args) {
+        return add(std::unique_ptr<T>(new T(std::forward<Args>(args)...)));
+    }
+
+    /**
+     * Find an entry by name.
+     * @param name Name of the entry.
+     * @return Entry, or null pointer if not found.
+     */
+    const T* findByName(const std::string& name) const {
+        std::int32_t index = names.find(name);
+        return index == emptySlot ? nullptr : entries[index].get();
+    }
+
+    /**
+     * Find an entry by ID.
+     * @param id ID of the entry.
+     * @return Entry, or null pointer if not found.
+     */
+    const T* findById(const types::id id) const {
+        std::int32_t index = ids.find(id);
+        return index == emptySlot ? nullptr : entries[index].get();
+    }
+
+    /**
+     * Get an entry by name.
+     * @param name Name of the entry.
+     * @return Entry.
+     * @throw EntryNotFoundError If there is no such entry.
+     */
+    const T& getByName(const std::string& name) const {
+        const T* entry = findByName(name);
+
+        if (!entry) throw EntryNotFoundError();
+
+        return *entry;
+    }
+
+    /**
+     * Get an entry by ID.
+     * @param id ID of the entry.
+     * @return Entry.
+     * @throw EntryNotFoundError If there is no such entry.
+     */
+    const T& getById(const types::id id) const {
+        const T* entry = findById(id);
+
+        if (!entry) throw EntryNotFoundError();
+
+        return *entry;
+    }
+
+    /**
+     * Get the index of an entry by ID.
+     * Indexes are dense, from 0 to the size of the catalog, and never change
+     * once the entry is added.
+     * @param id ID of the entry.
+     * @return Index of the entry, in the order of addition.
+     * @throw EntryNotFoundError If there is no such entry.
+     */
+    std::size_t getIndex(const types::id id) const {
+        std::int32_t index = ids.find(id);
+
+        if (index == emptySlot) throw EntryNotFoundError();
+
+        return index;
+    }
+
+    /**
+     * Get an entry by index.
+     * @param index Index of the entry, in the order of addition.
+     * @return Entry.
+     */
+    const T& get(const std::size_t index) const {
+        return *entries.at(index);
+    }
+
+    /**
+     * Getter for size.
+     * @return Number of entries.
+     */
+    std::size_t size() const {
+        return entries.size();
+    }
+};
+
+}
+
+#endif // ifndef CATALOG_HPP
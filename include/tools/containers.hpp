@@ -0,0 +1,359 @@
+#ifndef CONTAINERS_HPP
+#define CONTAINERS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Containers not provided by the standard library.
+ */
+namespace containers {
+
+/**
+ * Vector storing its first elements inline.
+ * Up to `N` elements are stored inside the vector itself, so that small
+ * vectors do not allocate. Larger vectors move their elements to the heap, as
+ * a standard vector does. Iterators and references are invalidated when the
+ * vector grows.
+ */
+template <typename T, std::size_t N>
+class SmallVector {
+    static_assert(N > 0, "Inline capacity must be positive");
+
+    /**
+     * Inline storage.
+     */
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer[N];
+
+    /**
+     * Elements, either in the inline storage or on the heap.
+     */
+    T* elements;
+
+    /**
+     * Number of elements.
+     */
+    std::size_t count;
+
+    /**
+     * Number of elements that fit in the storage.
+     */
+    std::size_t reserved;
+
+    /**
+     * Move the elements to a larger storage on the heap.
+     * @param minimum Number of elements the storage must hold.
+     */
+    void grow(const std::size_t minimum) {
+        std::size_t newReserved = std::max(minimum, reserved * 2);
+        T* newElements = static_cast<T*>(::operator new(newReserved * sizeof(T)));
+
+        for (std::size_t index = 0; index < count; index++) {
+            new (newElements + index) T(std::move(elements[index]));
+            elements[index].~T();
+        }
+
+        if (!isInline()) ::operator delete(elements);
+
+        elements = newElements;
+        reserved = newReserved;
+    }
+
+  public:
+
+    /**
+     * Type of elements.
+     */
+    using value_type = T;
+
+    /**
+     * Iterator.
+     */
+    using iterator = T*;
+
+    /**
+     * Constant iterator.
+     */
+    using const_iterator = const T*;
+
+    /**
+     * Default constructor.
+     */
+    SmallVector() :
+        elements(reinterpret_cast<T*>(buffer)), count(0), reserved(N) {}
+
+    /**
+     * Copy constructor.
+     * @param other Vector to copy.
+     */
+    SmallVector(const SmallVector& other) :
+        SmallVector() {
+        reserve(other.count);
+
+        for (const auto& element : other) {
+            push_back(element);
+        }
+    }
+
+    /**
+     * Move constructor.
+     * Heap storage is taken over, inline elements are moved one by one.
+     * @param other Vector to move.
+     */
+    SmallVector(SmallVector&& other) :
+        SmallVector() {
+        if (other.isInline()) {
+            for (auto& element : other) {
+                push_back(std::move(element));
+            }
+
+            other.clear();
+            return;
+        }
+
+        elements = other.elements;
+        count = other.count;
+        reserved = other.reserved;
+        other.elements = reinterpret_cast<T*>(other.buffer);
+        other.count = 0;
+        other.reserved = N;
+    }
+
+    /**
+     * Destructor.
+     */
+    ~SmallVector() {
+        clear();
+
+        if (!isInline()) ::operator delete(elements);
+    }
+
+    /**
+     * Copy and move assignment operator.
+     * @param other Vector to assign.
+     * @return The vector itself.
+     */
+    SmallVector& operator=(SmallVector other) {
+        clear();
+
+        for (auto& element : other) {
+            push_back(std::move(element));
+        }
+
+        return *this;
+    }
+
+    /**
+     * Getter for size.
+     * @return Number of elements.
+     */
+    std::size_t size() const {
+        return count;
+    }
+
+    /**
+     * Tell if the vector is empty.
+     * @return True if the vector has no elements.
+     */
+    bool empty() const {
+        return !count;
+    }
+
+    /**
+     * Getter for capacity.
+     * @return Number of elements that fit without allocating.
+     */
+    std::size_t capacity() const {
+        return reserved;
+    }
+
+    /**
+     * Tell if the elements are stored inline.
+     * @return True if the vector did not allocate.
+     */
+    bool isInline() const {
+        return elements == reinterpret_cast<const T*>(buffer);
+    }
+
+    /**
+     * Getter for heap usage.
+     * @return Memory allocated on the heap, in bytes.
+     */
+    std::size_t getHeapUsage() const {
+        return isInline() ? 0 : reserved * sizeof(T);
+    }
+
+    /**
+     * Getter for data.
+     * @return Pointer to the first element.
+     */
+    T* data() {
+        return elements;
+    }
+
+    /**
+     * Getter for data, read-only.
+     * @return Pointer to the first element.
+     */
+    const T* data() const {
+        return elements;
+    }
+
+    /**
+     * Iterator to the first element.
+     * @return Iterator.
+     */
+    iterator begin() {
+        return elements;
+    }
+
+    /**
+     * Iterator past the last element.
+     * @return Iterator.
+     */
+    iterator end() {
+        return elements + count;
+    }
+
+    /**
+     * Constant iterator to the first element.
+     * @return Iterator.
+     */
+    const_iterator begin() const {
+        return elements;
+    }
+
+    /**
+     * Constant iterator past the last element.
+     * @return Iterator.
+     */
+    const_iterator end() const {
+        return elements + count;
+    }
+
+    /**
+     * Access an element.
+     * @param index Index of the element.
+     * @return Element.
+     */
+    T& operator[](const std::size_t index) {
+        return elements[index];
+    }
+
+    /**
+     * Access an element, read-only.
+     * @param index Index of the element.
+     * @return Element.
+     */
+    const T& operator[](const std::size_t index) const {
+        return elements[index];
+    }
+
+    /**
+     * Access the last element.
+     * @return Last element.
+     */
+    T& back() {
+        return elements[count - 1];
+    }
+
+    /**
+     * Access the last element, read-only.
+     * @return Last element.
+     */
+    const T& back() const {
+        return elements[count - 1];
+    }
+
+    /**
+     * Make room for elements.
+     * @param minimum Number of elements that must fit without allocating.
+     */
+    void reserve(const std::size_t minimum) {
+        if (minimum > reserved) grow(minimum);
+    }
+
+    /**
+     * Create an element at the end.
+     * @param args Arguments of the constructor of the element.
+     * @return New element.
+     */
+    template <typename... Args>
+    T& emplace_back(Args&& ... args) {
+        if (count < reserved) {
+            new (elements + count) T(std::forward<Args>(args)...);
+        } else {
+            // the arguments may refer to elements that are about to move
+            T element(std::forward<Args>(args)...);
+            grow(count + 1);
+            new (elements + count) T(std::move(element));
+        }
+
+        return elements[count++];
+    }
+
+    /**
+     * Add an element at the end.
+     * @param element Element to copy.
+     */
+    void push_back(const T& element) {
+        emplace_back(element);
+    }
+
+    /**
+     * Add an element at the end.
+     * @param element Element to move.
+     */
+    void push_back(T&& element) {
+        emplace_back(std::move(element));
+    }
+
+    /**
+     * Remove the last element.
+     */
+    void pop_back() {
+        elements[--count].~T();
+    }
+
+    /**
+     * Insert an element.
+     * @param position Position to insert at.
+     * @param element Element to copy.
+     * @return Iterator to the new element.
+     */
+    iterator insert(const_iterator position, const T& element) {
+        std::size_t index = position - begin();
+        emplace_back(element);
+        std::rotate(begin() + index, end() - 1, end());
+        return begin() + index;
+    }
+
+    /**
+     * Remove an element.
+     * @param position Position of the element.
+     * @return Iterator to the next element.
+     */
+    iterator erase(const_iterator position) {
+        iterator removed = begin() + (position - begin());
+        std::move(removed + 1, end(), removed);
+        pop_back();
+        return removed;
+    }
+
+    /**
+     * Remove all the elements.
+     * The storage is kept.
+     */
+    void clear() {
+        while (count) {
+            pop_back();
+        }
+    }
+};
+
+}
+
+#endif // ifndef CONTAINERS_HPP
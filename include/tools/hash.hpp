@@ -0,0 +1,92 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Deterministic hashing.
+ * Hashes only depend on the values hashed, never on addresses or on the
+ * platform, so that they can be compared between machines and runs. Hash
+ * functions are usable at compile time.
+ */
+namespace hash {
+
+/**
+ * Prime of the FNV-1a hash of texts.
+ */
+const std::uint64_t textPrime = 0x100000001b3;
+
+/**
+ * Shift the bits of a value and combine them with the value.
+ * @param value Value to shift.
+ * @param shift Number of bits to shift.
+ * @return Combined value.
+ */
+constexpr std::uint64_t xorShift(const std::uint64_t value, const unsigned int shift) {
+    return value ^ (value >> shift);
+}
+
+/**
+ * Mix the bits of a value.
+ * Uses the finalizer of SplitMix64.
+ * @param value Value to mix.
+ * @return Mixed value.
+ */
+constexpr std::uint64_t mix(const std::uint64_t value) {
+    return xorShift(xorShift(xorShift(value + 0x9e3779b97f4a7c15, 30) * 0xbf58476d1ce4e5b9, 27) *
+                    0x94d049bb133111eb, 31);
+}
+
+/**
+ * Combine a value with a hash.
+ * The combination depends on the order of the values.
+ * @param seed Hash to combine with.
+ * @param value Value to add.
+ * @return Combined hash.
+ */
+constexpr std::uint64_t combine(const std::uint64_t seed, const std::uint64_t value) {
+    return mix(seed ^ mix(value));
+}
+
+/**
+ * Hash the rest of a text.
+ * @param text Rest of the text, null-terminated.
+ * @param state Hash of the start of the text.
+ * @return Hash of the text.
+ */
+constexpr std::uint64_t hashText(const char* text, const std::uint64_t state) {
+    return *text ? hashText(text + 1, (state ^ static_cast<unsigned char>(*text)) * textPrime) :
+           mix(state);
+}
+
+/**
+ * Hash a text.
+ * @param text Text to hash, null-terminated.
+ * @param seed Seed of the hash.
+ * @return Hash of the text.
+ */
+constexpr std::uint64_t hashString(const char* text, const std::uint64_t seed) {
+    return hashText(text, mix(seed));
+}
+
+/**
+ * Hash a text.
+ * Gives the same result as for the equivalent null-terminated text.
+ * @param text Text to hash.
+ * @param seed Seed of the hash.
+ * @return Hash of the text.
+ */
+inline std::uint64_t hashString(const std::string& text, const std::uint64_t seed) {
+    std::uint64_t state = mix(seed);
+
+    for (const char character : text) {
+        state = (state ^ static_cast<unsigned char>(character)) * textPrime;
+    }
+
+    return mix(state);
+}
+
+}
+
+#endif // ifndef HASH_HPP
@@ -0,0 +1,155 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * Lightweight tracing of hot paths.
+ * Trace points are placed with the `TRACE_SCOPE` macro, which records the
+ * duration of the enclosing scope. Trace points are compiled out unless the
+ * `TRACING` macro is defined (see the `TRACING` CMake option).
+ *
+ * Each thread records its events in its own buffer, without locking. Events
+ * can then be exported as a Chrome trace-event JSON file, to be opened with
+ * `chrome://tracing` or Perfetto.
+ */
+namespace trace {
+
+/**
+ * Clock used for timing events.
+ */
+using clock = std::chrono::steady_clock;
+
+/**
+ * Number of bins of the latency histograms.
+ * Bin `i` counts the events lasting less than 2^i nanoseconds.
+ */
+const std::size_t histogramSize = 32;
+
+/**
+ * Event recorded by a trace point.
+ */
+struct Event {
+    /**
+     * Name of the trace point.
+     * It must be a string literal.
+     */
+    const char* name;
+
+    /**
+     * Start of the event, in nanoseconds since the start of the program.
+     */
+    std::uint64_t start;
+
+    /**
+     * Duration of the event, in nanoseconds.
+     */
+    std::uint64_t duration;
+};
+
+/**
+ * Statistics of a trace point.
+ */
+struct Statistics {
+    /**
+     * Number of calls.
+     */
+    std::uint64_t count;
+
+    /**
+     * Total duration of the calls, in nanoseconds.
+     */
+    std::uint64_t total;
+
+    /**
+     * Latency histogram.
+     */
+    std::array<std::uint64_t, histogramSize> histogram;
+};
+
+/**
+ * Get the current time.
+ * @return Nanoseconds since the start of the program.
+ */
+std::uint64_t now();
+
+/**
+ * Record an event in the buffer of the current thread.
+ * @param event Event to record.
+ */
+void record(const Event& event);
+
+/**
+ * Discard all the recorded events.
+ * Traced threads must be idle during the call.
+ */
+void clear();
+
+/**
+ * Compute statistics of the recorded events.
+ * Traced threads must be idle during the call.
+ * @return Statistics per trace point name.
+ */
+std::map<std::string, Statistics> computeStatistics();
+
+/**
+ * Export the recorded events as Chrome trace-event JSON.
+ * Statistics of each trace point are exported in the `statistics` key.
+ * Traced threads must be idle during the call.
+ * @param stream Stream to write to.
+ */
+void exportChromeTrace(std::ostream& stream);
+
+/**
+ * Trace point recording the duration of a scope.
+ */
+class Scope {
+    /**
+     * Name of the trace point.
+     */
+    const char* name;
+
+    /**
+     * Start of the scope.
+     */
+    std::uint64_t start;
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param name Name of the trace point. It must be a string literal.
+     */
+    explicit Scope(const char* name) :
+        name(name), start(now()) {}
+
+    /**
+     * Destructor.
+     * Record the event.
+     */
+    ~Scope() {
+        record({name, start, now() - start});
+    }
+};
+
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#ifdef TRACING
+/**
+ * Trace the enclosing scope.
+ * @param name Name of the trace point, as a string literal.
+ */
+#define TRACE_SCOPE(name) ::trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) do {} while (false)
+#endif
+
+#endif // ifndef TRACE_HPP
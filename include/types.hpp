@@ -1,6 +1,8 @@
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
+#include <cstdint>
+
 /**
  * Types used in the project.
  * These types are gathered here and help to understand the signature of
@@ -18,6 +20,13 @@ using id = unsigned int;
  */
 using price = unsigned short int;
 
+/**
+ * Amount of money.
+ * Expressed in fixed point, in ten-thousandths of a price unit, so that sums
+ * and averages of prices over large quantities stay exact.
+ */
+using money = std::int64_t;
+
 /**
  * Quantity.
  */
@@ -33,6 +42,42 @@ using health = short int;
  */
 using weight = float;
 
+/**
+ * Speed.
+ * Expressed in km/h.
+ */
+using speed = float;
+
+/**
+ * Power.
+ * Expressed in kW.
+ */
+using power = float;
+
+/**
+ * Distance.
+ * Expressed in km.
+ */
+using distance = float;
+
+/**
+ * Coordinate on the map.
+ * Expressed in km.
+ */
+using coordinate = float;
+
+/**
+ * Duration.
+ * Expressed in hours of game time.
+ */
+using duration = float;
+
+/**
+ * Temperature.
+ * Expressed in degrees Celsius.
+ */
+using temperature = float;
+
 }
 
 #endif // ifndef TYPES_HPP
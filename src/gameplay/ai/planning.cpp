@@ -0,0 +1,254 @@
+#include <algorithm>
+
+#include "gameplay/ai/planning.hpp"
+#include "gameplay/train/catalogs.hpp"
+#include "gameplay/train/transaction.hpp"
+#include "tools/trace.hpp"
+
+ai::Snapshot ai::takeSnapshot(const train::Train& train) {
+    TRACE_SCOPE("takeSnapshot");
+
+    Snapshot snapshot = {train.getHash(), {}};
+    snapshot.cars.reserve(train.getSize());
+
+    for (std::size_t position = 0; position < train.getSize(); position++) {
+        const cars::Car& car = train.get(train.getHandleAt(position));
+        CarSnapshot carSnapshot = {car.getCarId(), car.getWeight(), car.isDestroyed(), false,
+                                   merchandises::nullMerchType, 0, 0, 0, 0
+                                  };
+        auto loadCar = dynamic_cast<const cars::LoadCar*>(&car);
+
+        if (loadCar) carSnapshot.isLoadCar = true;
+
+        // destroyed cars hold nothing
+        if (loadCar && !car.isDestroyed()) {
+            carSnapshot.merchType = loadCar->getMerchType();
+            carSnapshot.quantity = loadCar->getQuantity();
+            carSnapshot.maxQuantity = loadCar->getMaxQuantity();
+
+            if (!loadCar->isEmpty()) {
+                carSnapshot.merch = loadCar->getMerchLoad()->getMerch().getId();
+                carSnapshot.price = loadCar->getMerchLoad()->getPrice();
+            }
+        }
+
+        snapshot.cars.push_back(carSnapshot);
+    }
+
+    return snapshot;
+}
+
+ai::JobSystem::JobSystem(const std::size_t threadCount) :
+    mutex(), jobQueued(), jobCompleted(), jobs(), completed(), runningCount(0),
+    isStopping(false), tracked(), submittedCount(0), workers() {
+    std::size_t workerCount = threadCount ? threadCount : std::thread::hardware_concurrency();
+    workerCount = std::max<std::size_t>(1, workerCount);
+
+    for (std::size_t worker = 0; worker < workerCount; worker++) {
+        workers.emplace_back(&JobSystem::work, this);
+    }
+}
+
+ai::JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+        jobs.clear();
+    }
+
+    jobQueued.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ai::JobSystem::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        jobQueued.wait(lock, [this]() {
+            return isStopping || !jobs.empty();
+        });
+
+        if (isStopping) return;
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        runningCount++;
+        lock.unlock();
+
+        // jobs cancelled while queued are not planned
+        if (!*job.isCancelled) {
+            TRACE_SCOPE("JobSystem::plan");
+
+            try {
+                job.actions = job.planner->plan(job.snapshot, *job.isCancelled);
+            } catch (...) {
+                job.isFailed = true;
+            }
+        }
+
+        lock.lock();
+        runningCount--;
+        completed.push_back(std::move(job));
+        jobCompleted.notify_all();
+    }
+}
+
+void ai::JobSystem::apply(const Job& job) {
+    TRACE_SCOPE("JobSystem::apply");
+
+    train::Train& train = *job.train;
+    station::Warehouse& warehouse = *job.warehouse;
+    const catalogs::MerchCatalog& merchs = catalogs::getMerchs();
+
+    // moves are applied after the loads, so they are checked first
+    for (const auto& action : job.actions) {
+        if (action.type != ActionType::moveCar) continue;
+
+        if (action.position >= train.getSize()) throw InvalidActionError();
+
+        train.getHandle(action.carId);
+    }
+
+    // loads keep their address while the transaction refers to them
+    std::vector<merchandises::MerchLoad> merchLoads;
+    merchLoads.reserve(job.actions.size());
+    train::Transaction transaction(train);
+
+    try {
+        for (const auto& action : job.actions) {
+            switch (action.type) {
+                case ActionType::load:
+                    merchLoads.push_back(warehouse.take(merchs.getById(action.merch),
+                                                        action.quantity));
+                    transaction.load(action.carId, merchLoads.back(), action.quantity);
+                    break;
+
+                case ActionType::unLoad: {
+                    auto car = dynamic_cast<const cars::LoadCar*>(
+                                   &train.get(train.getHandle(action.carId)));
+
+                    if (!car || car->isEmpty()) throw InvalidActionError();
+
+                    const auto& merch = merchs.getById(car->getMerchLoad()->getMerch().getId());
+                    merchLoads.emplace_back(merch, 0, 0);
+                    transaction.unLoad(action.carId, merchLoads.back(), action.quantity);
+                    break;
+                }
+
+                case ActionType::moveCar:
+                    break;
+            }
+        }
+
+        transaction.commit();
+    } catch (...) {
+        // give back what was taken from the warehouse
+        for (const auto& merchLoad : merchLoads) {
+            warehouse.store(merchLoad);
+        }
+
+        throw;
+    }
+
+    // store what was unloaded, loads taken from the warehouse are now empty
+    for (const auto& merchLoad : merchLoads) {
+        warehouse.store(merchLoad);
+    }
+
+    for (const auto& action : job.actions) {
+        if (action.type == ActionType::moveCar) train.moveCar(action.carId, action.position);
+    }
+}
+
+void ai::JobSystem::submit(train::Train& train, station::Warehouse& warehouse,
+                           std::shared_ptr<const Planner> planner) {
+    cancel(train);
+
+    auto isCancelled = std::make_shared<std::atomic<bool>>(false);
+    Snapshot snapshot = takeSnapshot(train);
+    tracked[&train] = {snapshot.hash, isCancelled};
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({submittedCount++, &train, &warehouse, std::move(snapshot),
+                        std::move(planner), isCancelled, {}, false
+                       });
+    }
+
+    jobQueued.notify_one();
+}
+
+bool ai::JobSystem::cancel(const train::Train& train) {
+    auto it = tracked.find(&train);
+
+    if (it == tracked.end()) return false;
+
+    *it->second.isCancelled = true;
+    tracked.erase(it);
+    return true;
+}
+
+bool ai::JobSystem::hasJob(const train::Train& train) const {
+    return tracked.count(&train);
+}
+
+ai::Report ai::JobSystem::update() {
+    TRACE_SCOPE("JobSystem::update");
+
+    // cancel the jobs of trains that changed since their snapshot
+    for (auto it = tracked.begin(); it != tracked.end();) {
+        if (it->first->getHash() == it->second.hash) {
+            it++;
+            continue;
+        }
+
+        *it->second.isCancelled = true;
+        it = tracked.erase(it);
+    }
+
+    std::vector<Job> done;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.swap(completed);
+    }
+
+    std::sort(done.begin(), done.end(), [](const Job & first, const Job & second) {
+        return first.sequence < second.sequence;
+    });
+
+    Report report = {0, 0, 0};
+
+    for (const auto& job : done) {
+        if (*job.isCancelled) {
+            report.stale++;
+            continue;
+        }
+
+        tracked.erase(job.train);
+
+        if (job.isFailed) {
+            report.failed++;
+            continue;
+        }
+
+        try {
+            apply(job);
+            report.applied++;
+        } catch (const exceptions::TransarcticaRebirthError&) {
+            report.failed++;
+        }
+    }
+
+    return report;
+}
+
+void ai::JobSystem::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    jobCompleted.wait(lock, [this]() {
+        return jobs.empty() && !runningCount;
+    });
+}
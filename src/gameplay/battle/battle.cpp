@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "gameplay/battle/battle.hpp"
+#include "tools/trace.hpp"
+
+/**
+ * Outcomes of a batch of engagements.
+ * Tallies are gathered in batch order, so that sums do not depend on threads.
+ */
+struct battle::Simulator::Tally {
+    /**
+     * Number of victories.
+     */
+    std::uint64_t wins;
+
+    /**
+     * Number of defeats.
+     */
+    std::uint64_t losses;
+
+    /**
+     * Number of draws.
+     */
+    std::uint64_t draws;
+
+    /**
+     * Number of cars destroyed, for the train and for the enemy.
+     */
+    std::uint64_t cars[2];
+
+    /**
+     * Quantity of cargo lost, for the train and for the enemy.
+     */
+    std::uint64_t cargos[2];
+
+    /**
+     * Value of the cargo lost, for the train and for the enemy.
+     */
+    double values[2];
+};
+
+/**
+ * Working memory of an engagement.
+ * It is reused from one engagement to the other, to avoid allocations.
+ */
+struct battle::Simulator::Fight {
+    /**
+     * Health points of the cars of each side.
+     */
+    std::vector<int> healths[2];
+
+    /**
+     * Indexes of the cars standing, for each side.
+     */
+    std::vector<std::uint32_t> standing[2];
+};
+
+namespace {
+
+/**
+ * Remove the destroyed cars from the standing ones.
+ * @param healths Health points of the cars.
+ * @param standing Indexes of the cars standing.
+ * @param locomotives Tell if each car is a locomotive.
+ * @return Number of locomotives still standing.
+ */
+std::size_t removeDestroyed(const std::vector<int>& healths,
+                            std::vector<std::uint32_t>& standing,
+                            const std::vector<bool>& locomotives) {
+    std::size_t locomotiveCount = 0;
+    std::size_t count = 0;
+
+    for (const auto index : standing) {
+        if (healths[index] <= 0) continue;
+
+        standing[count++] = index;
+        locomotiveCount += locomotives[index];
+    }
+
+    standing.resize(count);
+    return locomotiveCount;
+}
+
+}
+
+battle::Simulator::Simulator(const train::Train& train, const train::Train& enemy,
+                             const Rules& rules) :
+    rules(rules), side(copy(train)), enemy(copy(enemy)) {
+    if (rules.minAttack <= 0 || rules.minAttack > rules.maxAttack) throw InvalidRulesError();
+}
+
+battle::Simulator::Side battle::Simulator::copy(const train::Train& train) {
+    Side side = {{}, {}, {}, {}, 0};
+
+    for (std::size_t position = 0; position < train.getSize(); position++) {
+        const cars::Car& car = train.get(train.getHandleAt(position));
+        auto loadCar = dynamic_cast<const cars::LoadCar*>(&car);
+        bool isLocomotive = dynamic_cast<const cars::Locomotive*>(&car) != nullptr;
+        bool isLoaded = loadCar && !loadCar->isDestroyed() && !loadCar->isEmpty();
+        types::quantity cargo = isLoaded ? loadCar->getQuantity() : 0;
+
+        side.healths.push_back(car.getHealth());
+        side.locomotives.push_back(isLocomotive);
+        side.cargos.push_back(cargo);
+        side.values.push_back(cargo ? static_cast<float>(loadCar->getMerchLoad()->getValue()) /
+                              merchandises::moneyScale : 0);
+        side.locomotiveCount += isLocomotive && !car.isDestroyed();
+    }
+
+    return side;
+}
+
+battle::Simulator::Tally battle::Simulator::simulate(const std::uint32_t seed,
+        const std::size_t batch, const std::size_t count, Fight& fight) const {
+    const Side* sides[] = {&side, &enemy};
+    Tally tally = {0, 0, 0, {0, 0}, {0, 0}, {0, 0}};
+
+    // each batch has its own stream
+    std::seed_seq sequence = {seed, static_cast<std::uint32_t>(batch)};
+    std::mt19937 generator(sequence);
+    std::uniform_int_distribution<int> attack(rules.minAttack, rules.maxAttack);
+
+    for (std::size_t engagement = 0; engagement < count; engagement++) {
+        bool defeated[2];
+
+        // set up the trains
+        for (std::size_t team = 0; team < 2; team++) {
+            const std::vector<types::health>& healths = sides[team]->healths;
+            fight.healths[team].assign(healths.begin(), healths.end());
+            fight.standing[team].resize(healths.size());
+
+            for (std::uint32_t index = 0; index < healths.size(); index++) {
+                fight.standing[team][index] = index;
+            }
+
+            std::size_t locomotiveCount = removeDestroyed(fight.healths[team],
+                                          fight.standing[team],
+                                          sides[team]->locomotives);
+            defeated[team] = fight.standing[team].empty() ||
+                             (sides[team]->locomotiveCount && !locomotiveCount);
+        }
+
+        // fight until a train is defeated
+        for (unsigned int round = 0; round < rules.maxRounds && !defeated[0] && !defeated[1];
+                round++) {
+            // both trains shoot at the same time
+            for (std::size_t team = 0; team < 2; team++) {
+                std::vector<std::uint32_t>& targets = fight.standing[1 - team];
+                std::uniform_int_distribution<std::size_t> target(0, targets.size() - 1);
+
+                for (std::size_t shot = 0; shot < fight.standing[team].size(); shot++) {
+                    fight.healths[1 - team][targets[target(generator)]] -= attack(generator);
+                }
+            }
+
+            for (std::size_t team = 0; team < 2; team++) {
+                std::size_t locomotiveCount = removeDestroyed(fight.healths[team],
+                                              fight.standing[team],
+                                              sides[team]->locomotives);
+                defeated[team] = fight.standing[team].empty() ||
+                                 (sides[team]->locomotiveCount && !locomotiveCount);
+            }
+        }
+
+        if (defeated[0] == defeated[1]) tally.draws++;
+        else if (defeated[1]) tally.wins++;
+        else tally.losses++;
+
+        // count the cars destroyed during the battle
+        for (std::size_t team = 0; team < 2; team++) {
+            for (std::size_t index = 0; index < sides[team]->healths.size(); index++) {
+                if (sides[team]->healths[index] <= 0 || fight.healths[team][index] > 0) continue;
+
+                tally.cars[team]++;
+                tally.cargos[team] += sides[team]->cargos[index];
+                tally.values[team] += sides[team]->values[index];
+            }
+        }
+    }
+
+    return tally;
+}
+
+battle::Odds battle::Simulator::predict(const std::size_t count, const std::uint32_t seed,
+                                        const std::size_t threadCount) const {
+    TRACE_SCOPE("Simulator::predict");
+
+    if (!count) throw NoEngagementError();
+
+    std::size_t batchCount = (count + batchSize - 1) / batchSize;
+    std::vector<Tally> tallies(batchCount);
+    std::atomic<std::size_t> nextBatch(0);
+
+    // threads take the next batch until all are done
+    auto work = [&]() {
+        Fight fight;
+
+        for (std::size_t batch = nextBatch++; batch < batchCount; batch = nextBatch++) {
+            std::size_t engagementCount = std::min(batchSize, count - batch * batchSize);
+            tallies[batch] = simulate(seed, batch, engagementCount, fight);
+        }
+    };
+
+    std::size_t workerCount = threadCount ? threadCount : std::thread::hardware_concurrency();
+    workerCount = std::max<std::size_t>(1, std::min(workerCount, batchCount));
+    std::vector<std::thread> workers;
+
+    // the current thread works too
+    for (std::size_t worker = 1; worker < workerCount; worker++) {
+        workers.emplace_back(work);
+    }
+
+    work();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // gather batches in order
+    Tally total = {0, 0, 0, {0, 0}, {0, 0}, {0, 0}};
+
+    for (const auto& tally : tallies) {
+        total.wins += tally.wins;
+        total.losses += tally.losses;
+        total.draws += tally.draws;
+
+        for (std::size_t team = 0; team < 2; team++) {
+            total.cars[team] += tally.cars[team];
+            total.cargos[team] += tally.cargos[team];
+            total.values[team] += tally.values[team];
+        }
+    }
+
+    float scale = 1.f / count;
+    Losses losses[2];
+
+    for (std::size_t team = 0; team < 2; team++) {
+        losses[team] = {total.cars[team] * scale, total.cargos[team] * scale,
+                        static_cast<float>(total.values[team] * scale)
+                       };
+    }
+
+    return {total.wins * scale, total.losses * scale, total.draws * scale, losses[0], losses[1]};
+}
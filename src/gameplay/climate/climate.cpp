@@ -0,0 +1,254 @@
+#include <algorithm>
+
+#include "gameplay/climate/climate.hpp"
+#include "tools/trace.hpp"
+
+void climate::Climate::Rows::resize(const std::size_t size) {
+    carIds.resize(size);
+    loadCars.resize(size);
+    temperatures.resize(size);
+    conductances.resize(size);
+    thresholds.resize(size);
+    lossRates.resize(size);
+    losses.resize(size);
+}
+
+void climate::Climate::Rows::copy(const Rows& other, const std::size_t from,
+                                  const std::size_t to, const std::size_t count) {
+    std::copy_n(other.carIds.begin() + from, count, carIds.begin() + to);
+    std::copy_n(other.loadCars.begin() + from, count, loadCars.begin() + to);
+    std::copy_n(other.temperatures.begin() + from, count, temperatures.begin() + to);
+    std::copy_n(other.conductances.begin() + from, count, conductances.begin() + to);
+    std::copy_n(other.thresholds.begin() + from, count, thresholds.begin() + to);
+    std::copy_n(other.lossRates.begin() + from, count, lossRates.begin() + to);
+    std::copy_n(other.losses.begin() + from, count, losses.begin() + to);
+}
+
+void climate::Climate::Rows::erase(const std::size_t first, const std::size_t count) {
+    carIds.erase(carIds.begin() + first, carIds.begin() + first + count);
+    loadCars.erase(loadCars.begin() + first, loadCars.begin() + first + count);
+    temperatures.erase(temperatures.begin() + first, temperatures.begin() + first + count);
+    conductances.erase(conductances.begin() + first, conductances.begin() + first + count);
+    thresholds.erase(thresholds.begin() + first, thresholds.begin() + first + count);
+    lossRates.erase(lossRates.begin() + first, lossRates.begin() + first + count);
+    losses.erase(losses.begin() + first, losses.begin() + first + count);
+}
+
+climate::Climate::Climate() :
+    trains(), indexes(), rows() {}
+
+void climate::Climate::read(const Tracked& before, const Tracked& after, const Rows& old,
+                            Rows& target) {
+    // keep the previous values aside, as both arrays can be the same
+    auto oldFirst = old.carIds.begin() + before.first;
+    std::vector<types::id> carIds(oldFirst, oldFirst + before.count);
+    std::vector<types::temperature> temperatures(
+        old.temperatures.begin() + before.first,
+        old.temperatures.begin() + before.first + before.count);
+    std::vector<float> losses(old.losses.begin() + before.first,
+                              old.losses.begin() + before.first + before.count);
+
+    const train::Train& train = *after.train;
+
+    for (std::size_t position = 0; position < after.count; position++) {
+        cars::Car& car = train.get(train.getHandleAt(position));
+        std::size_t index = after.first + position;
+        target.carIds[index] = car.getCarId();
+        target.conductances[index] = 1 / car.getInsulation();
+
+        // only the loads of living vegetals and drinkable liquids suffer
+        auto loadCar = dynamic_cast<cars::LoadCar*>(&car);
+        types::temperature threshold = 0;
+        float lossRate = 0;
+
+        if (loadCar && !loadCar->isDestroyed()) {
+            switch (loadCar->getMerchType()) {
+                case merchandises::MerchTypes::drinkable:
+                    threshold = freezingPoint;
+                    lossRate = freezingLoss * loadCar->getQuantity();
+                    break;
+
+                case merchandises::MerchTypes::vegetal:
+                    threshold = chillingPoint;
+                    lossRate = chillingLoss * loadCar->getQuantity();
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        target.loadCars[index] = lossRate > 0 ? loadCar : nullptr;
+        target.thresholds[index] = threshold;
+        target.lossRates[index] = lossRate;
+
+        // cars new to the train start at the initial temperature
+        auto it = std::find(carIds.begin(), carIds.end(), car.getCarId());
+
+        if (it == carIds.end()) {
+            target.temperatures[index] = initialTemperature;
+            target.losses[index] = 0;
+            continue;
+        }
+
+        target.temperatures[index] = temperatures[it - carIds.begin()];
+        target.losses[index] = lossRate > 0 ? losses[it - carIds.begin()] : 0;
+    }
+}
+
+void climate::Climate::refresh() {
+    TRACE_SCOPE("Climate::refresh");
+
+    // trains keeping their number of cars are read in place
+    bool isResized = false;
+
+    for (auto& tracked : trains) {
+        std::uint64_t hash = tracked.train->getHash();
+
+        if (hash == tracked.hash) continue;
+
+        if (tracked.train->getSize() != tracked.count) {
+            isResized = true;
+            continue;
+        }
+
+        Tracked after = {tracked.train, hash, tracked.first, tracked.count};
+        read(tracked, after, rows, rows);
+        tracked = after;
+    }
+
+    if (!isResized) return;
+
+    // otherwise, lay out the arrays again
+    std::size_t size = 0;
+
+    for (const auto& tracked : trains) {
+        size += tracked.train->getSize();
+    }
+
+    Rows laid;
+    laid.resize(size);
+    std::size_t first = 0;
+
+    for (auto& tracked : trains) {
+        Tracked after = {tracked.train, tracked.train->getHash(), first,
+                         tracked.train->getSize()
+                        };
+
+        if (after.hash == tracked.hash) {
+            laid.copy(rows, tracked.first, first, tracked.count);
+        } else {
+            read(tracked, after, rows, laid);
+        }
+
+        tracked = after;
+        first += after.count;
+    }
+
+    rows = std::move(laid);
+}
+
+types::quantity climate::Climate::spoil() {
+    TRACE_SCOPE("Climate::spoil");
+
+    types::quantity spoiled = 0;
+
+    for (std::size_t index = 0; index < rows.losses.size(); index++) {
+        if (rows.losses[index] < 1) continue;
+
+        cars::LoadCar& car = *rows.loadCars[index];
+        types::quantity quantity = std::min<types::quantity>(rows.losses[index],
+                                   car.getQuantity());
+        rows.losses[index] = quantity < car.getQuantity() ? rows.losses[index] - quantity : 0;
+
+        if (quantity) car.unLoad(quantity);
+
+        spoiled += quantity;
+    }
+
+    return spoiled;
+}
+
+bool climate::Climate::track(train::Train& train) {
+    if (indexes.count(&train)) return false;
+
+    Tracked before = {&train, 0, rows.carIds.size(), 0};
+    Tracked after = {&train, train.getHash(), rows.carIds.size(), train.getSize()};
+    rows.resize(after.first + after.count);
+    read(before, after, rows, rows);
+    indexes[&train] = trains.size();
+    trains.push_back(after);
+    return true;
+}
+
+bool climate::Climate::untrack(const train::Train& train) {
+    auto it = indexes.find(&train);
+
+    if (it == indexes.end()) return false;
+
+    std::size_t index = it->second;
+    Tracked tracked = trains[index];
+    rows.erase(tracked.first, tracked.count);
+    trains.erase(trains.begin() + index);
+    indexes.erase(it);
+
+    // the following trains move back in the arrays
+    for (std::size_t other = index; other < trains.size(); other++) {
+        trains[other].first -= tracked.count;
+        indexes[trains[other].train] = other;
+    }
+
+    return true;
+}
+
+bool climate::Climate::isTracked(const train::Train& train) const {
+    return indexes.count(&train);
+}
+
+std::size_t climate::Climate::getCarCount() const {
+    return rows.carIds.size();
+}
+
+types::temperature climate::Climate::getTemperature(const train::Train& train,
+        const types::id carId) const {
+    auto it = indexes.find(&train);
+
+    if (it == indexes.end()) throw UntrackedTrainError();
+
+    const Tracked& tracked = trains[it->second];
+
+    for (std::size_t index = tracked.first; index < tracked.first + tracked.count; index++) {
+        if (rows.carIds[index] == carId) return rows.temperatures[index];
+    }
+
+    throw train::CarNotFoundError();
+}
+
+types::quantity climate::Climate::tick(const types::temperature outside,
+                                       const types::duration duration) {
+    TRACE_SCOPE("Climate::tick");
+
+    refresh();
+
+    std::size_t count = rows.carIds.size();
+    types::temperature* temperatures = rows.temperatures.data();
+    const float* conductances = rows.conductances.data();
+    const types::temperature* thresholds = rows.thresholds.data();
+    const float* lossRates = rows.lossRates.data();
+    float* losses = rows.losses.data();
+    std::size_t spoiledCount = 0;
+
+    // no branch, so that the loop is vectorized
+    for (std::size_t index = 0; index < count; index++) {
+        float rate = std::min(conductances[index] * duration, 1.f);
+        temperatures[index] += (outside - temperatures[index]) * rate;
+        float cold = std::max(thresholds[index] - temperatures[index], 0.f);
+        losses[index] += cold * duration * lossRates[index];
+        spoiledCount += losses[index] >= 1;
+    }
+
+    // cars are only touched when a whole unit is lost
+    if (!spoiledCount) return 0;
+
+    return spoil();
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cmath>
+
+#include "gameplay/network/grid.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Tell if two points are close.
+ * @param first First point.
+ * @param second Second point.
+ * @param radius Highest distance between the points.
+ * @return True if the points are close.
+ */
+bool isNear(const network::Point first, const network::Point second,
+            const types::distance radius) {
+    types::coordinate x = first.x - second.x;
+    types::coordinate y = first.y - second.y;
+    return x * x + y * y <= radius * radius;
+}
+
+/**
+ * Make a pair of indexes, the lowest first.
+ * @param first First index.
+ * @param second Second index.
+ * @return Ordered pair.
+ */
+std::pair<std::uint32_t, std::uint32_t> makePair(const std::uint32_t first,
+        const std::uint32_t second) {
+    return first < second ? std::make_pair(first, second) : std::make_pair(second, first);
+}
+
+}
+
+network::Grid::Grid(const types::distance cellSize) :
+    cellSize(cellSize), entries(), cells(), size(0) {
+    if (!(cellSize > 0)) throw InvalidCellSizeError();
+}
+
+std::pair<std::int32_t, std::int32_t> network::Grid::getCell(const Point point) const {
+    return std::make_pair(static_cast<std::int32_t>(std::floor(point.x / cellSize)),
+                          static_cast<std::int32_t>(std::floor(point.y / cellSize)));
+}
+
+std::uint64_t network::Grid::getKey(const std::int32_t x, const std::int32_t y) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 |
+           static_cast<std::uint32_t>(y);
+}
+
+void network::Grid::link(const std::uint32_t index, const std::uint64_t cell) {
+    std::vector<std::uint32_t>& indexes = cells[cell];
+    entries[index].cell = cell;
+    entries[index].slot = indexes.size();
+    indexes.push_back(index);
+}
+
+void network::Grid::unlink(const std::uint32_t index) {
+    auto it = cells.find(entries[index].cell);
+    std::vector<std::uint32_t>& indexes = it->second;
+
+    // move the last point of the cell in the freed slot
+    std::uint32_t slot = entries[index].slot;
+    indexes[slot] = indexes.back();
+    entries[indexes[slot]].slot = slot;
+    indexes.pop_back();
+
+    if (indexes.empty()) cells.erase(it);
+}
+
+const network::Grid::Entry& network::Grid::getEntry(const std::uint32_t index) const {
+    if (!contains(index)) throw PointNotFoundError();
+
+    return entries[index];
+}
+
+void network::Grid::insert(const std::uint32_t index, const Point point) {
+    if (contains(index)) throw PointExistsError();
+
+    if (index >= entries.size()) entries.resize(index + 1, {{0, 0}, 0, 0, false});
+
+    auto cell = getCell(point);
+    entries[index].point = point;
+    entries[index].present = true;
+    link(index, getKey(cell.first, cell.second));
+    size++;
+}
+
+void network::Grid::update(const std::uint32_t index, const Point point) {
+    getEntry(index);
+    auto cell = getCell(point);
+    std::uint64_t key = getKey(cell.first, cell.second);
+    entries[index].point = point;
+
+    // most moves stay in the same cell
+    if (key == entries[index].cell) return;
+
+    unlink(index);
+    link(index, key);
+}
+
+void network::Grid::update(const std::uint32_t index, const Network& network,
+                           const train::Train& train) {
+    update(index, network.getPoint(train.getPosition()));
+}
+
+void network::Grid::remove(const std::uint32_t index) {
+    getEntry(index);
+    unlink(index);
+    entries[index].present = false;
+    size--;
+}
+
+bool network::Grid::contains(const std::uint32_t index) const {
+    return index < entries.size() && entries[index].present;
+}
+
+std::size_t network::Grid::getSize() const {
+    return size;
+}
+
+network::Point network::Grid::getPoint(const std::uint32_t index) const {
+    return getEntry(index).point;
+}
+
+void network::Grid::findNear(const Point point, const types::distance radius,
+                             std::vector<std::uint32_t>& found) const {
+    TRACE_SCOPE("Grid::findNear");
+
+    found.clear();
+    auto center = getCell(point);
+    std::int32_t range = static_cast<std::int32_t>(std::ceil(radius / cellSize));
+
+    for (std::int32_t x = center.first - range; x <= center.first + range; x++) {
+        for (std::int32_t y = center.second - range; y <= center.second + range; y++) {
+            auto it = cells.find(getKey(x, y));
+
+            if (it == cells.end()) continue;
+
+            for (const auto index : it->second) {
+                if (isNear(point, entries[index].point, radius)) found.push_back(index);
+            }
+        }
+    }
+}
+
+void network::Grid::findNear(const std::uint32_t index, const types::distance radius,
+                             std::vector<std::uint32_t>& found) const {
+    findNear(getEntry(index).point, radius, found);
+    found.erase(std::remove(found.begin(), found.end(), index), found.end());
+}
+
+void network::Grid::findPairs(const types::distance radius,
+                              std::vector<std::pair<std::uint32_t, std::uint32_t>>& pairs) const {
+    TRACE_SCOPE("Grid::findPairs");
+
+    pairs.clear();
+    std::int32_t range = static_cast<std::int32_t>(std::ceil(radius / cellSize));
+
+    for (const auto& cell : cells) {
+        const std::vector<std::uint32_t>& indexes = cell.second;
+
+        // pairs inside the cell
+        for (std::size_t first = 0; first < indexes.size(); first++) {
+            for (std::size_t second = first + 1; second < indexes.size(); second++) {
+                if (isNear(entries[indexes[first]].point, entries[indexes[second]].point,
+                           radius)) {
+                    pairs.push_back(makePair(indexes[first], indexes[second]));
+                }
+            }
+        }
+
+        // pairs with the neighbor cells, only looking forward so that each
+        // pair of cells is visited once
+        std::int32_t cellX = static_cast<std::int32_t>(cell.first >> 32);
+        std::int32_t cellY = static_cast<std::int32_t>(cell.first & UINT32_MAX);
+
+        for (std::int32_t y = 0; y <= range; y++) {
+            for (std::int32_t x = y ? -range : 1; x <= range; x++) {
+                auto it = cells.find(getKey(cellX + x, cellY + y));
+
+                if (it == cells.end()) continue;
+
+                for (const auto first : indexes) {
+                    for (const auto second : it->second) {
+                        if (isNear(entries[first].point, entries[second].point, radius)) {
+                            pairs.push_back(makePair(first, second));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
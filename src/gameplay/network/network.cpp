@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+#include "gameplay/network/network.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Infinite distance, for unreachable nodes.
+ */
+const types::distance infinity = std::numeric_limits<types::distance>::infinity();
+
+/**
+ * Entry of a heap of nodes to visit.
+ */
+using HeapEntry = std::pair<float, std::uint32_t>;
+
+/**
+ * Order of the heap, lowest cost first.
+ */
+using HeapOrder = std::greater<HeapEntry>;
+
+}
+
+network::Network::Network() :
+    nodes(), rails(), offsets(), sources(), targets(), lengths(), speedLimits(),
+    maxSpeedLimit(0), landmarkCount(0), landmarkDistances(), built(false) {}
+
+std::uint32_t network::Network::addNode(const std::string name, const NodeTypes type,
+                                        const types::coordinate x,
+                                        const types::coordinate y) {
+    nodes.push_back({name, type, x, y});
+    built = false;
+    return nodes.size() - 1;
+}
+
+void network::Network::addRail(const std::uint32_t from, const std::uint32_t to,
+                               const types::distance length,
+                               const types::speed speedLimit) {
+    if (from >= nodes.size() || to >= nodes.size()) throw InvalidIndexError();
+
+    rails.push_back({from, to, length, speedLimit});
+    built = false;
+}
+
+void network::Network::build(const std::size_t requestedLandmarkCount) {
+    TRACE_SCOPE("Network::build");
+
+    std::size_t nodeCount = nodes.size();
+    std::size_t arcCount = rails.size() * 2;
+
+    // count arcs leaving each node
+    offsets.assign(nodeCount + 1, 0);
+
+    for (const auto& rail : rails) {
+        offsets[rail.from + 1]++;
+        offsets[rail.to + 1]++;
+    }
+
+    for (std::size_t node = 0; node < nodeCount; node++) {
+        offsets[node + 1] += offsets[node];
+    }
+
+    // pack arcs by start node
+    sources.resize(arcCount);
+    targets.resize(arcCount);
+    lengths.resize(arcCount);
+    speedLimits.resize(arcCount);
+    std::vector<std::uint32_t> next(offsets.begin(), offsets.end() - 1);
+    maxSpeedLimit = 0;
+
+    for (const auto& rail : rails) {
+        std::uint32_t arcs[] = {next[rail.from]++, next[rail.to]++};
+        sources[arcs[0]] = rail.from;
+        targets[arcs[0]] = rail.to;
+        sources[arcs[1]] = rail.to;
+        targets[arcs[1]] = rail.from;
+
+        for (const auto arc : arcs) {
+            lengths[arc] = rail.length;
+            speedLimits[arc] = rail.speedLimit;
+        }
+
+        maxSpeedLimit = std::max(maxSpeedLimit, rail.speedLimit);
+    }
+
+    // choose landmarks far from each other, starting from the node the
+    // farthest from the first one
+    landmarkCount = std::min(requestedLandmarkCount, nodeCount);
+    landmarkDistances.resize(landmarkCount * nodeCount);
+    std::vector<types::distance> closest(nodeCount, infinity);
+
+    if (landmarkCount) computeDistances(0, landmarkDistances.data());
+
+    for (std::size_t landmark = 0; landmark < landmarkCount; landmark++) {
+        types::distance* distances = landmarkDistances.data() + landmark * nodeCount;
+
+        // the first landmark uses the distances from the first node
+        const types::distance* from = landmark ? closest.data() : distances;
+        std::uint32_t farthest = 0;
+
+        for (std::uint32_t node = 0; node < nodeCount; node++) {
+            // unreachable nodes come first, to cover all the components
+            if (from[node] > from[farthest]) farthest = node;
+        }
+
+        computeDistances(farthest, distances);
+
+        for (std::size_t node = 0; node < nodeCount; node++) {
+            closest[node] = landmark ? std::min(closest[node], distances[node]) : distances[node];
+        }
+    }
+
+    built = true;
+}
+
+void network::Network::computeDistances(const std::uint32_t from,
+                                        types::distance* distances) const {
+    std::fill(distances, distances + nodes.size(), infinity);
+    std::vector<HeapEntry> heap;
+    distances[from] = 0;
+    heap.push_back({0, from});
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), HeapOrder());
+        HeapEntry entry = heap.back();
+        heap.pop_back();
+
+        // skip outdated entries
+        if (entry.first > distances[entry.second]) continue;
+
+        for (std::uint32_t arc = offsets[entry.second]; arc < offsets[entry.second + 1]; arc++) {
+            types::distance distance = entry.first + lengths[arc];
+
+            if (distance < distances[targets[arc]]) {
+                distances[targets[arc]] = distance;
+                heap.push_back({distance, targets[arc]});
+                std::push_heap(heap.begin(), heap.end(), HeapOrder());
+            }
+        }
+    }
+}
+
+void network::Network::checkBuilt() const {
+    if (!built) throw NotBuiltError();
+}
+
+bool network::Network::isBuilt() const {
+    return built;
+}
+
+std::size_t network::Network::getNodeCount() const {
+    return nodes.size();
+}
+
+std::size_t network::Network::getArcCount() const {
+    checkBuilt();
+
+    return targets.size();
+}
+
+const network::Node& network::Network::getNode(const std::uint32_t node) const {
+    if (node >= nodes.size()) throw InvalidIndexError();
+
+    return nodes[node];
+}
+
+std::pair<std::uint32_t, std::uint32_t> network::Network::getArcs(
+const std::uint32_t node) const {
+    checkBuilt();
+
+    if (node >= nodes.size()) throw InvalidIndexError();
+
+    return std::make_pair(offsets[node], offsets[node + 1]);
+}
+
+std::uint32_t network::Network::getSource(const std::uint32_t arc) const {
+    return sources.at(arc);
+}
+
+std::uint32_t network::Network::getTarget(const std::uint32_t arc) const {
+    return targets.at(arc);
+}
+
+types::distance network::Network::getLength(const std::uint32_t arc) const {
+    return lengths.at(arc);
+}
+
+types::speed network::Network::getSpeedLimit(const std::uint32_t arc) const {
+    return speedLimits.at(arc);
+}
+
+types::speed network::Network::getMaxSpeedLimit() const {
+    return maxSpeedLimit;
+}
+
+types::distance network::Network::getLowerBound(const std::uint32_t from,
+        const std::uint32_t to) const {
+    // triangle inequality on each landmark
+    std::size_t nodeCount = nodes.size();
+    types::distance bound = 0;
+
+    for (std::size_t landmark = 0; landmark < landmarkCount; landmark++) {
+        const types::distance* distances = landmarkDistances.data() + landmark * nodeCount;
+
+        // nodes unreachable from the landmark give no information
+        if (distances[from] == infinity || distances[to] == infinity) continue;
+
+        bound = std::max(bound, std::abs(distances[to] - distances[from]));
+    }
+
+    return bound;
+}
+
+void network::Network::place(train::Train& train, const std::uint32_t arc,
+                             const types::distance offset) const {
+    checkBuilt();
+
+    if (arc >= targets.size()) throw InvalidIndexError();
+
+    train.setPosition({arc, 0, std::max(0.f, std::min(offset, lengths[arc]))});
+}
+
+network::Point network::Network::getPoint(const train::Position& position) const {
+    if (position.arc >= targets.size()) throw InvalidIndexError();
+
+    // interpolate between the ends of the arc
+    const Node& source = nodes[sources[position.arc]];
+    const Node& target = nodes[targets[position.arc]];
+    float ratio = lengths[position.arc] > 0 ? position.offset / lengths[position.arc] : 0;
+
+    return {source.x + (target.x - source.x) * ratio, source.y + (target.y - source.y) * ratio};
+}
+
+bool network::Network::advance(train::Train& train, const Route& route,
+                               types::distance distance) const {
+    if (route.arcs.empty()) return true;
+
+    train::Position position = train.getPosition();
+
+    // start following the route
+    if (position.leg >= route.arcs.size() || route.arcs[position.leg] != position.arc) {
+        if (position.arc != route.arcs[0]) throw NotOnRouteError();
+
+        position.leg = 0;
+    }
+
+    // move to the next arcs
+    position.offset += distance;
+
+    while (position.offset >= lengths[position.arc] && position.leg + 1 < route.arcs.size()) {
+        position.offset -= lengths[position.arc];
+        position.leg++;
+        position.arc = route.arcs[position.leg];
+    }
+
+    bool arrived = position.offset >= lengths[position.arc];
+
+    if (arrived) position.offset = lengths[position.arc];
+
+    train.setPosition(position);
+
+    return arrived;
+}
+
+network::Router::Router(const Network& network) :
+    network(network), costs(), parents(), stamps(), settled(), stamp(0), heap() {}
+
+void network::Router::findShortestPath(const std::uint32_t from, const std::uint32_t to,
+                                       Route& route) {
+    search(from, to, 0, route);
+}
+
+void network::Router::findFastestPath(const std::uint32_t from, const std::uint32_t to,
+                                      const types::speed speed, Route& route) {
+    // a train that cannot move goes nowhere
+    if (speed <= 0) throw NoRouteError();
+
+    search(from, to, speed, route);
+}
+
+void network::Router::findFastestPath(const std::uint32_t from, const std::uint32_t to,
+                                      const train::Train& train, Route& route) {
+    findFastestPath(from, to, train.getTraction().maxSpeed, route);
+}
+
+void network::Router::search(const std::uint32_t from, const std::uint32_t to,
+                             const types::speed speed, Route& route) {
+    TRACE_SCOPE("Router::search");
+
+    if (!network.isBuilt()) throw NotBuiltError();
+
+    std::size_t nodeCount = network.getNodeCount();
+
+    if (from >= nodeCount || to >= nodeCount) throw InvalidIndexError();
+
+    // the network may have been built again
+    if (costs.size() != nodeCount) {
+        costs.assign(nodeCount, 0);
+        parents.assign(nodeCount, 0);
+        stamps.assign(nodeCount, 0);
+        settled.assign(nodeCount, 0);
+        stamp = 0;
+    }
+
+    // start a new query, without clearing the arrays
+    if (++stamp == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        std::fill(settled.begin(), settled.end(), 0);
+        stamp = 1;
+    }
+
+    // convert distance bounds to duration bounds with the highest speed
+    float scale = speed > 0 ? 1 / std::min(speed, network.getMaxSpeedLimit()) : 1;
+
+    heap.clear();
+    costs[from] = 0;
+    stamps[from] = stamp;
+    heap.push_back({network.getLowerBound(from, to) * scale, from});
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), HeapOrder());
+        std::uint32_t node = heap.back().second;
+        heap.pop_back();
+
+        // the heuristic is consistent, a node is settled on its first visit
+        if (settled[node] == stamp) continue;
+
+        settled[node] = stamp;
+
+        if (node == to) break;
+
+        auto arcs = network.getArcs(node);
+
+        for (std::uint32_t arc = arcs.first; arc < arcs.second; arc++) {
+            std::uint32_t target = network.getTarget(arc);
+            float cost = network.getLength(arc);
+
+            if (speed > 0) cost /= std::min(speed, network.getSpeedLimit(arc));
+
+            cost += costs[node];
+
+            if (stamps[target] != stamp || cost < costs[target]) {
+                costs[target] = cost;
+                parents[target] = arc;
+                stamps[target] = stamp;
+                heap.push_back({cost + network.getLowerBound(target, to) * scale, target});
+                std::push_heap(heap.begin(), heap.end(), HeapOrder());
+            }
+        }
+    }
+
+    if (settled[to] != stamp) throw NoRouteError();
+
+    // walk back the arcs
+    route.arcs.clear();
+
+    for (std::uint32_t node = to; node != from; node = network.getSource(parents[node])) {
+        route.arcs.push_back(parents[node]);
+    }
+
+    std::reverse(route.arcs.begin(), route.arcs.end());
+    route.cost = costs[to];
+}
@@ -0,0 +1,460 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gameplay/save/autosave.hpp"
+#include "tools/hash.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Magic number of save files.
+ */
+const char magic[8] = {'T', 'R', 'S', 'A', 'V', 'E', '0', '0'};
+
+/**
+ * Version of the format of save files.
+ * Also tells apart platforms with another byte order.
+ */
+const std::uint32_t version = 2;
+
+/**
+ * Flag of the saves whose runs of zeros are compressed.
+ */
+const std::uint32_t compressedFlag = 1;
+
+/**
+ * Longest run of a compressed save.
+ */
+const std::size_t maxRun = 128;
+
+/**
+ * Header of save files.
+ */
+struct FileHeader {
+    /**
+     * Magic number.
+     */
+    char magic[8];
+
+    /**
+     * Version of the format.
+     */
+    std::uint32_t version;
+
+    /**
+     * Flags.
+     */
+    std::uint32_t flags;
+
+    /**
+     * Size of the snapshot, in bytes.
+     */
+    std::uint64_t rawSize;
+
+    /**
+     * Size of the snapshot as stored in the file, in bytes.
+     */
+    std::uint64_t storedSize;
+
+    /**
+     * Checksum of the snapshot.
+     */
+    std::uint64_t checksum;
+};
+
+/**
+ * Header of snapshots.
+ */
+struct SnapshotHeader {
+    /**
+     * Number of the snapshot.
+     */
+    std::uint64_t sequence;
+
+    /**
+     * Number of trains.
+     */
+    std::uint32_t trainCount;
+
+    /**
+     * Number of cars.
+     */
+    std::uint32_t carCount;
+};
+
+static_assert(sizeof(FileHeader) == 40, "Save header must not be padded");
+static_assert(sizeof(SnapshotHeader) == 16, "Snapshot header must not be padded");
+
+/**
+ * Compute the checksum of a snapshot.
+ * @param data Snapshot.
+ * @return Checksum.
+ */
+std::uint64_t computeChecksum(const std::vector<char>& data) {
+    std::uint64_t state = hash::mix(data.size());
+    std::size_t index = 0;
+
+    for (; index + sizeof(std::uint64_t) <= data.size(); index += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, data.data() + index, sizeof(word));
+        state = hash::combine(state, word);
+    }
+
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, data.data() + index, data.size() - index);
+    return hash::combine(state, tail);
+}
+
+/**
+ * Compress the runs of zeros of a snapshot.
+ * Each run starts with a byte giving its length minus one, with the high bit
+ * set for a run of zeros, followed for other runs by their bytes.
+ * @param data Snapshot.
+ * @param packed Compressed snapshot.
+ */
+void pack(const std::vector<char>& data, std::vector<char>& packed) {
+    packed.clear();
+    std::size_t index = 0;
+
+    while (index < data.size()) {
+        std::size_t length = 0;
+
+        while (index + length < data.size() && !data[index + length] && length < maxRun) {
+            length++;
+        }
+
+        // single zeros are cheaper among other bytes
+        if (length > 1) {
+            packed.push_back(static_cast<char>(0x80 | (length - 1)));
+            index += length;
+            continue;
+        }
+
+        std::size_t start = index;
+
+        while (index < data.size() && index - start < maxRun &&
+                (data[index] || index + 1 == data.size() || data[index + 1])) {
+            index++;
+        }
+
+        packed.push_back(static_cast<char>(index - start - 1));
+        packed.insert(packed.end(), data.begin() + start, data.begin() + index);
+    }
+}
+
+/**
+ * Expand the runs of zeros of a snapshot.
+ * @param packed Compressed snapshot.
+ * @param size Size of the snapshot.
+ * @param data Snapshot.
+ * @return True if the compressed snapshot is well formed.
+ */
+bool unpack(const std::vector<char>& packed, const std::size_t size, std::vector<char>& data) {
+    data.clear();
+    data.reserve(size);
+    std::size_t index = 0;
+
+    while (index < packed.size()) {
+        unsigned char control = packed[index++];
+        std::size_t length = (control & 0x7f) + 1;
+
+        if (data.size() + length > size) return false;
+
+        if (control & 0x80) {
+            data.insert(data.end(), length, 0);
+            continue;
+        }
+
+        if (index + length > packed.size()) return false;
+
+        data.insert(data.end(), packed.begin() + index, packed.begin() + index + length);
+        index += length;
+    }
+
+    return data.size() == size;
+}
+
+/**
+ * Write bytes to a file, whatever the number of calls it takes.
+ * @param descriptor File descriptor.
+ * @param bytes Bytes to write.
+ * @param size Number of bytes.
+ * @return True if all the bytes were written.
+ */
+bool writeAll(const int descriptor, const char* bytes, std::size_t size) {
+    while (size) {
+        ssize_t written = ::write(descriptor, bytes, size);
+
+        if (written < 0) {
+            if (errno == EINTR) continue;
+
+            return false;
+        }
+
+        bytes += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+}
+
+save::Save save::read(const std::string& path) {
+    TRACE_SCOPE("read");
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+    if (!file) throw SaveFileError();
+
+    std::uint64_t fileSize = file.tellg();
+    file.seekg(0);
+    FileHeader header;
+
+    if (fileSize < sizeof(header) ||
+            !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version ||
+            header.storedSize != fileSize - sizeof(header)) {
+        throw SaveFileError();
+    }
+
+    std::vector<char> stored(header.storedSize);
+
+    if (!file.read(stored.data(), stored.size())) throw SaveFileError();
+
+    std::vector<char> data;
+
+    if (!(header.flags & compressedFlag)) {
+        data.swap(stored);
+    } else if (header.rawSize > maxRun * header.storedSize ||
+               !unpack(stored, header.rawSize, data)) {
+        throw SaveFileError();
+    }
+
+    if (data.size() != header.rawSize || data.size() < sizeof(SnapshotHeader) ||
+            computeChecksum(data) != header.checksum) {
+        throw SaveFileError();
+    }
+
+    // the counts must match the size of the snapshot
+    SnapshotHeader snapshot;
+    std::memcpy(&snapshot, data.data(), sizeof(snapshot));
+    std::uint64_t trainsSize = std::uint64_t(snapshot.trainCount) * sizeof(TrainRecord);
+    std::uint64_t carsSize = std::uint64_t(snapshot.carCount) * sizeof(CarRecord);
+
+    if (sizeof(snapshot) + trainsSize + carsSize != data.size()) throw SaveFileError();
+
+    Save save = {snapshot.sequence, std::vector<TrainRecord>(snapshot.trainCount),
+                 std::vector<CarRecord>(snapshot.carCount)
+                };
+    std::memcpy(save.trains.data(), data.data() + sizeof(snapshot), trainsSize);
+    std::memcpy(save.cars.data(), data.data() + sizeof(snapshot) + trainsSize, carsSize);
+    std::uint64_t carCount = 0;
+
+    for (const auto& train : save.trains) {
+        carCount += train.carCount;
+    }
+
+    if (carCount != save.cars.size()) throw SaveFileError();
+
+    return save;
+}
+
+save::Autosave::Autosave(const std::string& path, const bool isCompressed) :
+    path(path), isCompressed(isCompressed), mutex(), snapshotPending(), snapshotWritten(),
+    buffers{{{}, State::free}, {{}, State::free}}, packed(), capturedCount(0),
+    writtenCount(0), failedCount(0), isStopping(false), writer() {
+    writer = std::thread(&Autosave::work, this);
+}
+
+save::Autosave::~Autosave() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+
+    snapshotPending.notify_all();
+    writer.join();
+}
+
+void save::Autosave::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        snapshotPending.wait(lock, [this]() {
+            return isStopping || buffers[0].state == State::pending ||
+                   buffers[1].state == State::pending;
+        });
+
+        // the pending snapshot is written even when stopping
+        Buffer* buffer = buffers[0].state == State::pending ? &buffers[0] :
+                         buffers[1].state == State::pending ? &buffers[1] : nullptr;
+
+        if (!buffer) return;
+
+        buffer->state = State::writing;
+        lock.unlock();
+        bool isWritten = write(buffer->data);
+        lock.lock();
+        buffer->state = State::free;
+
+        if (isWritten) {
+            writtenCount++;
+        } else {
+            failedCount++;
+        }
+
+        snapshotWritten.notify_all();
+    }
+}
+
+bool save::Autosave::write(const std::vector<char>& data) {
+    TRACE_SCOPE("Autosave::write");
+
+    FileHeader header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.flags = isCompressed ? compressedFlag : 0;
+    header.rawSize = data.size();
+    header.checksum = computeChecksum(data);
+    const std::vector<char>* stored = &data;
+
+    if (isCompressed) {
+        pack(data, packed);
+        stored = &packed;
+    }
+
+    header.storedSize = stored->size();
+
+    // the save is replaced at once, once on disk
+    std::string temporaryPath = path + ".tmp";
+    int descriptor = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (descriptor < 0) return false;
+
+    bool isWritten = writeAll(descriptor, reinterpret_cast<const char*>(&header),
+                              sizeof(header)) &&
+                     writeAll(descriptor, stored->data(), stored->size()) && !fsync(descriptor);
+    isWritten = !close(descriptor) && isWritten;
+
+    if (!isWritten) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return !std::rename(temporaryPath.c_str(), path.c_str());
+}
+
+void save::Autosave::fill(std::vector<char>& data, const std::uint64_t sequence,
+                         const std::vector<const train::Train*>& trains) {
+    std::size_t carCount = 0;
+
+    for (const auto train : trains) {
+        carCount += train->getSize();
+    }
+
+    // the buffer keeps its capacity from a snapshot to the next
+    SnapshotHeader header = {sequence, static_cast<std::uint32_t>(trains.size()),
+                             static_cast<std::uint32_t>(carCount)
+                            };
+    data.resize(sizeof(header) + trains.size() * sizeof(TrainRecord) +
+                carCount * sizeof(CarRecord));
+    char* cursor = data.data();
+    std::memcpy(cursor, &header, sizeof(header));
+    cursor += sizeof(header);
+    char* carCursor = cursor + trains.size() * sizeof(TrainRecord);
+
+    for (const auto train : trains) {
+        const train::Position& position = train->getPosition();
+        TrainRecord trainRecord = {static_cast<std::uint32_t>(train->getSize()), position.arc,
+                                   position.leg, position.offset, train->getSpeed(),
+                                   train->getCoal(), train->getThrottle()
+                                  };
+        std::memcpy(cursor, &trainRecord, sizeof(trainRecord));
+        cursor += sizeof(trainRecord);
+
+        for (std::size_t index = 0; index < train->getSize(); index++) {
+            const cars::Car& car = train->get(train->getHandleAt(index));
+            const cars::CarState& state = car.getState();
+            CarRecord carRecord = {car.getCarId(), car.getId(), state.weight, state.power,
+                                   state.quantity, 0, 0, state.health, {}
+                                  };
+
+            // only loaded cars are looked at beyond their hot state, destroyed
+            // cars lose their load
+            if (state.health <= 0) carRecord.quantity = 0;
+
+            if (carRecord.quantity) {
+                auto loadCar = dynamic_cast<const cars::LoadCar*>(&car);
+
+                if (loadCar) {
+                    carRecord.merch = loadCar->getMerchLoad()->getMerch().getId();
+                    carRecord.cost = loadCar->getMerchLoad()->getCost();
+                }
+            }
+
+            std::memcpy(carCursor, &carRecord, sizeof(carRecord));
+            carCursor += sizeof(carRecord);
+        }
+    }
+}
+
+std::uint64_t save::Autosave::capture(const std::vector<const train::Train*>& trains) {
+    TRACE_SCOPE("Autosave::capture");
+
+    Buffer* buffer;
+    std::uint64_t sequence;
+
+    {
+        // replace the pending snapshot, if any, never the one being written
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer = buffers[1].state == State::pending || buffers[0].state == State::writing ?
+                 &buffers[1] : &buffers[0];
+        buffer->state = State::filling;
+        sequence = ++capturedCount;
+    }
+
+    try {
+        fill(buffer->data, sequence, trains);
+    } catch (...) {
+        // give the buffer back if the snapshot cannot be taken
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffer->state = State::free;
+        }
+
+        snapshotWritten.notify_all();
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer->state = State::pending;
+    }
+
+    snapshotPending.notify_one();
+    return sequence;
+}
+
+void save::Autosave::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    snapshotWritten.wait(lock, [this]() {
+        return buffers[0].state == State::free && buffers[1].state == State::free;
+    });
+}
+
+std::uint64_t save::Autosave::getWrittenCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writtenCount;
+}
+
+std::uint64_t save::Autosave::getFailedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failedCount;
+}
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include <sys/resource.h>
+
+#include "gameplay/scenario/scenario.hpp"
+#include "gameplay/train/definitions.hpp"
+#include "tools/allocations.hpp"
+
+namespace {
+
+/**
+ * Get the peak memory of the process.
+ * @return Peak resident memory, in kB.
+ */
+long getPeakMemory() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * Print a counter and its rate.
+ * @param name Name of the counter.
+ * @param count Value of the counter.
+ * @param seconds Duration of the run.
+ */
+void printRate(const std::string& name, const std::uint64_t count, const double seconds) {
+    std::cout << name << ": " << count;
+
+    if (seconds > 0) std::cout << " (" << count / seconds << "/s)";
+
+    std::cout << std::endl;
+}
+
+}
+
+/**
+ * Run a scenario and report the throughput of the simulation.
+ * Usage: `scenario-runner FILE [DEFINITIONS]`, definitions being cached next
+ * to their file.
+ */
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " FILE [DEFINITIONS]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (argc == 3) {
+        auto start = std::chrono::steady_clock::now();
+        bool cached;
+
+        try {
+            cached = definitions::load(argv[2], std::string(argv[2]) + ".cache",
+                                       catalogs::getMerchs(), catalogs::getCarModels());
+        } catch (const exceptions::TransarcticaRebirthError& error) {
+            std::cerr << argv[2] << ": " << error.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        std::cout << "definitions: " << duration.count() * 1000 << " ms" <<
+                  (cached ? " (cached)" : "") << std::endl;
+    }
+
+    std::ifstream file(argv[1]);
+
+    if (!file) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    scenario::Scenario scenario;
+
+    try {
+        scenario.load(file);
+    } catch (const exceptions::TransarcticaRebirthError& error) {
+        std::cerr << argv[1] << ": " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // only count allocations of the run
+    std::uint64_t setupCount = allocations::getCount();
+    std::uint64_t setupSize = allocations::getSize();
+    scenario::Statistics statistics = scenario.run();
+    std::uint64_t runCount = allocations::getCount() - setupCount;
+    std::uint64_t runSize = allocations::getSize() - setupSize;
+
+    std::cout << "trains: " << scenario.getTrainCount() << std::endl;
+    std::cout << "duration: " << statistics.seconds << " s" << std::endl;
+    printRate("operations", statistics.operations, statistics.seconds);
+    printRate("ticks", statistics.ticks, statistics.seconds);
+    std::cout << "failures: " << statistics.failures << std::endl;
+    std::cout << "peak memory: " << getPeakMemory() << " kB" << std::endl;
+    std::cout << "allocations: " << runCount << " (" << runSize << " bytes)" << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,349 @@
+#include <chrono>
+#include <sstream>
+
+#include "gameplay/scenario/scenario.hpp"
+#include "gameplay/train/catalogs.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Reader of the arguments of a line.
+ */
+class Arguments {
+    /**
+     * Stream of the line.
+     */
+    std::istringstream& stream;
+
+    /**
+     * Number of the line.
+     */
+    std::size_t line;
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param stream Stream of the line, after the command.
+     * @param line Number of the line.
+     */
+    Arguments(std::istringstream& stream, const std::size_t line) :
+        stream(stream), line(line) {}
+
+    /**
+     * Read the next argument.
+     * @return Value of the argument.
+     */
+    template <typename T>
+    T read() {
+        T value;
+
+        if (!(stream >> value)) throw scenario::ParseError(line, "missing or invalid argument");
+
+        return value;
+    }
+
+    /**
+     * Read the next argument, if any.
+     * @param value Default value of the argument.
+     * @return Value of the argument.
+     */
+    template <typename T>
+    T read(const T value) {
+        std::string word;
+
+        if (!(stream >> word)) return value;
+
+        std::istringstream wordStream(word);
+        Arguments arguments(wordStream, line);
+        return arguments.read<T>();
+    }
+
+    /**
+     * Read the next argument as an entry of a catalog.
+     * The entry is given by ID or by name, names with spaces are quoted.
+     * @param entries Catalog of the entries.
+     * @param kind Kind of the entries, for errors.
+     * @return Entry.
+     */
+    template <typename T>
+    const T& readEntry(const catalog::Catalog<T>& entries, const std::string& kind) {
+        std::string word = read<std::string>();
+        const T* entry = nullptr;
+
+        if (word[0] == '"') {
+            // gather the words up to the closing quote
+            while (word.size() < 2 || word.back() != '"') {
+                std::string next;
+
+                if (!(stream >> next)) throw scenario::ParseError(line, "missing quote");
+
+                word += " " + next;
+            }
+
+            entry = entries.findByName(word.substr(1, word.size() - 2));
+        } else if (word.find_first_not_of("0123456789") == std::string::npos) {
+            // longer numbers are not valid IDs
+            if (word.size() < 10) entry = entries.findById(std::stoul(word));
+        } else {
+            entry = entries.findByName(word);
+        }
+
+        if (!entry) throw scenario::ParseError(line, "unknown " + kind + " " + word);
+
+        return *entry;
+    }
+
+    /**
+     * Check there are no arguments left.
+     */
+    void finish() {
+        std::string word;
+
+        if (stream >> word) throw scenario::ParseError(line, "too many arguments");
+    }
+};
+
+}
+
+scenario::ParseError::ParseError(const std::size_t line, const std::string& reason) :
+    message("Line " + std::to_string(line) + ": " + reason) {}
+
+scenario::Scenario::Scenario() :
+    names(), trains(), operations() {}
+
+std::uint32_t scenario::Scenario::findTrain(const std::string& name) const {
+    for (std::uint32_t index = 0; index < names.size(); index++) {
+        if (names[index] == name) return index;
+    }
+
+    return names.size();
+}
+
+void scenario::Scenario::load(std::istream& stream) {
+    std::string text;
+    std::size_t line = 0;
+    std::vector<std::uint32_t> blocks;
+
+    while (std::getline(stream, text)) {
+        line++;
+        std::istringstream lineStream(text);
+        std::string command;
+
+        // skip empty lines and comments
+        if (!(lineStream >> command) || command[0] == '#') continue;
+
+        Arguments arguments(lineStream, line);
+
+        // set up trains
+        if (command == "train") {
+            std::string name = arguments.read<std::string>();
+            std::size_t blockSize = arguments.read<std::size_t>(0);
+            arguments.finish();
+
+            if (findTrain(name) != names.size()) throw ParseError(line, "duplicate train");
+
+            names.push_back(name);
+            trains.emplace_back(blockSize ? new train::Train(blockSize) : new train::Train());
+            continue;
+        }
+
+        if (command == "locomotive" || command == "car" || command == "cargo" ||
+                command == "coal" || command == "throttle") {
+            if (trains.empty()) throw ParseError(line, "no train defined");
+
+            train::Train& train = *trains.back();
+
+            if (command == "locomotive") {
+                auto weight = arguments.read<types::weight>();
+                auto power = arguments.read<types::power>();
+                arguments.finish();
+                train.makeCar<cars::Locomotive>(1, "locomotive", weight, power);
+            }
+
+            if (command == "car") {
+                auto& model = arguments.readEntry(catalogs::getCarModels(), "car model");
+                auto count = arguments.read<std::size_t>(1);
+                arguments.finish();
+
+                for (std::size_t index = 0; index < count; index++) {
+                    train.makeCar<cars::LoadCar>(model());
+                }
+            }
+
+            if (command == "cargo") {
+                auto& merch = arguments.readEntry(catalogs::getMerchs(), "merch");
+                auto quantity = arguments.read<types::quantity>();
+                auto price = arguments.read<types::price>();
+                arguments.finish();
+
+                merchandises::MerchLoad merchLoad(merch, quantity, price);
+
+                if (!train.canBuy(merchLoad, quantity)) throw ParseError(line, "not enough space");
+
+                train.buy(merchLoad, quantity);
+            }
+
+            if (command == "coal") {
+                auto coal = arguments.read<types::weight>();
+                arguments.finish();
+                train.addCoal(coal);
+            }
+
+            if (command == "throttle") {
+                auto throttle = arguments.read<float>();
+                arguments.finish();
+
+                if (throttle < 0 || throttle > 1) throw ParseError(line, "invalid throttle");
+
+                train.setThrottle(throttle);
+            }
+
+            continue;
+        }
+
+        // script
+        Operation operation = {Operations::tick, 0, 0, 0, 0, 0};
+
+        if (command == "repeat") {
+            operation.type = Operations::repeat;
+            operation.first = arguments.read<std::uint32_t>();
+            blocks.push_back(operations.size());
+        } else if (command == "end") {
+            if (blocks.empty()) throw ParseError(line, "end without repeat");
+
+            operation.type = Operations::end;
+            operation.first = blocks.back();
+            operations[blocks.back()].second = operations.size();
+            blocks.pop_back();
+        } else if (command == "tick") {
+            operation.duration = arguments.read<types::duration>();
+        } else {
+            if (command == "buy") operation.type = Operations::buy;
+            else if (command == "sell") operation.type = Operations::sell;
+            else if (command == "damage") operation.type = Operations::damage;
+            else if (command == "repair") operation.type = Operations::repair;
+            else if (command == "move") operation.type = Operations::move;
+            else throw ParseError(line, "unknown command " + command);
+
+            operation.train = findTrain(arguments.read<std::string>());
+
+            if (operation.train == names.size()) throw ParseError(line, "unknown train");
+
+            // merchs are checked once for all and kept by ID
+            if (operation.type == Operations::buy || operation.type == Operations::sell) {
+                operation.first = arguments.readEntry(catalogs::getMerchs(), "merch").getId();
+            } else {
+                operation.first = arguments.read<std::uint32_t>();
+            }
+
+            if (operation.type != Operations::repair) {
+                operation.second = arguments.read<std::uint32_t>();
+            }
+
+            if (operation.type == Operations::buy) operation.price = arguments.read<types::price>();
+        }
+
+        arguments.finish();
+        operations.push_back(operation);
+    }
+
+    if (!blocks.empty()) throw ParseError(line, "repeat without end");
+}
+
+std::size_t scenario::Scenario::getTrainCount() const {
+    return trains.size();
+}
+
+train::Train& scenario::Scenario::getTrain(const std::size_t index) const {
+    return *trains.at(index);
+}
+
+std::size_t scenario::Scenario::getOperationCount() const {
+    return operations.size();
+}
+
+void scenario::Scenario::apply(const Operation& operation) {
+    train::Train& train = *trains[operation.train];
+
+    switch (operation.type) {
+        case Operations::buy: {
+            merchandises::MerchLoad merchLoad(catalogs::getMerchs().getById(operation.first),
+                                              operation.second, operation.price);
+            train.buy(merchLoad, operation.second);
+            break;
+        }
+
+        case Operations::sell:
+            train.sell(catalogs::getMerchs().getById(operation.first), operation.second);
+            break;
+
+        case Operations::damage:
+            train.get(train.getHandleAt(operation.first)).takeDammage(operation.second);
+            break;
+
+        case Operations::repair:
+            train.get(train.getHandleAt(operation.first)).repair();
+            break;
+
+        case Operations::move:
+            train.moveCar(train.get(train.getHandleAt(operation.first)).getCarId(),
+                          operation.second);
+            break;
+
+        default:
+            break;
+    }
+}
+
+scenario::Statistics scenario::Scenario::run() {
+    TRACE_SCOPE("Scenario::run");
+
+    Statistics statistics = {0, 0, 0, 0};
+    std::vector<std::uint32_t> loops;
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t index = 0; index < operations.size(); index++) {
+        const Operation& operation = operations[index];
+
+        switch (operation.type) {
+            case Operations::repeat:
+                // skip empty loops
+                if (!operation.first) index = operation.second;
+                else loops.push_back(operation.first);
+
+                break;
+
+            case Operations::end:
+                // go back to the start of the block
+                if (--loops.back()) index = operation.first;
+                else loops.pop_back();
+
+                break;
+
+            case Operations::tick:
+                for (const auto& train : trains) {
+                    train->tick(operation.duration);
+                }
+
+                statistics.ticks++;
+                break;
+
+            default:
+                statistics.operations++;
+
+                // failed operations leave the trains untouched
+                try {
+                    apply(operation);
+                } catch (const exceptions::TransarcticaRebirthError&) {
+                    statistics.failures++;
+                }
+        }
+    }
+
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    statistics.seconds = duration.count();
+
+    return statistics;
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cmath>
+
+#include "gameplay/station/depot.hpp"
+#include "tools/trace.hpp"
+
+bool station::Depot::IsLater::operator()(const Entry& first, const Entry& second) const {
+    if (first.departure != second.departure) return first.departure > second.departure;
+
+    if (first.stake != second.stake) return first.stake < second.stake;
+
+    return first.sequence > second.sequence;
+}
+
+station::Depot::Depot(const std::size_t crewCount, const float rate) :
+    queue(), sequences(), crews(crewCount, Crew{nullptr, 0}), rate(rate), submittedCount(0) {
+    if (!crewCount || !(rate > 0)) throw InvalidCrewError();
+}
+
+bool station::Depot::assign(Crew& crew) {
+    while (!queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+
+        // skip cars withdrawn or submitted again since
+        auto it = sequences.find(entry.carId);
+
+        if (it == sequences.end() || it->second != entry.sequence) continue;
+
+        if (entry.car->isDestroyed()) {
+            sequences.erase(it);
+            continue;
+        }
+
+        crew.car = entry.car;
+        crew.progress = 0;
+        return true;
+    }
+
+    return false;
+}
+
+void station::Depot::submit(cars::Car& car, const float value,
+                            const types::duration departure) {
+    if (car.isDestroyed()) throw cars::DestroyedCarError();
+
+    for (const auto& crew : crews) {
+        if (crew.car == &car) return;
+    }
+
+    types::health deficit = car.getMaxHealth() - car.getHealth();
+    std::uint64_t sequence = submittedCount++;
+    sequences[car.getCarId()] = sequence;
+    queue.push({departure, value * deficit, sequence, car.getCarId(), &car});
+}
+
+bool station::Depot::withdraw(const types::id carId) {
+    if (!sequences.erase(carId)) return false;
+
+    // stop the crew repairing it, if any
+    for (auto& crew : crews) {
+        if (crew.car && crew.car->getCarId() == carId) crew = {nullptr, 0};
+    }
+
+    return true;
+}
+
+bool station::Depot::contains(const types::id carId) const {
+    return sequences.count(carId);
+}
+
+std::size_t station::Depot::getSize() const {
+    return sequences.size();
+}
+
+std::size_t station::Depot::getBusyCrewCount() const {
+    std::size_t count = 0;
+
+    for (const auto& crew : crews) {
+        if (crew.car) count++;
+    }
+
+    return count;
+}
+
+std::vector<types::id> station::Depot::tick(const types::duration duration) {
+    TRACE_SCOPE("Depot::tick");
+
+    std::vector<types::id> repaired;
+
+    for (auto& crew : crews) {
+        float available = rate * duration;
+
+        // time left on a car goes to the next one, if any
+        while (crew.car || (available > 0 && assign(crew))) {
+            cars::Car& car = *crew.car;
+
+            if (car.isDestroyed()) {
+                sequences.erase(car.getCarId());
+                crew = {nullptr, 0};
+                continue;
+            }
+
+            // the car may have been repaired another way meanwhile
+            float missing = std::max(car.getMaxHealth() - car.getHealth() - crew.progress, 0.f);
+
+            if (available < missing) {
+                crew.progress += available;
+                types::health points = std::floor(crew.progress);
+                car.repair(points);
+                crew.progress -= points;
+                break;
+            }
+
+            available -= missing;
+            car.repair();
+            repaired.push_back(car.getCarId());
+            sequences.erase(car.getCarId());
+            crew = {nullptr, 0};
+        }
+    }
+
+    return repaired;
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "gameplay/station/orders.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Size of a cache line, in bytes.
+ */
+const std::size_t cacheLineSize = 64;
+
+/**
+ * Tell if an order comes before another one in the batch of its merch.
+ * Buy orders come first, highest price first, sell orders then, lowest price
+ * first. Ties are broken by trader then by quantity, so that equal orders are
+ * interchangeable.
+ * @param first First order.
+ * @param second Second order.
+ * @return True if the first order comes first.
+ */
+bool isBefore(const station::Order& first, const station::Order& second) {
+    if (first.side != second.side) return first.side == station::Side::buy;
+
+    if (first.price != second.price) {
+        return first.side == station::Side::buy ? first.price > second.price :
+               first.price < second.price;
+    }
+
+    if (first.trader != second.trader) return first.trader < second.trader;
+
+    return first.quantity > second.quantity;
+}
+
+}
+
+struct station::OrderBook::Shard {
+    /**
+     * Lock of the orders.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * Orders placed.
+     */
+    std::vector<Order> orders;
+
+    /**
+     * Padding, so that shards used by different threads do not share a cache
+     * line.
+     */
+    char padding[cacheLineSize];
+};
+
+station::OrderBook::OrderBook(const std::size_t shardCount) :
+    shards(), shardCount(shardCount) {
+    if (!shardCount) throw InvalidShardCountError();
+
+    shards.reset(new Shard[shardCount]);
+}
+
+station::OrderBook::~OrderBook() {}
+
+void station::OrderBook::submit(const Order& order) {
+    if (!order.quantity) throw InvalidOrderError();
+
+    Shard& shard = shards[order.trader % shardCount];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.orders.push_back(order);
+}
+
+void station::OrderBook::buy(const types::id trader, const merchandises::Merch& merch,
+                             const types::price price, const types::quantity quantity) {
+    submit({trader, merch.getId(), Side::buy, price, quantity});
+}
+
+void station::OrderBook::sell(const types::id trader, const merchandises::Merch& merch,
+                              const types::price price, const types::quantity quantity) {
+    submit({trader, merch.getId(), Side::sell, price, quantity});
+}
+
+std::size_t station::OrderBook::getSize() const {
+    std::size_t size = 0;
+
+    for (std::size_t index = 0; index < shardCount; index++) {
+        std::lock_guard<std::mutex> lock(shards[index].mutex);
+        size += shards[index].orders.size();
+    }
+
+    return size;
+}
+
+void station::OrderBook::matchMerch(std::vector<Order>& orders, std::vector<Trade>& trades) {
+    std::sort(orders.begin(), orders.end(), isBefore);
+
+    auto sells = std::find_if(orders.begin(), orders.end(), [](const Order & order) {
+        return order.side == Side::sell;
+    });
+
+    auto buy = orders.begin();
+    auto sell = sells;
+
+    // meet the best orders of each side while their prices cross
+    while (buy != sells && sell != orders.end() && buy->price >= sell->price) {
+        types::quantity quantity = std::min(buy->quantity, sell->quantity);
+        types::price price = (buy->price + sell->price) / 2;
+        trades.push_back({buy->merch, buy->trader, sell->trader, price, quantity});
+        buy->quantity -= quantity;
+        sell->quantity -= quantity;
+
+        if (!buy->quantity) buy++;
+
+        if (!sell->quantity) sell++;
+    }
+}
+
+std::vector<station::Trade> station::OrderBook::match(const std::size_t threadCount) {
+    TRACE_SCOPE("OrderBook::match");
+
+    // gather the orders by merch
+    std::unordered_map<types::id, std::size_t> merchIndexes;
+    std::vector<std::vector<Order>> batches;
+
+    for (std::size_t index = 0; index < shardCount; index++) {
+        std::lock_guard<std::mutex> lock(shards[index].mutex);
+
+        for (const auto& order : shards[index].orders) {
+            auto inserted = merchIndexes.insert({order.merch, batches.size()});
+
+            if (inserted.second) batches.emplace_back();
+
+            batches[inserted.first->second].push_back(order);
+        }
+
+        shards[index].orders.clear();
+    }
+
+    if (batches.empty()) return {};
+
+    // match merchs in the order of their IDs
+    std::sort(batches.begin(), batches.end(), [](const std::vector<Order>& first,
+    const std::vector<Order>& second) {
+        return first.front().merch < second.front().merch;
+    });
+
+    std::vector<std::vector<Trade>> batchTrades(batches.size());
+    std::atomic<std::size_t> nextBatch(0);
+
+    // threads take the next merch until all are done
+    auto work = [&]() {
+        for (std::size_t batch = nextBatch++; batch < batches.size(); batch = nextBatch++) {
+            matchMerch(batches[batch], batchTrades[batch]);
+        }
+    };
+
+    std::size_t workerCount = threadCount ? threadCount : std::thread::hardware_concurrency();
+    workerCount = std::max<std::size_t>(1, std::min(workerCount, batches.size()));
+    std::vector<std::thread> workers;
+
+    // the current thread works too
+    for (std::size_t worker = 1; worker < workerCount; worker++) {
+        workers.emplace_back(work);
+    }
+
+    work();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // gather trades in merch order
+    std::vector<Trade> trades;
+
+    for (const auto& merchTrades : batchTrades) {
+        trades.insert(trades.end(), merchTrades.begin(), merchTrades.end());
+    }
+
+    return trades;
+}
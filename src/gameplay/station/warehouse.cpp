@@ -0,0 +1,151 @@
+#include <algorithm>
+
+#include "gameplay/station/warehouse.hpp"
+#include "gameplay/train/catalogs.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Add merchandise to a stock.
+ * The cost of the stock is averaged with the cost of the merchandise.
+ * @param stock Stock to add to.
+ * @param quantity Quantity to add.
+ * @param cost Average cost of a unit of the merchandise.
+ */
+void merge(station::Stock& stock, const types::quantity quantity, const types::money cost) {
+    if (!quantity) return;
+
+    stock.cost = merchandises::averageCost(stock.quantity, stock.cost, quantity, cost);
+    stock.quantity += quantity;
+}
+
+/**
+ * Get the index of a merch in the catalog.
+ * @param merch Merch to consider.
+ * @return Index of the merch.
+ */
+std::size_t getIndex(const merchandises::Merch& merch) {
+    return catalogs::getMerchs().getIndex(merch.getId());
+}
+
+}
+
+station::Warehouse::Warehouse() :
+    stocks() {}
+
+station::Stock& station::Warehouse::getStock(const merchandises::Merch& merch) {
+    std::size_t index = getIndex(merch);
+
+    if (index >= stocks.size()) stocks.resize(index + 1, Stock{0, 0});
+
+    return stocks[index];
+}
+
+const station::Stock* station::Warehouse::findStock(const merchandises::Merch& merch) const {
+    std::size_t index = getIndex(merch);
+    return index < stocks.size() ? &stocks[index] : nullptr;
+}
+
+void station::Warehouse::add(const std::vector<Stock>& others) {
+    TRACE_SCOPE("Warehouse::add");
+
+    if (others.size() > stocks.size()) stocks.resize(others.size(), Stock{0, 0});
+
+    for (std::size_t index = 0; index < others.size(); index++) {
+        merge(stocks[index], others[index].quantity, others[index].cost);
+    }
+}
+
+void station::Warehouse::store(const merchandises::Merch& merch,
+                               const types::quantity quantity, const types::price price) {
+    merge(getStock(merch), quantity, price * merchandises::moneyScale);
+}
+
+void station::Warehouse::store(const merchandises::MerchLoad& merchLoad) {
+    merge(getStock(merchLoad.getMerch()), merchLoad.getQuantity(), merchLoad.getCost());
+}
+
+merchandises::MerchLoad station::Warehouse::take(const merchandises::Merch& merch,
+        const types::quantity quantity) {
+    if (quantity > getQuantity(merch)) throw NotEnoughStockError();
+
+    Stock& stock = getStock(merch);
+    stock.quantity -= quantity;
+
+    return merchandises::MerchLoad::atCost(merch, quantity, stock.cost);
+}
+
+types::quantity station::Warehouse::getQuantity(const merchandises::Merch& merch) const {
+    const Stock* stock = findStock(merch);
+    return stock ? stock->quantity : 0;
+}
+
+types::price station::Warehouse::getPrice(const merchandises::Merch& merch) const {
+    return getCost(merch) / merchandises::moneyScale;
+}
+
+types::money station::Warehouse::getCost(const merchandises::Merch& merch) const {
+    const Stock* stock = findStock(merch);
+    return stock ? stock->cost : 0;
+}
+
+types::quantity station::Warehouse::unloadTrain(train::Train& train) {
+    TRACE_SCOPE("Warehouse::unloadTrain");
+
+    // gather the cargo of the train, by index of merch
+    std::vector<types::quantity> cargo;
+
+    for (std::size_t position = 0; position < train.getSize(); position++) {
+        auto car = dynamic_cast<const cars::LoadCar*>(&train.get(train.getHandleAt(position)));
+
+        if (!car || car->isDestroyed() || car->isEmpty()) continue;
+
+        std::size_t index = getIndex(car->getMerchLoad()->getMerch());
+
+        if (index >= cargo.size()) cargo.resize(index + 1, 0);
+
+        cargo[index] += car->getQuantity();
+    }
+
+    // take each merch at once, all merchs being known
+    const catalogs::MerchCatalog& merchs = catalogs::getMerchs();
+    std::vector<Stock> unloaded(cargo.size(), Stock{0, 0});
+    types::quantity total = 0;
+
+    for (std::size_t index = 0; index < cargo.size(); index++) {
+        if (!cargo[index]) continue;
+
+        merchandises::MerchLoad sold = train.sell(merchs.get(index), cargo[index]);
+        unloaded[index] = Stock{sold.getQuantity(), sold.getCost()};
+        total += sold.getQuantity();
+    }
+
+    add(unloaded);
+
+    return total;
+}
+
+void station::Warehouse::loadTrain(train::Train& train, const merchandises::Merch& merch,
+                                   const types::quantity quantity) {
+    TRACE_SCOPE("Warehouse::loadTrain");
+
+    if (quantity > getQuantity(merch)) throw NotEnoughStockError();
+
+    Stock& stock = getStock(merch);
+    merchandises::MerchLoad merchLoad = merchandises::MerchLoad::atCost(merch, stock.quantity,
+                                        stock.cost);
+    train.buy(merchLoad, quantity);
+    stock.quantity = merchLoad.getQuantity();
+}
+
+void station::Warehouse::moveTo(Warehouse& other) {
+    if (&other == this) return;
+
+    other.add(stocks);
+    std::fill(stocks.begin(), stocks.end(), Stock{0, 0});
+}
+
+std::size_t station::Warehouse::getMemoryUsage() const {
+    return sizeof(*this) + stocks.capacity() * sizeof(Stock);
+}
@@ -1,32 +1,119 @@
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 #include "gameplay/train/cars.hpp"
+#include "tools/arena.hpp"
+#include "tools/hash.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Insulation of the cars, in hours.
+ */
+const float baseInsulation = 4;
+
+/**
+ * Insulation of the cars carrying drinkable liquids, in hours.
+ * Tanks are lagged to keep liquids from freezing.
+ */
+const float tankInsulation = 12;
+
+/**
+ * Insulation of the cars carrying living vegetals, in hours.
+ * Greenhouses are heated and keep their warmth long.
+ */
+const float greenhouseInsulation = 24;
+
+/**
+ * Get the insulation of a car.
+ * @param merchType Type of merch accepted in the car.
+ * @return Insulation, in hours.
+ */
+float getInsulation(const merchandises::MerchTypes merchType) {
+    switch (merchType) {
+        case merchandises::MerchTypes::drinkable:
+            return tankInsulation;
+
+        case merchandises::MerchTypes::vegetal:
+            return greenhouseInsulation;
+
+        default:
+            return baseInsulation;
+    }
+}
+
+/**
+ * Get cold data of a car.
+ * Cold data are created once per model and shared by all the cars of the
+ * model, so that creating a car, for instance in the arena of a train, does
+ * not allocate them on the heap again.
+ * @param id ID of the car.
+ * @param name Human-readable name of the car.
+ * @param maxQuantity Capacity of the car.
+ * @param merchType Type of merch accepted in the car.
+ * @return Cold data.
+ */
+std::shared_ptr<const cars::CarInfo> makeInfo(const types::id id, const std::string& name,
+        const types::quantity maxQuantity = 0,
+        const merchandises::MerchTypes merchType = merchandises::nullMerchType) {
+    static std::mutex mutex;
+    static std::unordered_multimap<types::id, std::shared_ptr<const cars::CarInfo>> infos;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto range = infos.equal_range(id);
+
+    // look up by ID first, so that no key is built
+    for (auto it = range.first; it != range.second; it++) {
+        const cars::CarInfo& info = *it->second;
+
+        if (info.name == name && info.maxQuantity == maxQuantity && info.merchType == merchType) {
+            return it->second;
+        }
+    }
+
+    cars::CarInfo info = {id, name, maxQuantity, merchType, getInsulation(merchType)};
+    auto shared = std::make_shared<const cars::CarInfo>(info);
+    infos.emplace(id, shared);
+    return shared;
+}
+
+}
 
 types::id cars::Car::latestCarId = 0;
 
 const types::health cars::Car::maxHealth = 100;
 
 cars::Car::Car() :
-    carId(++latestCarId), id(0), name(""), health(maxHealth), weight(0) {}
+    Car(makeInfo(0, ""), maxHealth, 0) {}
 
 cars::Car::Car(const types::id id, const std::string name, const types::health health,
                const types::weight weight) :
-    carId(++latestCarId), id(id), name(name), health(health), weight(weight) {}
+    Car(makeInfo(id, name), health, weight) {}
 
 cars::Car::Car(const types::id id, const std::string name, const types::weight weight) :
-    carId(++latestCarId), id(id), name(name), health(maxHealth), weight(weight) {}
+    Car(makeInfo(id, name), maxHealth, weight) {}
+
+cars::Car::Car(const std::shared_ptr<const CarInfo>& info, const types::health health,
+               const types::weight weight) :
+    carId(++latestCarId), observer(nullptr), observerKey(0), changes(Change::none),
+    observedHash(0), region(nullptr), state({weight, 0, 0, health, 0}), info(info) {}
 
 cars::Car::Car(const Car& car) :
-    carId(++latestCarId), id(car.id), name(car.name), health(car.health), weight(car.weight) {}
+    carId(++latestCarId), observer(nullptr), observerKey(0), changes(Change::none),
+    observedHash(0), region(nullptr), state(car.state), info(car.info) {}
 
 types::id cars::Car::getCarId() const {
     return carId;
 }
 
 types::id cars::Car::getId() const {
-    return id;
+    return info->id;
 }
 
 std::string cars::Car::getName() const {
-    return name;
+    return info->name;
 }
 
 types::health cars::Car::getMaxHealth() const {
@@ -34,33 +121,140 @@ types::health cars::Car::getMaxHealth() const {
 }
 
 types::health cars::Car::getHealth() const {
-    return health;
+    return state.health;
+}
+
+float cars::Car::getInsulation() const {
+    return info->insulation;
 }
 
 bool cars::Car::isDestroyed() const {
-    return health <= 0;
+    return state.health <= 0;
 }
 
 void cars::Car::takeDammage(types::health attack) {
     if (isDestroyed()) return;
 
-    health -= attack;
+    state.health -= attack;
+    notifyChanged(Change::health);
 }
 
 void cars::Car::repair() {
     // impossible if the car is destroyed
     if (isDestroyed()) throw DestroyedCarError();
 
-    health = maxHealth;
+    state.health = maxHealth;
+    notifyChanged(Change::health);
+}
+
+void cars::Car::repair(const types::health points) {
+    // impossible if the car is destroyed
+    if (isDestroyed()) throw DestroyedCarError();
+
+    if (points <= 0) return;
+
+    state.health = std::min<int>(state.health + points, maxHealth);
+    notifyChanged(Change::health);
+}
+
+cars::CarObserver* cars::Car::getObserver() const {
+    return observer;
+}
+
+void cars::Car::setObserver(CarObserver* otherObserver, const std::uint32_t key) {
+    observer = otherObserver;
+    observerKey = key;
+}
+
+std::uint32_t cars::Car::getObserverKey() const {
+    return observerKey;
+}
+
+const cars::CarState& cars::Car::getState() const {
+    return state;
+}
+
+const std::shared_ptr<const cars::CarInfo>& cars::Car::getInfo() const {
+    return info;
+}
+
+arena::Arena* cars::Car::getArena() const {
+    return region;
+}
+
+void cars::Car::setArena(arena::Arena* otherArena) {
+    region = otherArena;
+}
+
+std::size_t cars::Car::getMemoryUsage() const {
+    return sizeof(*this);
+}
+
+cars::Change cars::Car::getChanges() const {
+    return changes;
+}
+
+bool cars::Car::isDirty() const {
+    return changes != Change::none;
+}
+
+void cars::Car::addChanges(const Change change) {
+    changes = changes | change;
+}
+
+void cars::Car::clearChanges() {
+    changes = Change::none;
+}
+
+std::uint64_t cars::Car::computeHash() const {
+    return hash::combine(info->id, static_cast<std::uint16_t>(state.health));
+}
+
+std::uint64_t cars::Car::getObservedHash() const {
+    return observedHash;
+}
+
+void cars::Car::setObservedHash(const std::uint64_t hash) {
+    observedHash = hash;
+}
+
+void cars::Car::notifyChanged(const Change change) {
+    if (observer) observer->onCarChanged(*this, change);
+}
+
+cars::Locomotive::Locomotive() :
+    SpecialCar() {}
+
+cars::Locomotive::Locomotive(const types::id id, const std::string name,
+                             const types::health health, const types::weight weight,
+                             const types::power power) :
+    SpecialCar(id, name, health, weight) {
+    state.power = power;
+}
+
+cars::Locomotive::Locomotive(const types::id id, const std::string name,
+                             const types::weight weight, const types::power power) :
+    SpecialCar(id, name, weight) {
+    state.power = power;
+}
+
+types::power cars::Locomotive::getPower() const {
+    // a destroyed engine does not pull anything
+    if (isDestroyed()) return 0;
+
+    return state.power;
+}
+
+types::weight cars::Locomotive::getWeight() const {
+    return state.weight;
 }
 
 types::weight cars::NormalCar::getWeight() const {
-    return weight;
+    return state.weight;
 }
 
 cars::LoadCar::LoadCar() :
-    Car(), maxQuantity(0), merchType(merchandises::nullMerchType),
-    merchLoad() {}
+    Car(makeInfo(0, ""), maxHealth, 0), merchLoad() {}
 
 cars::LoadCar::LoadCar(const types::id id,
                        const std::string name,
@@ -69,9 +263,7 @@ cars::LoadCar::LoadCar(const types::id id,
                        const types::quantity maxQuantity,
                        const merchandises::MerchTypes merchType,
                        merchandises::MerchLoad& otherMerchLoad) :
-    Car(id, name, health, weight), maxQuantity(maxQuantity), merchType(merchType), merchLoad() {
-    setMerchLoad(otherMerchLoad);
-}
+    LoadCar(makeInfo(id, name, maxQuantity, merchType), health, weight, otherMerchLoad) {}
 
 cars::LoadCar::LoadCar(const types::id id,
                        const std::string name,
@@ -80,8 +272,7 @@ cars::LoadCar::LoadCar(const types::id id,
                        const types::quantity maxQuantity,
                        const merchandises::MerchTypes merchType,
                        std::shared_ptr<merchandises::MerchLoad>& otherMerchLoad) :
-    Car(id, name, health, weight), maxQuantity(maxQuantity), merchType(merchType),
-    merchLoad() {
+    LoadCar(makeInfo(id, name, maxQuantity, merchType), health, weight) {
     setMerchLoad(otherMerchLoad);
 }
 
@@ -91,8 +282,7 @@ cars::LoadCar::LoadCar(const types::id id,
                        const types::weight weight,
                        const types::quantity maxQuantity,
                        const merchandises::MerchTypes merchType) :
-    Car(id, name, health, weight), maxQuantity(maxQuantity), merchType(merchType),
-    merchLoad() {}
+    LoadCar(makeInfo(id, name, maxQuantity, merchType), health, weight) {}
 
 cars::LoadCar::LoadCar(const types::id id,
                        const std::string name,
@@ -100,9 +290,7 @@ cars::LoadCar::LoadCar(const types::id id,
                        const types::quantity maxQuantity,
                        const merchandises::MerchTypes merchType,
                        merchandises::MerchLoad& otherMerchLoad) :
-    Car(id, name, weight), maxQuantity(maxQuantity), merchType(merchType), merchLoad() {
-    setMerchLoad(otherMerchLoad);
-}
+    LoadCar(makeInfo(id, name, maxQuantity, merchType), maxHealth, weight, otherMerchLoad) {}
 
 cars::LoadCar::LoadCar(const types::id id,
                        const std::string name,
@@ -110,8 +298,7 @@ cars::LoadCar::LoadCar(const types::id id,
                        const types::quantity maxQuantity,
                        const merchandises::MerchTypes merchType,
                        std::shared_ptr<merchandises::MerchLoad>& otherMerchLoad) :
-    Car(id, name, weight), maxQuantity(maxQuantity), merchType(merchType),
-    merchLoad() {
+    LoadCar(makeInfo(id, name, maxQuantity, merchType), maxHealth, weight) {
     setMerchLoad(otherMerchLoad);
 }
 
@@ -120,41 +307,85 @@ cars::LoadCar::LoadCar(const types::id id,
                        const types::weight weight,
                        const types::quantity maxQuantity,
                        const merchandises::MerchTypes merchType) :
-    Car(id, name, weight), maxQuantity(maxQuantity), merchType(merchType),
-    merchLoad() {}
+    LoadCar(makeInfo(id, name, maxQuantity, merchType), maxHealth, weight) {}
 
-void cars::LoadCar::setMerchLoad(const merchandises::MerchLoad& otherMerchLoad) {
-    setMerchLoad(std::make_shared<merchandises::MerchLoad>(std::move(otherMerchLoad)));
+cars::LoadCar::LoadCar(const std::shared_ptr<const CarInfo>& info, const types::health health,
+                       const types::weight weight) :
+    Car(info, health, weight), merchLoad() {}
+
+cars::LoadCar::LoadCar(const std::shared_ptr<const CarInfo>& info, const types::health health,
+                       const types::weight weight, merchandises::MerchLoad& otherMerchLoad) :
+    Car(info, health, weight), merchLoad() {
+    setMerchLoad(otherMerchLoad);
 }
 
-void cars::LoadCar::setMerchLoad(const std::shared_ptr<merchandises::MerchLoad>& otherMerchLoad) {
+cars::LoadCar::LoadCar(const LoadCar& car) :
+    Car(car), merchLoad() {
+    // the load is copied, so that each car keeps its hot state in sync
+    if (car.merchLoad) {
+        merchLoad = arena::makeShared<merchandises::MerchLoad>(region, *car.merchLoad);
+    }
+}
+
+void cars::LoadCar::updateQuantity() {
+    state.quantity = merchLoad ? merchLoad->getQuantity() : 0;
+    state.value = merchLoad ? merchLoad->getValue() : 0;
+}
+
+void cars::LoadCar::setMerchLoad(const merchandises::MerchLoad& otherMerchLoad) {
     // do not set merch load if the load is empty
-    if (!otherMerchLoad->getQuantity()) return;
+    if (!otherMerchLoad.getQuantity()) return;
 
     // check there is enouth place in the car
-    if (otherMerchLoad->getQuantity() > maxQuantity) throw NotEnoughSpaceError();
+    if (otherMerchLoad.getQuantity() > info->maxQuantity) throw NotEnoughSpaceError();
 
     // load the merch on board
-    merchLoad = otherMerchLoad;
+    merchLoad = arena::makeShared<merchandises::MerchLoad>(region, otherMerchLoad);
+    updateQuantity();
+    notifyChanged(Change::load);
+}
+
+void cars::LoadCar::setMerchLoad(const std::shared_ptr<merchandises::MerchLoad>& otherMerchLoad) {
+    setMerchLoad(*otherMerchLoad);
+}
+
+std::size_t cars::LoadCar::getMemoryUsage() const {
+    std::size_t memory = sizeof(*this);
+
+    // the load is only counted if the car owns it alone
+    if (merchLoad && merchLoad.use_count() == 1) memory += sizeof(merchandises::MerchLoad);
+
+    return memory;
+}
+
+std::uint64_t cars::LoadCar::computeHash() const {
+    std::uint64_t carHash = Car::computeHash();
+
+    // nothing more if the car is empty
+    if (!merchLoad) return carHash;
+
+    carHash = hash::combine(carHash, merchLoad->getMerch().getId());
+    carHash = hash::combine(carHash, merchLoad->getQuantity());
+    return hash::combine(carHash, merchLoad->getCost());
 }
 
 types::weight cars::LoadCar::getWeight() const {
     // base weight if car is destroyed
-    if (isDestroyed()) return weight;
+    if (isDestroyed()) return state.weight;
 
     // base weight if car is empty
-    if (isEmpty()) return weight;
+    if (isEmpty()) return state.weight;
 
     // base weight + load weight
     // 1 quantity is 1 ton
-    return weight + getQuantity();
+    return state.weight + getQuantity();
 }
 
 types::quantity cars::LoadCar::getMaxQuantity() const {
     // impossible if the car is destroyed
     if (isDestroyed()) throw DestroyedCarError();
 
-    return maxQuantity;
+    return info->maxQuantity;
 }
 
 types::quantity cars::LoadCar::getQuantity() const {
@@ -171,19 +402,19 @@ types::quantity cars::LoadCar::getRemainingQuantity() const {
     // impossible if the car is destroyed
     if (isDestroyed()) throw DestroyedCarError();
 
-    if (isEmpty()) return maxQuantity;
+    if (isEmpty()) return info->maxQuantity;
 
-    return maxQuantity - getQuantity();
+    return info->maxQuantity - getQuantity();
 }
 
 merchandises::MerchTypes cars::LoadCar::getMerchType() const {
     // impossible if the car is destroyed
     if (isDestroyed()) throw DestroyedCarError();
 
-    return merchType;
+    return info->merchType;
 }
 
-std::shared_ptr<merchandises::MerchLoad> cars::LoadCar::getMerchLoad() {
+std::shared_ptr<const merchandises::MerchLoad> cars::LoadCar::getMerchLoad() const {
     // impossible if the car is destroyed
     if (isDestroyed()) throw DestroyedCarError();
 
@@ -209,16 +440,19 @@ bool cars::LoadCar::isFull() const {
 }
 
 bool cars::LoadCar::canLoad(const merchandises::MerchLoad& otherMerchLoad) const {
-    // copy the merch load
-    return canLoad(std::make_shared<merchandises::MerchLoad>(otherMerchLoad));
+    return canLoad(otherMerchLoad.getMerch());
 }
 
 bool cars::LoadCar::canLoad(const std::shared_ptr<merchandises::MerchLoad>& otherMerchLoad) const {
+    return canLoad(*otherMerchLoad);
+}
+
+bool cars::LoadCar::canLoad(const merchandises::Merch& merch) const {
     // no if the car is destroyed
     if (isDestroyed()) return false;
 
     // no if the merch type are different
-    if (otherMerchLoad->getMerch().getType() != getMerchType()) return false;
+    if (merch.getType() != getMerchType()) return false;
 
     // yes if the car is empty
     if (isEmpty()) return true;
@@ -227,26 +461,21 @@ bool cars::LoadCar::canLoad(const std::shared_ptr<merchandises::MerchLoad>& othe
     if (isFull()) return false;
 
     // if the car contains the same merch
-    return merchLoad->getMerch() == otherMerchLoad->getMerch();
+    return merchLoad->getMerch() == merch;
 }
 
 void cars::LoadCar::load(merchandises::MerchLoad& otherMerchLoad) {
     load(otherMerchLoad, otherMerchLoad.getQuantity());
 }
 
-void cars::LoadCar::load(merchandises::MerchLoad& otherMerchLoad, const types::quantity quantity) {
-    // copy the merch load in a teporary shared pointer
-    std::shared_ptr<merchandises::MerchLoad> otherMerchLoadTemp =
-        std::make_shared<merchandises::MerchLoad>(otherMerchLoad);
-
-    load(otherMerchLoadTemp, quantity);
-
-    // update the merch load
-    otherMerchLoad.substract(quantity);
-}
-
 void cars::LoadCar::load(std::shared_ptr<merchandises::MerchLoad>& otherMerchLoad,
                          const types::quantity quantity) {
+    load(*otherMerchLoad, quantity);
+}
+
+void cars::LoadCar::load(merchandises::MerchLoad& otherMerchLoad, const types::quantity quantity) {
+    TRACE_SCOPE("LoadCar::load");
+
     // impossible if the car is destroyed
     if (isDestroyed()) throw DestroyedCarError();
 
@@ -257,18 +486,23 @@ void cars::LoadCar::load(std::shared_ptr<merchandises::MerchLoad>& otherMerchLoa
     if (getRemainingQuantity() < quantity) throw NotEnoughSpaceError();
 
     // prepare to load it to the car
-    auto toLoadMerchLoad = otherMerchLoad->split(quantity);
+    auto toLoadMerchLoad = otherMerchLoad.split(quantity);
 
     if (isEmpty()) {
         // if the car is empty, load it with the new merch load
-        merchLoad = std::make_shared<merchandises::MerchLoad>(std::move(toLoadMerchLoad));
+        merchLoad = arena::makeShared<merchandises::MerchLoad>(region, toLoadMerchLoad);
     } else {
         // otherwise load more merch load
         merchLoad->add(toLoadMerchLoad);
     }
+
+    updateQuantity();
+    notifyChanged(Change::load);
 }
 
 merchandises::MerchLoad cars::LoadCar::unLoad(const types::quantity quantity) {
+    TRACE_SCOPE("LoadCar::unLoad");
+
     // impossible if the car is destroyed
     if (isDestroyed()) throw DestroyedCarError();
 
@@ -281,22 +515,83 @@ merchandises::MerchLoad cars::LoadCar::unLoad(const types::quantity quantity) {
     // check emptyness
     if (getQuantity() == 0) merchLoad.reset();
 
+    updateQuantity();
+    notifyChanged(Change::load);
+
     return toUnloadMerchLoad;
 }
 
+void cars::LoadCar::transfer(LoadCar& destination, const types::quantity quantity) {
+    TRACE_SCOPE("LoadCar::transfer");
+
+    // impossible if one of the cars is destroyed
+    if (isDestroyed() || destination.isDestroyed()) throw DestroyedCarError();
+
+    if (!quantity || &destination == this) return;
+
+    // check both cars once
+    if (quantity > getQuantity()) throw NotEnoughLoadError();
+
+    const merchandises::Merch& merch = merchLoad->getMerch();
+
+    if (!destination.canLoad(merch)) throw CannotLoadError();
+
+    if (destination.getRemainingQuantity() < quantity) throw NotEnoughSpaceError();
+
+    types::quantity remaining = getQuantity() - quantity;
+    types::money cost = merchLoad->getCost();
+
+    if (!destination.isEmpty()) {
+        destination.merchLoad->addAtCost(quantity, cost);
+    } else if (!remaining && destination.region == region) {
+        // hand the whole load over
+        destination.merchLoad = std::move(merchLoad);
+    } else {
+        destination.merchLoad = arena::makeShared<merchandises::MerchLoad>(destination.region,
+                                merchandises::MerchLoad::atCost(merch, quantity, cost));
+    }
+
+    if (!remaining) {
+        merchLoad.reset();
+    } else {
+        merchLoad->restore(remaining, cost);
+    }
+
+    updateQuantity();
+    destination.updateQuantity();
+    notifyChanged(Change::load);
+    destination.notifyChanged(Change::load);
+}
+
+void cars::LoadCar::restoreLoad(const merchandises::Merch& merch,
+                                const types::quantity quantity,
+                                const types::money cost) {
+    if (!quantity) {
+        merchLoad.reset();
+    } else if (!merchLoad) {
+        merchLoad = arena::makeShared<merchandises::MerchLoad>(region,
+                    merchandises::MerchLoad::atCost(merch, quantity, cost));
+    } else {
+        merchLoad->restore(quantity, cost);
+    }
+
+    updateQuantity();
+    notifyChanged(Change::load);
+}
+
 cars::LoadCar cars::LoadCarModel::operator()(types::health requestedHealth,
         merchandises::MerchLoad& requestedMerchLoad) const {
-    return LoadCar(id, name, requestedHealth, weight, maxQuantity, merchType, requestedMerchLoad);
+    return LoadCar(info, requestedHealth, state.weight, requestedMerchLoad);
 }
 
 cars::LoadCar cars::LoadCarModel::operator()(types::health requestedHealth) const {
-    return LoadCar(id, name, requestedHealth, weight, maxQuantity, merchType);
+    return LoadCar(info, requestedHealth, state.weight);
 }
 
 cars::LoadCar cars::LoadCarModel::operator()(merchandises::MerchLoad& requestedMerchLoad) const {
-    return LoadCar(id, name, weight, maxQuantity, merchType, requestedMerchLoad);
+    return LoadCar(info, maxHealth, state.weight, requestedMerchLoad);
 }
 
 cars::LoadCar cars::LoadCarModel::operator()() const {
-    return LoadCar(id, name, weight, maxQuantity, merchType);
+    return LoadCar(info, maxHealth, state.weight);
 }
@@ -0,0 +1,109 @@
+#include "gameplay/train/catalogs.hpp"
+
+namespace {
+
+/**
+ * Get the name of a row of a table.
+ */
+#define CATALOGS_NAME(variable, id, name, ...) name,
+
+/**
+ * Get the ID of a row of a table.
+ */
+#define CATALOGS_ID(variable, id, name, ...) id,
+
+/**
+ * Names of the built-in merchs.
+ */
+constexpr const char* merchNames[] = {MERCHANDISES_TABLE(CATALOGS_NAME)};
+
+/**
+ * IDs of the built-in merchs.
+ */
+constexpr types::id merchIds[] = {MERCHANDISES_TABLE(CATALOGS_ID)};
+
+/**
+ * Names of the built-in load car models.
+ */
+constexpr const char* carModelNames[] = {CARS_TABLE(CATALOGS_NAME)};
+
+/**
+ * IDs of the built-in load car models.
+ */
+constexpr types::id carModelIds[] = {CARS_TABLE(CATALOGS_ID)};
+
+#undef CATALOGS_NAME
+#undef CATALOGS_ID
+
+/**
+ * Number of built-in merchs.
+ */
+constexpr std::size_t merchCount = sizeof(merchIds) / sizeof(merchIds[0]);
+
+/**
+ * Number of built-in load car models.
+ */
+constexpr std::size_t carModelCount = sizeof(carModelIds) / sizeof(carModelIds[0]);
+
+/**
+ * Seed of the names of the built-in merchs.
+ */
+constexpr std::uint64_t merchNameSeed = catalog::findSeed(merchNames, merchCount);
+
+/**
+ * Seed of the IDs of the built-in merchs.
+ */
+constexpr std::uint64_t merchIdSeed = catalog::findSeed(merchIds, merchCount);
+
+/**
+ * Seed of the names of the built-in load car models.
+ */
+constexpr std::uint64_t carModelNameSeed = catalog::findSeed(carModelNames, carModelCount);
+
+/**
+ * Seed of the IDs of the built-in load car models.
+ */
+constexpr std::uint64_t carModelIdSeed = catalog::findSeed(carModelIds, carModelCount);
+
+static_assert(merchNameSeed != catalog::noSeed, "Merch names must be unique");
+static_assert(merchIdSeed != catalog::noSeed, "Merch IDs must be unique");
+static_assert(carModelNameSeed != catalog::noSeed, "Car model names must be unique");
+static_assert(carModelIdSeed != catalog::noSeed, "Car model IDs must be unique");
+
+}
+
+catalogs::MerchCatalog& catalogs::getMerchs() {
+    // the catalog owns its copies, built-in variables may not be created yet
+    static MerchCatalog merchs([]() {
+        std::vector<std::unique_ptr<merchandises::Merch>> builtIns;
+
+#define CATALOGS_MERCH(variable, id, name, type) \
+        builtIns.emplace_back(new merchandises::Merch(id, name, merchandises::MerchTypes::type));
+
+        MERCHANDISES_TABLE(CATALOGS_MERCH)
+
+#undef CATALOGS_MERCH
+
+        return builtIns;
+    }(), merchNameSeed, merchIdSeed);
+
+    return merchs;
+}
+
+catalogs::CarModelCatalog& catalogs::getCarModels() {
+    static CarModelCatalog carModels([]() {
+        std::vector<std::unique_ptr<cars::LoadCarModel>> builtIns;
+
+#define CATALOGS_CAR(variable, id, name, weight, maxQuantity, type) \
+        builtIns.emplace_back(new cars::LoadCarModel(id, name, weight, maxQuantity, \
+                              merchandises::MerchTypes::type));
+
+        CARS_TABLE(CATALOGS_CAR)
+
+#undef CATALOGS_CAR
+
+        return builtIns;
+    }(), carModelNameSeed, carModelIdSeed);
+
+    return carModels;
+}
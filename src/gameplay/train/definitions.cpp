@@ -0,0 +1,606 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gameplay/train/definitions.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Magic number of cache files.
+ */
+const char magic[8] = {'T', 'R', 'C', 'A', 'T', 'A', 'L', 'G'};
+
+/**
+ * Version of the format of cache files.
+ * Also tells apart platforms with another byte order.
+ */
+const std::uint32_t version = 1;
+
+/**
+ * Header of cache files.
+ */
+struct Header {
+    /**
+     * Magic number.
+     */
+    char magic[8];
+
+    /**
+     * Version of the format.
+     */
+    std::uint32_t version;
+
+    /**
+     * Number of merchs.
+     */
+    std::uint32_t merchCount;
+
+    /**
+     * Number of car models.
+     */
+    std::uint32_t carModelCount;
+
+    /**
+     * Size of the names, in bytes.
+     */
+    std::uint32_t namesSize;
+
+    /**
+     * Size of the text file.
+     */
+    std::uint64_t sourceSize;
+
+    /**
+     * Modification time of the text file, in nanoseconds.
+     */
+    std::int64_t sourceTime;
+};
+
+/**
+ * Merch in cache files.
+ */
+struct MerchRecord {
+    /**
+     * ID of the merch.
+     */
+    std::uint32_t id;
+
+    /**
+     * Offset of the name in the names.
+     */
+    std::uint32_t nameOffset;
+
+    /**
+     * Size of the name.
+     */
+    std::uint32_t nameSize;
+
+    /**
+     * Type of the merch.
+     */
+    std::uint32_t type;
+};
+
+/**
+ * Car model in cache files.
+ */
+struct CarModelRecord {
+    /**
+     * ID of the model.
+     */
+    std::uint32_t id;
+
+    /**
+     * Offset of the name in the names.
+     */
+    std::uint32_t nameOffset;
+
+    /**
+     * Size of the name.
+     */
+    std::uint32_t nameSize;
+
+    /**
+     * Type of merch of the model.
+     */
+    std::uint32_t type;
+
+    /**
+     * Weight of the model.
+     */
+    float weight;
+
+    /**
+     * Maximum quantity of the model.
+     */
+    std::uint32_t maxQuantity;
+};
+
+static_assert(sizeof(Header) == 40, "Cache header must not be padded");
+static_assert(sizeof(MerchRecord) == 16, "Merch records must not be padded");
+static_assert(sizeof(CarModelRecord) == 24, "Car model records must not be padded");
+
+/**
+ * Names of the types of merchs, by value.
+ */
+const char* const typeNames[] = {"null", "box", "drinkable", "toxic", "vegetal"};
+
+/**
+ * Number of types of merchs.
+ */
+const std::uint32_t typeCount = sizeof(typeNames) / sizeof(typeNames[0]);
+
+/**
+ * Definitions in the layout of cache files.
+ */
+struct Image {
+    /**
+     * Header.
+     */
+    Header header;
+
+    /**
+     * Merchs.
+     */
+    std::vector<MerchRecord> merchs;
+
+    /**
+     * Car models.
+     */
+    std::vector<CarModelRecord> carModels;
+
+    /**
+     * Names, one after the other.
+     */
+    std::string names;
+};
+
+/**
+ * Stamp of the text file.
+ */
+struct Stamp {
+    /**
+     * Size of the file.
+     */
+    std::uint64_t size;
+
+    /**
+     * Modification time of the file, in nanoseconds.
+     */
+    std::int64_t time;
+};
+
+/**
+ * Read-only memory mapping of a file.
+ */
+class MappedFile {
+    /**
+     * Start of the mapping.
+     */
+    const char* data;
+
+    /**
+     * Size of the mapping.
+     */
+    std::size_t size;
+
+  public:
+
+    /**
+     * Usual constructor.
+     * The mapping is empty if the file cannot be mapped.
+     * @param path Path of the file.
+     */
+    explicit MappedFile(const std::string& path) :
+        data(nullptr), size(0) {
+        int descriptor = open(path.c_str(), O_RDONLY);
+
+        if (descriptor < 0) return;
+
+        struct stat status;
+
+        if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+            void* mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const char*>(mapping);
+                size = status.st_size;
+            }
+        }
+
+        // the mapping stays valid after closing
+        close(descriptor);
+    }
+
+    /**
+     * Mappings cannot be copied.
+     */
+    MappedFile(const MappedFile&) = delete;
+
+    /**
+     * Mappings cannot be copied.
+     */
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~MappedFile() {
+        if (data) munmap(const_cast<char*>(data), size);
+    }
+
+    /**
+     * Getter for data.
+     * @return Start of the mapping, or null pointer if empty.
+     */
+    const char* getData() const {
+        return data;
+    }
+
+    /**
+     * Getter for size.
+     * @return Size of the mapping.
+     */
+    std::size_t getSize() const {
+        return size;
+    }
+};
+
+/**
+ * Get the stamp of a file.
+ * @param path Path of the file.
+ * @return Stamp.
+ * @throw definitions::FileError If the file does not exist.
+ */
+Stamp getStamp(const std::string& path) {
+    struct stat status;
+
+    if (stat(path.c_str(), &status) != 0) throw definitions::FileError();
+
+    return {static_cast<std::uint64_t>(status.st_size),
+            static_cast<std::int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec
+           };
+}
+
+/**
+ * Parse a type of merch.
+ * @param name Name of the type.
+ * @return Value of the type, or the number of types if unknown.
+ */
+std::uint32_t parseType(const std::string& name) {
+    // the null type cannot be defined
+    for (std::uint32_t type = 1; type < typeCount; type++) {
+        if (name == typeNames[type]) return type;
+    }
+
+    return typeCount;
+}
+
+/**
+ * Read the next argument of a definition.
+ * @param stream Stream of the line, at the argument.
+ * @param line Number of the line.
+ * @return Value of the argument.
+ */
+template <typename T>
+T readArgument(std::istringstream& stream, const std::size_t line) {
+    T value;
+
+    if (!(stream >> value)) {
+        throw definitions::DefinitionError(line, "missing or invalid argument");
+    }
+
+    return value;
+}
+
+/**
+ * Read a name, quoted if it has spaces.
+ * @param stream Stream of the line, at the name.
+ * @param line Number of the line.
+ * @return Name, without quotes.
+ */
+std::string readName(std::istringstream& stream, const std::size_t line) {
+    std::string word = readArgument<std::string>(stream, line);
+
+    if (word[0] != '"') return word;
+
+    // gather the words up to the closing quote
+    while (word.size() < 2 || word.back() != '"') {
+        std::string next;
+
+        if (!(stream >> next)) throw definitions::DefinitionError(line, "missing quote");
+
+        word += " " + next;
+    }
+
+    return word.substr(1, word.size() - 2);
+}
+
+/**
+ * Parse definitions.
+ * @param stream Stream to read the definitions from.
+ * @param stamp Stamp of the text file.
+ * @return Definitions in the layout of cache files.
+ */
+Image compile(std::istream& stream, const Stamp& stamp) {
+    Image image;
+    std::memset(&image.header, 0, sizeof(image.header));
+    std::memcpy(image.header.magic, magic, sizeof(magic));
+    image.header.version = version;
+    image.header.sourceSize = stamp.size;
+    image.header.sourceTime = stamp.time;
+
+    std::string text;
+    std::size_t line = 0;
+
+    while (std::getline(stream, text)) {
+        line++;
+        std::istringstream lineStream(text);
+        std::string command;
+
+        // skip empty lines and comments
+        if (!(lineStream >> command) || command[0] == '#') continue;
+
+        if (command != "merch" && command != "car") {
+            throw definitions::DefinitionError(line, "unknown definition " + command);
+        }
+
+        auto id = readArgument<types::id>(lineStream, line);
+        std::string name = readName(lineStream, line);
+        std::uint32_t nameOffset = image.names.size();
+        std::uint32_t nameSize = name.size();
+        image.names += name;
+
+        if (command == "merch") {
+            std::uint32_t type = parseType(readArgument<std::string>(lineStream, line));
+
+            if (type == typeCount) throw definitions::DefinitionError(line, "unknown type");
+
+            image.merchs.push_back({id, nameOffset, nameSize, type});
+        } else {
+            auto weight = readArgument<types::weight>(lineStream, line);
+            auto maxQuantity = readArgument<types::quantity>(lineStream, line);
+            std::uint32_t type = parseType(readArgument<std::string>(lineStream, line));
+
+            if (type == typeCount) throw definitions::DefinitionError(line, "unknown type");
+
+            image.carModels.push_back({id, nameOffset, nameSize, type, weight, maxQuantity});
+        }
+
+        std::string word;
+
+        if (lineStream >> word) throw definitions::DefinitionError(line, "too many arguments");
+    }
+
+    image.header.merchCount = image.merchs.size();
+    image.header.carModelCount = image.carModels.size();
+    image.header.namesSize = image.names.size();
+
+    return image;
+}
+
+/**
+ * Write definitions to a cache file.
+ * The file is replaced at once, so that readers never see it half written.
+ * @param image Definitions.
+ * @param path Path of the cache file.
+ */
+void writeCache(const Image& image, const std::string& path) {
+    std::string temporaryPath = path + ".tmp";
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+
+        if (!file) return;
+
+        file.write(reinterpret_cast<const char*>(&image.header), sizeof(image.header));
+        file.write(reinterpret_cast<const char*>(image.merchs.data()),
+                   image.merchs.size() * sizeof(MerchRecord));
+        file.write(reinterpret_cast<const char*>(image.carModels.data()),
+                   image.carModels.size() * sizeof(CarModelRecord));
+        file.write(image.names.data(), image.names.size());
+
+        if (!file) {
+            file.close();
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+    }
+
+    std::rename(temporaryPath.c_str(), path.c_str());
+}
+
+/**
+ * Check a cache file.
+ * @param file Mapping of the cache file.
+ * @param stamp Stamp of the text file.
+ * @return True if the cache is complete and matches the text file.
+ */
+bool checkCache(const MappedFile& file, const Stamp& stamp) {
+    Header header;
+
+    if (file.getSize() < sizeof(header)) return false;
+
+    std::memcpy(&header, file.getData(), sizeof(header));
+
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version ||
+            header.sourceSize != stamp.size || header.sourceTime != stamp.time) {
+        return false;
+    }
+
+    std::uint64_t size = sizeof(header) + header.namesSize;
+    size += static_cast<std::uint64_t>(header.merchCount) * sizeof(MerchRecord);
+    size += static_cast<std::uint64_t>(header.carModelCount) * sizeof(CarModelRecord);
+
+    return size == file.getSize();
+}
+
+/**
+ * Check a record of a cache file.
+ * @param record Record.
+ * @param namesSize Size of the names.
+ * @return True if the name and the type of the record are valid.
+ */
+template <typename Record>
+bool checkRecord(const Record& record, const std::uint32_t namesSize) {
+    return record.type > 0 && record.type < typeCount && record.nameOffset <= namesSize &&
+           record.nameSize <= namesSize - record.nameOffset;
+}
+
+/**
+ * Check records of a cache file do not reuse a name or an ID.
+ * @param records Records, possibly unaligned.
+ * @param count Number of records.
+ * @param names Names.
+ * @param catalog Catalog the records are added to.
+ * @return True if no name or ID is used twice by the records or is already
+ * used in the catalog.
+ */
+template <typename Record, typename Catalog>
+bool checkUnique(const char* records, const std::uint32_t count, const char* names,
+                 const Catalog& catalog) {
+    std::unordered_set<types::id> ids;
+    std::unordered_set<std::string> usedNames;
+
+    for (std::uint32_t index = 0; index < count; index++) {
+        Record record;
+        std::memcpy(&record, records + index * sizeof(record), sizeof(record));
+        std::string name(names + record.nameOffset, record.nameSize);
+
+        if (catalog.findById(record.id) || catalog.findByName(name)) return false;
+
+        if (!ids.insert(record.id).second || !usedNames.insert(name).second) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Add definitions to the catalogs.
+ * Works on mapped cache files and on freshly parsed definitions alike.
+ * @param header Header.
+ * @param merchRecords Merchs, possibly unaligned.
+ * @param carModelRecords Car models, possibly unaligned.
+ * @param names Names.
+ * @param merchs Catalog to add the merchs to.
+ * @param carModels Catalog to add the car models to.
+ * @return Number of entries added, or 0 if a record is invalid.
+ * @throw catalog::DuplicateEntryError If a name or an ID is already used, in
+ * which case no entry is added.
+ */
+std::size_t add(const Header& header, const char* merchRecords, const char* carModelRecords,
+                const char* names, catalogs::MerchCatalog& merchs,
+                catalogs::CarModelCatalog& carModels) {
+    TRACE_SCOPE("definitions::add");
+
+    // check all the records before adding any entry
+    for (std::uint32_t index = 0; index < header.merchCount; index++) {
+        MerchRecord record;
+        std::memcpy(&record, merchRecords + index * sizeof(record), sizeof(record));
+
+        if (!checkRecord(record, header.namesSize)) return 0;
+    }
+
+    for (std::uint32_t index = 0; index < header.carModelCount; index++) {
+        CarModelRecord record;
+        std::memcpy(&record, carModelRecords + index * sizeof(record), sizeof(record));
+
+        if (!checkRecord(record, header.namesSize)) return 0;
+    }
+
+    // so that a load is all or nothing
+    if (!checkUnique<MerchRecord>(merchRecords, header.merchCount, names, merchs) ||
+            !checkUnique<CarModelRecord>(carModelRecords, header.carModelCount, names,
+                                         carModels)) {
+        throw catalog::DuplicateEntryError();
+    }
+
+    merchs.reserve(merchs.size() + header.merchCount);
+    carModels.reserve(carModels.size() + header.carModelCount);
+
+    for (std::uint32_t index = 0; index < header.merchCount; index++) {
+        MerchRecord record;
+        std::memcpy(&record, merchRecords + index * sizeof(record), sizeof(record));
+        merchs.emplace(record.id, std::string(names + record.nameOffset, record.nameSize),
+                       static_cast<merchandises::MerchTypes>(record.type));
+    }
+
+    for (std::uint32_t index = 0; index < header.carModelCount; index++) {
+        CarModelRecord record;
+        std::memcpy(&record, carModelRecords + index * sizeof(record), sizeof(record));
+        carModels.emplace(record.id, std::string(names + record.nameOffset, record.nameSize),
+                          record.weight, record.maxQuantity,
+                          static_cast<merchandises::MerchTypes>(record.type));
+    }
+
+    return header.merchCount + header.carModelCount;
+}
+
+/**
+ * Add parsed definitions to the catalogs.
+ * @param image Definitions.
+ * @param merchs Catalog to add the merchs to.
+ * @param carModels Catalog to add the car models to.
+ * @return Number of entries added.
+ */
+std::size_t add(const Image& image, catalogs::MerchCatalog& merchs,
+                catalogs::CarModelCatalog& carModels) {
+    return add(image.header, reinterpret_cast<const char*>(image.merchs.data()),
+               reinterpret_cast<const char*>(image.carModels.data()), image.names.data(),
+               merchs, carModels);
+}
+
+}
+
+definitions::DefinitionError::DefinitionError(const std::size_t line, const std::string& reason) :
+    message("Line " + std::to_string(line) + ": " + reason) {}
+
+std::size_t definitions::loadText(std::istream& stream, catalogs::MerchCatalog& merchs,
+                                  catalogs::CarModelCatalog& carModels) {
+    return add(compile(stream, {0, 0}), merchs, carModels);
+}
+
+bool definitions::load(const std::string& path, const std::string& cachePath,
+                       catalogs::MerchCatalog& merchs, catalogs::CarModelCatalog& carModels) {
+    TRACE_SCOPE("definitions::load");
+
+    Stamp stamp = getStamp(path);
+
+    {
+        MappedFile file(cachePath);
+
+        if (checkCache(file, stamp)) {
+            Header header;
+            std::memcpy(&header, file.getData(), sizeof(header));
+            const char* merchRecords = file.getData() + sizeof(header);
+            const char* carModelRecords = merchRecords + header.merchCount * sizeof(MerchRecord);
+            const char* names = carModelRecords + header.carModelCount * sizeof(CarModelRecord);
+
+            // an empty cache is valid, other caches add entries unless corrupted
+            if (!header.merchCount && !header.carModelCount) return true;
+
+            if (add(header, merchRecords, carModelRecords, names, merchs, carModels)) return true;
+        }
+    }
+
+    std::ifstream file(path);
+
+    if (!file) throw FileError();
+
+    Image image = compile(file, stamp);
+    writeCache(image, cachePath);
+    add(image, merchs, carModels);
+
+    return false;
+}
@@ -1,6 +1,9 @@
-#include "gameplay/train/merchandises.hpp"
+#include <cstdint>
 #include <iostream>
 
+#include "gameplay/train/merchandises.hpp"
+#include "tools/trace.hpp"
+
 merchandises::Merch::Merch() :
     id(0), name("null"), type(merchandises::nullMerchType) {}
 
@@ -27,19 +30,40 @@ merchandises::MerchTypes merchandises::Merch::getType() const {
     return type;
 }
 
+types::money merchandises::averageCost(const types::quantity quantity, const types::money cost,
+                                       const types::quantity otherQuantity,
+                                       const types::money otherCost) {
+    std::uint64_t count = static_cast<std::uint64_t>(quantity) + otherQuantity;
+
+    // nothing to average
+    if (!count) return 0;
+
+    // widen the sum, then round to the nearest
+    std::uint64_t total = static_cast<std::uint64_t>(quantity) * cost +
+                          static_cast<std::uint64_t>(otherQuantity) * otherCost;
+    return (total + count / 2) / count;
+}
+
 types::id merchandises::MerchLoad::latestLoadId = 0;
 
 merchandises::MerchLoad::MerchLoad() :
-    loadId(++latestLoadId), merch(merchandises::nullMerch), quantity(0), price(0) {}
+    loadId(++latestLoadId), merch(merchandises::nullMerch), quantity(0), cost(0) {}
 
 merchandises::MerchLoad::MerchLoad(const Merch& merch,
                                    const types::quantity quantity,
                                    const types::price price) :
-    loadId(++latestLoadId), merch(merch), quantity(quantity), price(price) {}
+    loadId(++latestLoadId), merch(merch), quantity(quantity), cost(price * moneyScale) {}
 
 merchandises::MerchLoad::MerchLoad(const MerchLoad& merchLoad) :
     loadId(++latestLoadId), merch(merchLoad.merch), quantity(merchLoad.quantity),
-    price(merchLoad.price) {}
+    cost(merchLoad.cost) {}
+
+merchandises::MerchLoad merchandises::MerchLoad::atCost(const Merch& merch,
+        const types::quantity quantity, const types::money cost) {
+    MerchLoad merchLoad(merch, quantity, 0);
+    merchLoad.cost = cost;
+    return merchLoad;
+}
 
 types::id merchandises::MerchLoad::getLoadId() const {
     return loadId;
@@ -54,7 +78,15 @@ types::quantity merchandises::MerchLoad::getQuantity() const {
 }
 
 types::price merchandises::MerchLoad::getPrice() const {
-    return price;
+    return cost / moneyScale;
+}
+
+types::money merchandises::MerchLoad::getCost() const {
+    return cost;
+}
+
+types::money merchandises::MerchLoad::getValue() const {
+    return quantity * cost;
 }
 
 bool merchandises::MerchLoad::hasSameMerch(const MerchLoad& other) {
@@ -72,8 +104,15 @@ bool merchandises::MerchLoad::hasSameMerch(const Merch& otherMerch) {
 
 void merchandises::MerchLoad::add(const types::quantity otherQuantity,
                                   const types::price otherPrice) {
-    // average the price of the two loads
-    price = (quantity * price + otherQuantity * otherPrice) / (quantity + otherQuantity);
+    addAtCost(otherQuantity, otherPrice * moneyScale);
+}
+
+void merchandises::MerchLoad::addAtCost(const types::quantity otherQuantity,
+                                        const types::money otherCost) {
+    TRACE_SCOPE("MerchLoad::add");
+
+    // average the cost of the two loads
+    cost = averageCost(quantity, cost, otherQuantity, otherCost);
     quantity += otherQuantity;
 }
 
@@ -81,7 +120,7 @@ void merchandises::MerchLoad::add(const MerchLoad& other) {
     // check the merchs are the same
     if (!hasSameMerch(other)) throw NotSameMerchError();
 
-    add(other.quantity, other.price);
+    addAtCost(other.quantity, other.cost);
 }
 
 void merchandises::MerchLoad::substract(const types::quantity otherQuantity) {
@@ -93,12 +132,18 @@ void merchandises::MerchLoad::substract(const MerchLoad& other) {
 }
 
 merchandises::MerchLoad merchandises::MerchLoad::split(const types::quantity otherQuantity) {
+    TRACE_SCOPE("MerchLoad::split");
+
     if (otherQuantity > quantity) throw NotEnoughLoadError();
 
     quantity -= otherQuantity;
-    MerchLoad splittedLoad(merch, otherQuantity, price);
+    return atCost(merch, otherQuantity, cost);
+}
 
-    return splittedLoad;
+void merchandises::MerchLoad::restore(const types::quantity otherQuantity,
+                                      const types::money otherCost) {
+    quantity = otherQuantity;
+    cost = otherCost;
 }
 
 merchandises::MerchLoad merchandises::MerchLoad::split(const MerchLoad& other) {
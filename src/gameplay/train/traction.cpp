@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <cmath>
+
+#include "gameplay/train/traction.hpp"
+
+traction::Traction traction::compute(const types::weight weight, const types::power power) {
+    Traction traction;
+    traction.weight = weight;
+    traction.power = power;
+
+    // nothing moves without power or weight
+    if (weight <= 0 || power <= 0) {
+        traction.maxSpeed = 0;
+        traction.acceleration = 0;
+        traction.coalConsumption = 0;
+        return traction;
+    }
+
+    // the speed is reached when the power equals the resistance
+    traction.maxSpeed = std::min(power / (resistance * weight), speedLimit);
+    traction.acceleration = power / (inertia * weight);
+    traction.coalConsumption = power * coalPerEnergy;
+
+    return traction;
+}
+
+void traction::step(const Traction& traction, Motion& motion, const float throttle,
+                    const types::duration duration) {
+    float usedThrottle = std::max(0.f, std::min(throttle, 1.f));
+
+    // burn coal, reduce the throttle if there is not enough of it
+    types::weight burnt = traction.coalConsumption * usedThrottle * duration;
+
+    if (burnt > motion.coal) {
+        usedThrottle = burnt > 0 ? usedThrottle * motion.coal / burnt : 0;
+        burnt = motion.coal;
+    }
+
+    motion.coal -= burnt;
+
+    // the speed converges exponentially toward the target speed, with a rate
+    // independent of the weight
+    types::speed target = traction.maxSpeed * usedThrottle;
+    float decay = std::exp(-resistance / inertia * duration);
+    motion.speed = target + (motion.speed - target) * decay;
+}
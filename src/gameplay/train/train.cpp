@@ -1,49 +1,672 @@
-#include <typeinfo>
+#include <algorithm>
 
 #include "gameplay/train/train.hpp"
+#include "gameplay/train/transaction.hpp"
+#include "tools/hash.hpp"
+#include "tools/trace.hpp"
 
-train::Train::Train() {}
+namespace {
 
-void train::Train::addCar(std::shared_ptr<cars::Car> car) {
-    cars.push_back(car);
+/**
+ * Link ID of the front of the train.
+ */
+const std::uint64_t frontId = UINT64_MAX;
+
+/**
+ * Link ID of the back of the train.
+ */
+const std::uint64_t backId = UINT64_MAX - 1;
+
+/**
+ * Hash a link between two cars.
+ * @param previous Link ID of the first car.
+ * @param next Link ID of the second car.
+ * @return Hash of the link.
+ */
+std::uint64_t hashLink(const std::uint64_t previous, const std::uint64_t next) {
+    return hash::combine(hash::mix(previous), next);
+}
+
+/**
+ * Transfer planned by the consolidation of a train.
+ */
+struct Move {
+    /**
+     * Car to empty.
+     */
+    cars::LoadCar* source;
+
+    /**
+     * Car to fill.
+     */
+    cars::LoadCar* target;
+
+    /**
+     * Quantity to transfer.
+     */
+    types::quantity quantity;
+};
+
+/**
+ * Tell if a car is a better place to keep its merch than another one.
+ * Larger cars come first, then fuller cars.
+ * @param first First car.
+ * @param second Second car.
+ * @return True if the first car is better.
+ */
+bool isBetterKept(const cars::LoadCar* first, const cars::LoadCar* second) {
+    if (first->getMaxQuantity() != second->getMaxQuantity()) {
+        return first->getMaxQuantity() > second->getMaxQuantity();
+    }
+
+    return first->getQuantity() > second->getQuantity();
+}
+
+}
+
+train::Train::Train() :
+    region(), traction(), isTractionValid(false), motion(), throttle(0),
+    position({noArc, 0, 0}), stateHash(hashLink(frontId, backId)) {}
+
+train::Train::Train(const std::size_t blockSize) :
+    region(std::make_shared<arena::Arena>(blockSize)), traction(), isTractionValid(false),
+    motion(), throttle(0), position({noArc, 0, 0}), stateHash(hashLink(frontId, backId)) {}
+
+train::Train::~Train() {
+    // shared cars may outlive the train
+    for (const auto index : consist) {
+        slots[index].car->setObserver(nullptr);
+        slots[index].car->clearChanges();
+    }
+}
+
+train::Train::Slot& train::Train::attachCar(cars::Car* car) {
+    // reuse a free slot if possible
+    std::uint32_t index;
+
+    if (freeSlots.empty()) {
+        index = slots.size();
+        slots.push_back({nullptr, nullptr, nullptr, 0});
+        states.push_back(car->getState());
+    } else {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    Slot& slot = slots[index];
+    slot.car = car;
+    states[index] = car->getState();
+    consist.push_back(index);
+
+    car->setObservedHash(car->computeHash());
+    stateHash += car->getObservedHash();
+    updateLinks(consist.size() - 1, true);
+
+    car->setObserver(this, index);
+    isTractionValid = false;
+    markChanged(*car, cars::Change::added);
+
+    return slot;
+}
+
+void train::Train::detachCar(const std::size_t position) {
+    std::uint32_t index = consist[position];
+    Slot& slot = slots[index];
+    cars::Car* car = slot.car;
+
+    updateLinks(position, false);
+    stateHash -= car->getObservedHash();
+    consist.erase(consist.begin() + position);
+    car->setObserver(nullptr);
+    isTractionValid = false;
+
+    // the car cannot be reached anymore when draining, so its changes are
+    // gathered now
+    cars::Change removedChanges = car->getChanges() | cars::Change::removed;
+
+    if (car->isDirty()) {
+        for (std::size_t i = 0; i < changedCars.size(); i++) {
+            if (changedCars[i] == car) {
+                changedCars[i] = nullptr;
+                changes[i].changes = removedChanges;
+                break;
+            }
+        }
+    } else {
+        changes.push_back({car->getCarId(), removedChanges});
+        changedCars.push_back(nullptr);
+    }
+
+    car->clearChanges();
+
+    // free the slot, handles to it become stale
+    slot.car = nullptr;
+    slot.shared.reset();
+    slot.owned.release();
+    slot.generation++;
+    states[index] = {0, 0, 0, 0, 0};
+    freeSlots.push_back(index);
+}
+
+train::CarHandle train::Train::addCar(std::shared_ptr<cars::Car> car) {
+    Slot& slot = attachCar(car.get());
+    slot.shared = std::move(car);
+    return {static_cast<std::uint32_t>(&slot - slots.data()), slot.generation};
+}
+
+train::CarHandle train::Train::addCar(std::unique_ptr<cars::Car> car) {
+    Slot& slot = attachCar(car.get());
+    slot.owned = std::move(car);
+    return {static_cast<std::uint32_t>(&slot - slots.data()), slot.generation};
 }
 
 std::shared_ptr<cars::Car> train::Train::removeCar(const std::size_t carId) {
-    // esp. cannot remove SpecialCar
-    auto it = getCarIterator(carId);
-    auto car = *it;
+    std::size_t position = getCarPosition(carId);
+    Slot& slot = slots[consist[position]];
 
     // check car is not special
-    // this means we can't move a special car for now
-    if (typeid(car).hash_code() == typeid(cars::SpecialCar).hash_code()) throw SpecialCarRemoveError();
+    if (dynamic_cast<const cars::SpecialCar*>(slot.car)) throw SpecialCarRemoveError();
+
+    // give the ownership of an owned car to the caller
+    std::shared_ptr<cars::Car> car = slot.shared;
 
-    cars.erase(it);
+    if (!car) car.reset(slot.owned.get());
+
+    detachCar(position);
+    return car;
+}
+
+std::unique_ptr<cars::Car> train::Train::releaseCar(const CarHandle handle) {
+    const Slot& slot = getSlot(handle);
+
+    // check car is owned
+    if (!slot.owned) throw NotOwnedCarError();
+
+    // check car is not special
+    if (dynamic_cast<const cars::SpecialCar*>(slot.car)) throw SpecialCarRemoveError();
+
+    std::unique_ptr<cars::Car> car(slot.car);
+    detachCar(getCarPosition(car->getCarId()));
     return car;
 }
 
 std::shared_ptr<cars::Car> train::Train::getCar(const std::size_t carId) {
-    return *getCarIterator(carId);
+    const Slot& slot = slots[consist[getCarPosition(carId)]];
+
+    if (slot.shared) return slot.shared;
+
+    // pointer to an owned car, without ownership
+    return std::shared_ptr<cars::Car>(std::shared_ptr<cars::Car>(), slot.car);
+}
+
+train::CarHandle train::Train::getHandle(const std::size_t carId) const {
+    std::uint32_t index = consist[getCarPosition(carId)];
+    return {index, slots[index].generation};
+}
+
+train::CarHandle train::Train::getHandleAt(const std::size_t position) const {
+    if (position >= consist.size()) throw CarInvalidPositionError();
+
+    std::uint32_t index = consist[position];
+    return {index, slots[index].generation};
+}
+
+bool train::Train::isValid(const CarHandle handle) const {
+    return handle.index < slots.size() && slots[handle.index].car &&
+           slots[handle.index].generation == handle.generation;
+}
+
+const train::Train::Slot& train::Train::getSlot(const CarHandle handle) const {
+    if (!isValid(handle)) throw StaleHandleError();
+
+    return slots[handle.index];
+}
+
+cars::Car& train::Train::get(const CarHandle handle) const {
+    return *getSlot(handle).car;
+}
+
+std::size_t train::Train::getSize() const {
+    return consist.size();
+}
+
+std::shared_ptr<arena::Arena> train::Train::getArena() const {
+    return region;
+}
+
+std::size_t train::Train::getMemoryUsage() const {
+    std::size_t memory = sizeof(*this) + slots.getHeapUsage() + freeSlots.getHeapUsage() +
+                         consist.getHeapUsage() + states.getHeapUsage() +
+                         changes.getHeapUsage() + changedCars.getHeapUsage();
+
+    if (region) return memory + region->getReserved();
+
+    for (const auto index : consist) {
+        memory += slots[index].car->getMemoryUsage();
+    }
+
+    return memory;
+}
+
+train::Transaction train::Train::beginTransaction() {
+    return Transaction(*this);
+}
+
+bool train::Train::canBuy(const merchandises::MerchLoad& merchLoad,
+                          const types::quantity quantity) const {
+    if (quantity > merchLoad.getQuantity()) return false;
+
+    return canReceive(merchLoad.getMerch(), quantity);
+}
+
+bool train::Train::canReceive(const merchandises::Merch& merch,
+                              const types::quantity quantity) const {
+    // gather the space of the cars accepting the merch
+    types::quantity space = 0;
+
+    for (const auto index : consist) {
+        auto car = dynamic_cast<const cars::LoadCar*>(slots[index].car);
+
+        if (!car || !car->canLoad(merch)) continue;
+
+        space += car->getRemainingQuantity();
+
+        if (space >= quantity) return true;
+    }
+
+    return space >= quantity;
+}
+
+void train::Train::buy(merchandises::MerchLoad& merchLoad, const types::quantity quantity) {
+    TRACE_SCOPE("Train::buy");
+
+    if (!canBuy(merchLoad, quantity)) throw CannotBuyError();
+
+    Transaction transaction(*this);
+    types::quantity remaining = quantity;
+
+    for (const auto index : consist) {
+        if (!remaining) break;
+
+        auto car = dynamic_cast<cars::LoadCar*>(slots[index].car);
+
+        if (!car || !car->canLoad(merchLoad)) continue;
+
+        types::quantity part = std::min(remaining, car->getRemainingQuantity());
+        transaction.load(car->getCarId(), merchLoad, part);
+        remaining -= part;
+    }
+
+    transaction.commit();
+}
+
+bool train::Train::canSell(const merchandises::Merch& merch,
+                           const types::quantity quantity) const {
+    // gather the quantity of the cars holding the merch
+    types::quantity held = 0;
+
+    for (const auto index : consist) {
+        auto car = dynamic_cast<const cars::LoadCar*>(slots[index].car);
+
+        if (!car || car->isDestroyed() || car->isEmpty() ||
+                car->getMerchLoad()->getMerch() != merch) {
+            continue;
+        }
+
+        held += car->getQuantity();
+
+        if (held >= quantity) return true;
+    }
+
+    return held >= quantity;
+}
+
+merchandises::MerchLoad train::Train::sell(const merchandises::Merch& merch,
+        const types::quantity quantity) {
+    TRACE_SCOPE("Train::sell");
+
+    if (!canSell(merch, quantity)) throw CannotSellError();
+
+    merchandises::MerchLoad sold(merch, 0, 0);
+    Transaction transaction(*this);
+    types::quantity remaining = quantity;
+
+    for (const auto index : consist) {
+        if (!remaining) break;
+
+        auto car = dynamic_cast<cars::LoadCar*>(slots[index].car);
+
+        if (!car || car->isDestroyed() || car->isEmpty() ||
+                car->getMerchLoad()->getMerch() != merch) {
+            continue;
+        }
+
+        types::quantity part = std::min(remaining, car->getQuantity());
+        transaction.unLoad(car->getCarId(), sold, part);
+        remaining -= part;
+    }
+
+    transaction.commit();
+
+    return sold;
+}
+
+void train::Train::transfer(Train& destination, const merchandises::Merch& merch,
+                            const types::quantity quantity) {
+    TRACE_SCOPE("Train::transfer");
+
+    if (!canSell(merch, quantity) || !destination.canReceive(merch, quantity)) {
+        throw CannotTransferError();
+    }
+
+    if (&destination == this) return;
+
+    types::quantity remaining = quantity;
+    std::size_t from = 0;
+    std::size_t to = 0;
+
+    // move parts from the next car holding the merch to the next car with space
+    while (remaining) {
+        auto source = dynamic_cast<cars::LoadCar*>(slots[consist[from]].car);
+        auto target = dynamic_cast<cars::LoadCar*>(destination.slots[destination.consist[to]].car);
+
+        if (!source || source->isDestroyed() || source->isEmpty() ||
+                source->getMerchLoad()->getMerch() != merch) {
+            from++;
+            continue;
+        }
+
+        if (!target || !target->canLoad(merch)) {
+            to++;
+            continue;
+        }
+
+        types::quantity part = std::min({remaining, source->getQuantity(),
+                                         target->getRemainingQuantity()
+                                        });
+        source->transfer(*target, part);
+        remaining -= part;
+    }
+}
+
+train::Consolidation train::Train::consolidate() {
+    TRACE_SCOPE("Train::consolidate");
+
+    // gather the cars holding each merch, in one pass
+    std::vector<const merchandises::Merch*> merchs;
+    std::vector<std::vector<cars::LoadCar*>> holders;
+
+    for (const auto index : consist) {
+        auto car = dynamic_cast<cars::LoadCar*>(slots[index].car);
+
+        if (!car || car->isDestroyed() || car->isEmpty()) continue;
+
+        const merchandises::Merch& merch = car->getMerchLoad()->getMerch();
+        std::size_t group = 0;
+
+        while (group < merchs.size() && *merchs[group] != merch) {
+            group++;
+        }
+
+        if (group == merchs.size()) {
+            merchs.push_back(&merch);
+            holders.emplace_back();
+        }
+
+        holders[group].push_back(car);
+    }
+
+    // plan the transfers, merch by merch
+    std::vector<Move> moves;
+    Consolidation consolidation = {0, 0};
+
+    for (auto& holding : holders) {
+        std::stable_sort(holding.begin(), holding.end(), isBetterKept);
+        types::quantity total = 0;
+
+        for (const auto car : holding) {
+            total += car->getQuantity();
+        }
+
+        // keep the first cars until they can hold everything
+        std::size_t keptCount = 0;
+        types::quantity capacity = 0;
+        std::vector<types::quantity> space;
+
+        while (capacity < total) {
+            capacity += holding[keptCount]->getMaxQuantity();
+            space.push_back(holding[keptCount]->getRemainingQuantity());
+            keptCount++;
+        }
+
+        // pour the other cars into the kept ones
+        std::size_t target = 0;
+
+        for (std::size_t index = keptCount; index < holding.size(); index++) {
+            types::quantity remaining = holding[index]->getQuantity();
+            consolidation.freedCars++;
+            consolidation.freedCapacity += holding[index]->getMaxQuantity();
+
+            while (remaining) {
+                while (!space[target]) {
+                    target++;
+                }
+
+                types::quantity part = std::min(remaining, space[target]);
+                moves.push_back({holding[index], holding[target], part});
+                space[target] -= part;
+                remaining -= part;
+            }
+        }
+    }
+
+    for (const auto& move : moves) {
+        move.source->transfer(*move.target, move.quantity);
+    }
+
+    return consolidation;
 }
 
 void train::Train::moveCar(const std::size_t carId, const std::size_t position) {
     // check position
-    if (position >= cars.size()) throw CarInvalidPositionError();
+    if (position >= consist.size()) throw CarInvalidPositionError();
 
-    auto car = removeCar(carId);
-    cars.emplace(cars.begin() + position, car);
+    std::size_t currentPosition = getCarPosition(carId);
+    std::uint32_t index = consist[currentPosition];
+    updateLinks(currentPosition, false);
+    consist.erase(consist.begin() + currentPosition);
+    consist.insert(consist.begin() + position, index);
+    updateLinks(position, true);
+    markChanged(*slots[index].car, cars::Change::position);
 }
 
-std::vector<std::shared_ptr<cars::Car>>::iterator train::Train::getCarIterator(
-const std::size_t carId) {
-    auto it = cars.begin();
+std::size_t train::Train::getCarPosition(const std::size_t carId) const {
+    TRACE_SCOPE("Train::getCarPosition");
 
-    for (const auto car : cars) {
-        if (car->getCarId() == carId) {
-            return it;
+    for (std::size_t position = 0; position < consist.size(); position++) {
+        if (slots[consist[position]].car->getCarId() == carId) {
+            return position;
         }
-
-        it++;
     }
 
     throw CarNotFoundError();
 }
+
+void train::Train::onCarChanged(cars::Car& car, const cars::Change change) {
+    isTractionValid = false;
+    states[car.getObserverKey()] = car.getState();
+
+    // replace the previous hash of the car
+    std::uint64_t carHash = car.computeHash();
+    stateHash += carHash - car.getObservedHash();
+    car.setObservedHash(carHash);
+
+    markChanged(car, change);
+}
+
+void train::Train::markChanged(cars::Car& car, const cars::Change change) {
+    if (!car.isDirty()) {
+        changes.push_back({car.getCarId(), cars::Change::none});
+        changedCars.push_back(&car);
+    }
+
+    car.addChanges(change);
+}
+
+bool train::Train::hasChanges() const {
+    return !changes.empty();
+}
+
+std::vector<train::CarChange> train::Train::drainChanges() {
+    TRACE_SCOPE("Train::drainChanges");
+
+    // gather changes of the cars still in the train
+    for (std::size_t i = 0; i < changedCars.size(); i++) {
+        if (!changedCars[i]) continue;
+
+        changes[i].changes = changedCars[i]->getChanges();
+        changedCars[i]->clearChanges();
+    }
+
+    std::vector<CarChange> drained(changes.begin(), changes.end());
+    changes.clear();
+    changedCars.clear();
+
+    return drained;
+}
+
+std::uint64_t train::Train::getLinkId(const std::size_t position) const {
+    if (!position) return frontId;
+
+    if (position > consist.size()) return backId;
+
+    // a car attached again to the slot gets another ID
+    std::uint32_t index = consist[position - 1];
+    return static_cast<std::uint64_t>(slots[index].generation) << 32 | index;
+}
+
+void train::Train::updateLinks(const std::size_t position, const bool isInserted) {
+    std::uint64_t previous = getLinkId(position);
+    std::uint64_t current = getLinkId(position + 1);
+    std::uint64_t next = getLinkId(position + 2);
+
+    // the car splits the link between its neighbors in two
+    std::uint64_t split = hashLink(previous, current) + hashLink(current, next);
+    std::uint64_t joined = hashLink(previous, next);
+    stateHash += isInserted ? split - joined : joined - split;
+}
+
+std::uint64_t train::Train::getHash() const {
+    return stateHash;
+}
+
+std::uint64_t train::Train::computeHash() const {
+    std::uint64_t trainHash = 0;
+
+    for (std::size_t position = 0; position <= consist.size(); position++) {
+        trainHash += hashLink(getLinkId(position), getLinkId(position + 1));
+
+        if (position < consist.size()) trainHash += slots[consist[position]].car->computeHash();
+    }
+
+    return trainHash;
+}
+
+const traction::Traction& train::Train::getTraction() const {
+    if (isTractionValid) return traction;
+
+    traction = computeTraction();
+    isTractionValid = true;
+
+    return traction;
+}
+
+traction::Traction train::Train::computeTraction() const {
+    TRACE_SCOPE("Train::computeTraction");
+
+    // sum the weight and the power of all the cars
+    types::weight weight = 0;
+    types::power power = 0;
+
+    for (const auto& state : states) {
+        // destroyed cars lose their load and their power
+        if (state.health > 0) {
+            weight += state.weight + state.quantity;
+            power += state.power;
+        } else {
+            weight += state.weight;
+        }
+    }
+
+    return traction::compute(weight, power);
+}
+
+types::money train::Train::computeValue() const {
+    TRACE_SCOPE("Train::computeValue");
+
+    // mask the values of destroyed cars rather than branch, so that the loop
+    // is vectorized
+    types::money value = 0;
+
+    for (const auto& state : states) {
+        value += state.value & -static_cast<types::money>(state.health > 0);
+    }
+
+    return value;
+}
+
+types::weight train::Train::getWeight() const {
+    return getTraction().weight;
+}
+
+types::power train::Train::getPower() const {
+    return getTraction().power;
+}
+
+types::speed train::Train::getSpeed() const {
+    return motion.speed;
+}
+
+types::weight train::Train::getCoal() const {
+    return motion.coal;
+}
+
+void train::Train::addCoal(const types::weight coal) {
+    motion.coal += coal;
+}
+
+float train::Train::getThrottle() const {
+    return throttle;
+}
+
+void train::Train::setThrottle(const float otherThrottle) {
+    if (otherThrottle < 0 || otherThrottle > 1) throw InvalidThrottleError();
+
+    throttle = otherThrottle;
+}
+
+const train::Position& train::Train::getPosition() const {
+    return position;
+}
+
+void train::Train::setPosition(const Position& otherPosition) {
+    position = otherPosition;
+}
+
+void train::Train::tick(const types::duration duration) {
+    TRACE_SCOPE("Train::tick");
+
+    traction::step(getTraction(), motion, throttle, duration);
+}
+
+types::money train::computeValue(const std::vector<const Train*>& trains) {
+    TRACE_SCOPE("computeValue");
+
+    types::money value = 0;
+
+    for (const Train* train : trains) {
+        value += train->computeValue();
+    }
+
+    return value;
+}
@@ -0,0 +1,129 @@
+#include "gameplay/train/transaction.hpp"
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Get the average cost of the load of a car.
+ * @param car Car to consider.
+ * @return Average cost of a unit, or 0 if the car is empty.
+ */
+types::money getCarCost(cars::LoadCar& car) {
+    if (car.isEmpty()) return 0;
+
+    return car.getMerchLoad()->getCost();
+}
+
+}
+
+train::Transaction::Transaction(Train& train) :
+    train(train), steps(), undoLog() {}
+
+cars::LoadCar* train::Transaction::getLoadCar(const CarHandle handle) {
+    auto car = dynamic_cast<cars::LoadCar*>(&train.get(handle));
+
+    if (!car) throw NotLoadCarError();
+
+    return car;
+}
+
+void train::Transaction::stage(const Operation operation, const std::size_t carId,
+                               merchandises::MerchLoad& merchLoad,
+                               const types::quantity quantity) {
+    // check the car now, but keep only its handle
+    CarHandle handle = train.getHandle(carId);
+    getLoadCar(handle);
+    steps.push_back({operation, handle, &merchLoad, quantity});
+}
+
+void train::Transaction::load(const std::size_t carId, merchandises::MerchLoad& merchLoad,
+                              const types::quantity quantity) {
+    stage(Operation::load, carId, merchLoad, quantity);
+}
+
+void train::Transaction::unLoad(const std::size_t carId, merchandises::MerchLoad& merchLoad,
+                                const types::quantity quantity) {
+    stage(Operation::unLoad, carId, merchLoad, quantity);
+}
+
+std::size_t train::Transaction::getSize() const {
+    return steps.size();
+}
+
+void train::Transaction::cancel() {
+    steps.clear();
+}
+
+void train::Transaction::commit() {
+    TRACE_SCOPE("Transaction::commit");
+
+    undoLog.clear();
+
+    try {
+        for (const auto& step : steps) {
+            apply(step);
+        }
+    } catch (...) {
+        rollBack();
+        steps.clear();
+        throw;
+    }
+
+    undoLog.clear();
+    steps.clear();
+}
+
+void train::Transaction::apply(const Step& step) {
+    // nothing to do
+    if (!step.quantity) return;
+
+    // the car may have left the train since the operation was staged
+    cars::LoadCar* car = getLoadCar(step.handle);
+    types::money carCost = getCarCost(*car);
+    types::money merchLoadCost = step.merchLoad->getCost();
+
+    switch (step.operation) {
+        case Operation::load:
+            // the car leaves both loads untouched if it fails
+            car->load(*step.merchLoad, step.quantity);
+            break;
+
+        case Operation::unLoad:
+            // check the merch before unloading, so the unload cannot be lost
+            if (!car->isEmpty() &&
+                    !step.merchLoad->hasSameMerch(car->getMerchLoad()->getMerch())) {
+                throw merchandises::NotSameMerchError();
+            }
+
+            step.merchLoad->add(car->unLoad(step.quantity));
+            break;
+    }
+
+    undoLog.push_back({step, car, carCost, merchLoadCost});
+}
+
+void train::Transaction::rollBack() {
+    TRACE_SCOPE("Transaction::rollBack");
+
+    for (auto it = undoLog.rbegin(); it != undoLog.rend(); it++) {
+        const Step& step = it->step;
+        cars::LoadCar* car = it->car;
+        const merchandises::Merch& merch = step.merchLoad->getMerch();
+        types::quantity carQuantity = car->getQuantity();
+        types::quantity merchLoadQuantity = step.merchLoad->getQuantity();
+
+        switch (step.operation) {
+            case Operation::load:
+                car->restoreLoad(merch, carQuantity - step.quantity, it->carCost);
+                step.merchLoad->restore(merchLoadQuantity + step.quantity, it->merchLoadCost);
+                break;
+
+            case Operation::unLoad:
+                car->restoreLoad(merch, carQuantity + step.quantity, it->carCost);
+                step.merchLoad->restore(merchLoadQuantity - step.quantity, it->merchLoadCost);
+                break;
+        }
+    }
+
+    undoLog.clear();
+}
@@ -0,0 +1,93 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "tools/allocations.hpp"
+
+namespace {
+
+/**
+ * Number of allocations since the start.
+ */
+std::atomic<std::uint64_t> count(0);
+
+/**
+ * Size of the allocations since the start, in bytes.
+ */
+std::atomic<std::uint64_t> size(0);
+
+/**
+ * Allocate memory, counting the allocation.
+ * @param bytes Size of the allocation, in bytes.
+ * @return Pointer to the memory.
+ */
+void* allocate(const std::size_t bytes) {
+    count++;
+    size += bytes;
+
+    void* pointer = std::malloc(bytes ? bytes : 1);
+
+    if (!pointer) throw std::bad_alloc();
+
+    return pointer;
+}
+
+}
+
+std::uint64_t allocations::getCount() {
+    return count;
+}
+
+std::uint64_t allocations::getSize() {
+    return size;
+}
+
+/**
+ * Allocate memory, counting the allocation.
+ * @param size Size of the allocation, in bytes.
+ * @return Pointer to the memory.
+ */
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+/**
+ * Allocate memory for an array, counting the allocation.
+ * @param size Size of the allocation, in bytes.
+ * @return Pointer to the memory.
+ */
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+/**
+ * Give back memory.
+ * @param pointer Pointer to the memory.
+ */
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+/**
+ * Give back memory of a known size.
+ * @param pointer Pointer to the memory.
+ */
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+/**
+ * Give back memory of an array.
+ * @param pointer Pointer to the memory.
+ */
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+/**
+ * Give back memory of an array of a known size.
+ * @param pointer Pointer to the memory.
+ */
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
@@ -0,0 +1,82 @@
+#include "tools/arena.hpp"
+
+namespace {
+
+/**
+ * Round a size to the alignment.
+ * @param size Size in bytes.
+ * @return Rounded size, large enough to hold a free list pointer.
+ */
+std::size_t roundSize(const std::size_t size) {
+    std::size_t rounded = (size + arena::alignment - 1) / arena::alignment * arena::alignment;
+    return rounded ? rounded : arena::alignment;
+}
+
+}
+
+arena::Arena::Arena(const std::size_t blockSize) :
+    blockSize(roundSize(blockSize)), blocks(), current(nullptr), remaining(0), freeLists(),
+    reserved(0), used(0), count(0) {}
+
+void*& arena::Arena::getFreeList(const std::size_t size) {
+    // there are only a few sizes, a linear search is enough
+    for (auto& freeList : freeLists) {
+        if (freeList.first == size) return freeList.second;
+    }
+
+    freeLists.push_back(std::make_pair(size, nullptr));
+    return freeLists.back().second;
+}
+
+void* arena::Arena::allocate(const std::size_t size) {
+    std::size_t rounded = roundSize(size);
+    used += rounded;
+    count++;
+
+    // reuse freed memory first
+    void*& freeList = getFreeList(rounded);
+
+    if (freeList) {
+        void* pointer = freeList;
+        freeList = *static_cast<void**>(pointer);
+        return pointer;
+    }
+
+    // allocate a new block if needed, the rest of the current one is lost
+    if (rounded > remaining) {
+        std::size_t newBlockSize = rounded > blockSize ? rounded : blockSize;
+        blocks.emplace_back(new char[newBlockSize]);
+        current = blocks.back().get();
+        remaining = newBlockSize;
+        reserved += newBlockSize;
+    }
+
+    void* pointer = current;
+    current += rounded;
+    remaining -= rounded;
+
+    return pointer;
+}
+
+void arena::Arena::deallocate(void* pointer, const std::size_t size) {
+    std::size_t rounded = roundSize(size);
+    used -= rounded;
+    count--;
+
+    // put the memory in the free list
+    void*& freeList = getFreeList(rounded);
+    *static_cast<void**>(pointer) = freeList;
+    freeList = pointer;
+}
+
+std::size_t arena::Arena::getReserved() const {
+    return reserved;
+}
+
+std::size_t arena::Arena::getUsed() const {
+    return used;
+}
+
+std::size_t arena::Arena::getCount() const {
+    return count;
+}
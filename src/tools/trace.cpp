@@ -0,0 +1,183 @@
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tools/trace.hpp"
+
+namespace {
+
+/**
+ * Events recorded by a thread.
+ */
+struct Buffer {
+    /**
+     * Sequential ID of the thread.
+     */
+    std::size_t threadId;
+
+    /**
+     * Recorded events.
+     */
+    std::vector<trace::Event> events;
+};
+
+/**
+ * Mutex protecting the registry of buffers.
+ */
+std::mutex registryMutex;
+
+/**
+ * Buffers of all the threads that recorded events.
+ * Buffers are kept when their thread ends.
+ */
+std::vector<std::shared_ptr<Buffer>> registry;
+
+/**
+ * Get the start of the program.
+ * @return Time point of the first call.
+ */
+trace::clock::time_point getEpoch() {
+    static const trace::clock::time_point epoch = trace::clock::now();
+    return epoch;
+}
+
+/**
+ * Get the buffer of the current thread.
+ * The buffer is registered on first call.
+ * @return Buffer of the current thread.
+ */
+Buffer& getBuffer() {
+    thread_local std::shared_ptr<Buffer> buffer;
+
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer = std::make_shared<Buffer>();
+        buffer->threadId = registry.size();
+        registry.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+/**
+ * Get the histogram bin of a duration.
+ * @param duration Duration in nanoseconds.
+ * @return Index of the smallest power of two greater than the duration.
+ */
+std::size_t getBin(std::uint64_t duration) {
+    std::size_t bin = 0;
+
+    while (duration && bin < trace::histogramSize - 1) {
+        duration >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+/**
+ * Write a string as JSON.
+ * @param stream Stream to write to.
+ * @param string String to write.
+ */
+void writeString(std::ostream& stream, const std::string& string) {
+    stream << '"';
+
+    for (const char character : string) {
+        if (character == '"' || character == '\\') stream << '\\';
+
+        stream << character;
+    }
+
+    stream << '"';
+}
+
+}
+
+std::uint64_t trace::now() {
+    // get the epoch first, so it is never later than the current time
+    auto epoch = getEpoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - epoch).count();
+}
+
+void trace::record(const Event& event) {
+    getBuffer().events.push_back(event);
+}
+
+void trace::clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    for (const auto& buffer : registry) {
+        buffer->events.clear();
+    }
+}
+
+std::map<std::string, trace::Statistics> trace::computeStatistics() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::map<std::string, Statistics> statistics;
+
+    for (const auto& buffer : registry) {
+        for (const auto& event : buffer->events) {
+            auto it = statistics.find(event.name);
+
+            if (it == statistics.end()) {
+                auto pair = std::make_pair(std::string(event.name), Statistics());
+                it = statistics.insert(pair).first;
+            }
+
+            it->second.count++;
+            it->second.total += event.duration;
+            it->second.histogram[getBin(event.duration)]++;
+        }
+    }
+
+    return statistics;
+}
+
+void trace::exportChromeTrace(std::ostream& stream) {
+    auto statistics = computeStatistics();
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    // durations are expressed in microseconds
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"traceEvents\":[";
+    bool first = true;
+
+    for (const auto& buffer : registry) {
+        for (const auto& event : buffer->events) {
+            if (!first) stream << ',';
+
+            first = false;
+            stream << "\n{\"name\":";
+            writeString(stream, event.name);
+            stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId
+                   << ",\"ts\":" << event.start / 1000.
+                   << ",\"dur\":" << event.duration / 1000. << '}';
+        }
+    }
+
+    stream << "\n],\"displayTimeUnit\":\"ns\",\"statistics\":{";
+    first = true;
+
+    for (const auto& pair : statistics) {
+        if (!first) stream << ',';
+
+        first = false;
+        stream << '\n';
+        writeString(stream, pair.first);
+        stream << ":{\"count\":" << pair.second.count
+               << ",\"totalNs\":" << pair.second.total
+               << ",\"histogramLog2Ns\":[";
+
+        for (std::size_t bin = 0; bin < histogramSize; bin++) {
+            if (bin) stream << ',';
+
+            stream << pair.second.histogram[bin];
+        }
+
+        stream << "]}";
+    }
+
+    stream << "\n}}\n";
+}
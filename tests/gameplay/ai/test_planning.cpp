@@ -0,0 +1,274 @@
+#include <stdexcept>
+
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/ai/planning.hpp"
+#include "gameplay/train/cars_data.hpp"
+#include "gameplay/train/merchandises_data.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(ai)
+
+/**
+ * Planner giving fixed actions.
+ */
+class FixedPlanner : public ai::Planner {
+    /**
+     * Actions to give.
+     */
+    std::vector<ai::Action> actions;
+
+  public:
+
+    /**
+     * Usual constructor.
+     * @param actions Actions to give.
+     */
+    explicit FixedPlanner(const std::vector<ai::Action>& actions) :
+        actions(actions) {}
+
+    /**
+     * Plan the actions of a train.
+     * @return Actions.
+     */
+    std::vector<ai::Action> plan(const ai::Snapshot&, const std::atomic<bool>&) const {
+        return actions;
+    }
+};
+
+/**
+ * Planner filling the empty cars with wood.
+ */
+class WoodPlanner : public ai::Planner {
+  public:
+
+    /**
+     * Plan the actions of a train.
+     * @param snapshot Snapshot of the train.
+     * @return Actions.
+     */
+    std::vector<ai::Action> plan(const ai::Snapshot& snapshot,
+                                 const std::atomic<bool>&) const {
+        std::vector<ai::Action> actions;
+
+        for (const auto& car : snapshot.cars) {
+            if (!car.isLoadCar || car.quantity) continue;
+
+            actions.push_back({ai::ActionType::load, car.carId, merchandises::wood.getId(),
+                               car.maxQuantity, 0
+                              });
+        }
+
+        return actions;
+    }
+};
+
+/**
+ * Planner waiting until cancelled.
+ */
+class WaitingPlanner : public ai::Planner {
+  public:
+
+    /**
+     * Plan the actions of a train.
+     * @param isCancelled Flag set when the plan is not needed anymore.
+     * @return No actions.
+     */
+    std::vector<ai::Action> plan(const ai::Snapshot&,
+                                 const std::atomic<bool>& isCancelled) const {
+        while (!isCancelled) {
+            std::this_thread::yield();
+        }
+
+        return {};
+    }
+};
+
+/**
+ * Planner failing.
+ */
+class FailingPlanner : public ai::Planner {
+  public:
+
+    /**
+     * Plan the actions of a train.
+     * @return Nothing.
+     */
+    std::vector<ai::Action> plan(const ai::Snapshot&, const std::atomic<bool>&) const {
+        throw std::runtime_error("no plan");
+    }
+};
+
+BOOST_AUTO_TEST_CASE(testSnapshot) {
+    // create a train with a locomotive, a loaded car and an empty car
+    train::Train train;
+    train.addCar(std::make_shared<cars::Locomotive>(1, "locomotive", 400, 1000));
+    merchandises::MerchLoad merchLoad(merchandises::fish, 15, 12);
+    auto loaded = std::make_shared<cars::LoadCar>(cars::Merchandise(merchLoad));
+    auto empty = std::make_shared<cars::LoadCar>(cars::MerchandiseXL());
+    train.addCar(loaded);
+    train.addCar(empty);
+
+    // take the snapshot
+    ai::Snapshot snapshot = ai::takeSnapshot(train);
+    BOOST_TEST(snapshot.hash == train.getHash());
+    BOOST_TEST(snapshot.cars.size() == 3);
+    BOOST_TEST(!snapshot.cars[0].isLoadCar);
+    BOOST_TEST(snapshot.cars[1].carId == loaded->getCarId());
+    BOOST_TEST(snapshot.cars[1].isLoadCar);
+    BOOST_TEST(snapshot.cars[1].merch == merchandises::fish.getId());
+    BOOST_TEST(snapshot.cars[1].quantity == 15);
+    BOOST_TEST(snapshot.cars[1].maxQuantity == 20);
+    BOOST_TEST(snapshot.cars[1].price == 12);
+    BOOST_TEST(snapshot.cars[1].weight == loaded->getWeight(), tt::tolerance(0.01f));
+    BOOST_TEST(snapshot.cars[2].merch == 0);
+    BOOST_TEST(snapshot.cars[2].maxQuantity == 40);
+
+    // destroyed load cars are snapshotted without their load
+    loaded->takeDammage(200);
+    snapshot = ai::takeSnapshot(train);
+    BOOST_TEST(snapshot.cars[1].isDestroyed);
+    BOOST_TEST(snapshot.cars[1].isLoadCar);
+    BOOST_TEST(snapshot.cars[1].merch == 0);
+    BOOST_TEST(snapshot.cars[1].quantity == 0);
+    BOOST_TEST(snapshot.cars[1].maxQuantity == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testApply) {
+    // create a train with an empty car and a loaded car
+    train::Train train;
+    merchandises::MerchLoad merchLoad(merchandises::fish, 15, 12);
+    auto empty = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    auto loaded = std::make_shared<cars::LoadCar>(cars::Merchandise(merchLoad));
+    auto locomotive = std::make_shared<cars::Locomotive>(1, "locomotive", 400, 1000);
+    train.addCar(empty);
+    train.addCar(loaded);
+    train.addCar(locomotive);
+    station::Warehouse warehouse;
+    warehouse.store(merchandises::wood, 50, 10);
+
+    // plan to trade and to put the locomotive first
+    ai::JobSystem jobs(2);
+    jobs.submit(train, warehouse, std::make_shared<FixedPlanner>(std::vector<ai::Action> {
+        {ai::ActionType::load, empty->getCarId(), merchandises::wood.getId(), 20, 0},
+        {ai::ActionType::unLoad, loaded->getCarId(), 0, 10, 0},
+        {ai::ActionType::moveCar, locomotive->getCarId(), 0, 0, 0}
+    }));
+    BOOST_TEST(jobs.hasJob(train));
+
+    // the plan is applied at the tick boundary only
+    jobs.wait();
+    BOOST_TEST(empty->isEmpty());
+    ai::Report report = jobs.update();
+    BOOST_TEST(report.applied == 1);
+    BOOST_TEST(report.stale == 0);
+    BOOST_TEST(report.failed == 0);
+    BOOST_TEST(!jobs.hasJob(train));
+
+    // check the train and the warehouse
+    BOOST_TEST(empty->getQuantity() == 20);
+    BOOST_TEST(loaded->getQuantity() == 5);
+    BOOST_TEST(&train.get(train.getHandleAt(0)) == locomotive.get());
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 30);
+    BOOST_TEST(warehouse.getQuantity(merchandises::fish) == 10);
+    BOOST_TEST(warehouse.getPrice(merchandises::fish) == 12);
+
+    // plans for several trains are applied in order of submission
+    train::Train first;
+    first.addCar(std::make_shared<cars::LoadCar>(cars::Merchandise()));
+    train::Train second;
+    second.addCar(std::make_shared<cars::LoadCar>(cars::MerchandiseXL()));
+    auto planner = std::make_shared<WoodPlanner>();
+    jobs.submit(first, warehouse, planner);
+    jobs.submit(second, warehouse, planner);
+    jobs.wait();
+    report = jobs.update();
+    BOOST_TEST(report.applied == 1);
+    BOOST_TEST(report.failed == 1);
+    BOOST_TEST(first.canSell(merchandises::wood, 20));
+    BOOST_TEST(!second.canSell(merchandises::wood, 1));
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 10);
+}
+
+BOOST_AUTO_TEST_CASE(testStale) {
+    // create a train with an empty car
+    train::Train train;
+    auto car = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(car);
+    station::Warehouse warehouse;
+    warehouse.store(merchandises::wood, 50, 10);
+    ai::JobSystem jobs(1);
+    auto planner = std::make_shared<WoodPlanner>();
+
+    // a train changed after the snapshot does not get its plan
+    jobs.submit(train, warehouse, planner);
+    train.addCar(std::make_shared<cars::LoadCar>(cars::Merchandise()));
+    jobs.wait();
+    ai::Report report = jobs.update();
+    BOOST_TEST(report.applied == 0);
+    BOOST_TEST(report.stale == 1);
+    BOOST_TEST(car->isEmpty());
+    BOOST_TEST(!jobs.hasJob(train));
+
+    // a new job cancels the previous one
+    jobs.submit(train, warehouse, planner);
+    jobs.submit(train, warehouse, planner);
+    jobs.wait();
+    report = jobs.update();
+    BOOST_TEST(report.applied == 1);
+    BOOST_TEST(report.stale == 1);
+    BOOST_TEST(train.canSell(merchandises::wood, 40));
+
+    // a job can be cancelled while planned
+    jobs.submit(train, warehouse, std::make_shared<WaitingPlanner>());
+    BOOST_TEST(jobs.cancel(train));
+    BOOST_TEST(!jobs.cancel(train));
+    jobs.wait();
+    report = jobs.update();
+    BOOST_TEST(report.stale == 1);
+}
+
+BOOST_AUTO_TEST_CASE(testFailed) {
+    // create a train with an empty car
+    train::Train train;
+    auto car = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(car);
+    station::Warehouse warehouse;
+    warehouse.store(merchandises::wood, 50, 10);
+    warehouse.store(merchandises::fish, 50, 10);
+    ai::JobSystem jobs(1);
+
+    // a plan failing half way leaves the train and the warehouse untouched
+    jobs.submit(train, warehouse, std::make_shared<FixedPlanner>(std::vector<ai::Action> {
+        {ai::ActionType::load, car->getCarId(), merchandises::wood.getId(), 10, 0},
+        {ai::ActionType::load, car->getCarId(), merchandises::fish.getId(), 10, 0}
+    }));
+    jobs.wait();
+    ai::Report report = jobs.update();
+    BOOST_TEST(report.failed == 1);
+    BOOST_TEST(car->isEmpty());
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 50);
+    BOOST_TEST(warehouse.getQuantity(merchandises::fish) == 50);
+
+    // so does a plan with an invalid move
+    jobs.submit(train, warehouse, std::make_shared<FixedPlanner>(std::vector<ai::Action> {
+        {ai::ActionType::load, car->getCarId(), merchandises::wood.getId(), 10, 0},
+        {ai::ActionType::moveCar, car->getCarId(), 0, 0, 3}
+    }));
+    jobs.wait();
+    report = jobs.update();
+    BOOST_TEST(report.failed == 1);
+    BOOST_TEST(car->isEmpty());
+
+    // a failing planner does not stop the workers
+    jobs.submit(train, warehouse, std::make_shared<FailingPlanner>());
+    jobs.wait();
+    BOOST_TEST(jobs.update().failed == 1);
+    jobs.submit(train, warehouse, std::make_shared<WoodPlanner>());
+    jobs.wait();
+    BOOST_TEST(jobs.update().applied == 1);
+    BOOST_TEST(car->getQuantity() == 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
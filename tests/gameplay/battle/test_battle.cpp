@@ -0,0 +1,95 @@
+#include <cmath>
+
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/battle/battle.hpp"
+#include "gameplay/train/cars_data.hpp"
+#include "gameplay/train/merchandises_data.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(battle)
+
+/**
+ * Create a train with a locomotive and cars.
+ * @param train Train to fill.
+ * @param carCount Number of cars after the locomotive.
+ */
+void fill(train::Train& train, const std::size_t carCount) {
+    train.addCar(std::make_shared<cars::Locomotive>(1, "locomotive", 400, 1000));
+
+    for (std::size_t index = 0; index < carCount; index++) {
+        train.makeCar<cars::LoadCar>(cars::Merchandise());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testPredict) {
+    train::Train train;
+    fill(train, 9);
+    train::Train enemy;
+    fill(enemy, 2);
+
+    // the larger train wins most of the time
+    battle::Odds odds = battle::Simulator(train, enemy).predict(2000, 42);
+    BOOST_TEST(odds.win + odds.loss + odds.draw == 1, tt::tolerance(0.001));
+    BOOST_TEST(odds.win > 0.9);
+    BOOST_TEST(odds.enemyLosses.cars > odds.losses.cars);
+    BOOST_TEST(odds.enemyLosses.cars <= 3);
+
+    // a train without cars is defeated at once
+    train::Train empty;
+    odds = battle::Simulator(train, empty).predict(10, 42);
+    BOOST_TEST(odds.win == 1, tt::tolerance(0.001));
+    BOOST_TEST(odds.losses.cars == 0, tt::tolerance(0.001));
+
+    // equal trains have equal chances
+    train::Train twin;
+    fill(twin, 9);
+    odds = battle::Simulator(train, twin).predict(20000, 42);
+    BOOST_TEST(std::abs(odds.win - odds.loss) < 0.03);
+
+    // invalid parameters
+    BOOST_CHECK_THROW(battle::Simulator(train, enemy, {10, 5, 50}), battle::InvalidRulesError);
+    BOOST_CHECK_THROW(battle::Simulator(train, enemy).predict(0, 42), battle::NoEngagementError);
+}
+
+BOOST_AUTO_TEST_CASE(testCargoLosses) {
+    // carry fish in a train facing a much stronger enemy
+    train::Train train;
+    fill(train, 2);
+    merchandises::MerchLoad fishInCity(merchandises::fish, 100, 10);
+    auto cargo = train.makeCar<cars::LoadCar>(cars::Merchandise());
+    cargo->load(fishInCity, 20);
+    train::Train enemy;
+    fill(enemy, 20);
+
+    // the cargo is lost with its car
+    battle::Odds odds = battle::Simulator(train, enemy).predict(1000, 7);
+    BOOST_TEST(odds.loss > 0.9);
+    BOOST_TEST(odds.losses.cargo > 0);
+    BOOST_TEST(odds.losses.cargo <= 20);
+    BOOST_TEST(odds.losses.value == odds.losses.cargo * 10, tt::tolerance(0.01));
+    BOOST_TEST(odds.enemyLosses.cargo == 0, tt::tolerance(0.001));
+}
+
+BOOST_AUTO_TEST_CASE(testDeterminism) {
+    train::Train train;
+    fill(train, 5);
+    train::Train enemy;
+    fill(enemy, 5);
+    battle::Simulator simulator(train, enemy);
+
+    // the odds only depend on the seed, not on the number of threads
+    battle::Odds single = simulator.predict(5000, 3, 1);
+    battle::Odds multiple = simulator.predict(5000, 3, 4);
+    BOOST_TEST(single.win == multiple.win);
+    BOOST_TEST(single.loss == multiple.loss);
+    BOOST_TEST(single.losses.cars == multiple.losses.cars);
+    BOOST_TEST(single.enemyLosses.cars == multiple.enemyLosses.cars);
+
+    // another seed gives other odds
+    battle::Odds other = simulator.predict(5000, 4, 4);
+    BOOST_TEST(other.losses.cars != single.losses.cars);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
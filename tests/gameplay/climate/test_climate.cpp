@@ -0,0 +1,115 @@
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/climate/climate.hpp"
+#include "gameplay/train/cars_data.hpp"
+#include "gameplay/train/merchandises_data.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(climate)
+
+BOOST_AUTO_TEST_CASE(testTemperature) {
+    // create a train with a box car and a tank
+    train::Train train;
+    auto box = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    auto tank = std::make_shared<cars::LoadCar>(cars::Tank());
+    train.addCar(box);
+    train.addCar(tank);
+    BOOST_TEST(box->getInsulation() == 4, tt::tolerance(0.01f));
+    BOOST_TEST(tank->getInsulation() == 12, tt::tolerance(0.01f));
+
+    climate::Climate world;
+    BOOST_TEST(world.track(train));
+    BOOST_TEST(!world.track(train));
+    BOOST_TEST(world.getCarCount() == 2);
+    BOOST_TEST(world.getTemperature(train, box->getCarId()) == 10, tt::tolerance(0.01f));
+
+    // better insulated cars cool down slower
+    BOOST_TEST(world.tick(-30, 1) == 0);
+    BOOST_TEST(world.getTemperature(train, box->getCarId()) == 0, tt::tolerance(0.01f));
+    BOOST_TEST(world.getTemperature(train, tank->getCarId()) == 6.67f, tt::tolerance(0.01f));
+
+    // long ticks do not overshoot the outside temperature
+    world.tick(-30, 100);
+    BOOST_TEST(world.getTemperature(train, box->getCarId()) == -30, tt::tolerance(0.01f));
+    BOOST_TEST(world.getTemperature(train, tank->getCarId()) == -30, tt::tolerance(0.01f));
+
+    // empty box cars do not suffer
+    BOOST_TEST(box->isEmpty());
+    BOOST_CHECK_THROW(world.getTemperature(train, 0), train::CarNotFoundError);
+    train::Train other;
+    BOOST_CHECK_THROW(world.getTemperature(other, box->getCarId()),
+                      climate::UntrackedTrainError);
+}
+
+BOOST_AUTO_TEST_CASE(testLoss) {
+    // create a train with a tank of alcohol and a box car of wood
+    train::Train train;
+    merchandises::MerchLoad alcohol(merchandises::alcohol, 20, 10);
+    merchandises::MerchLoad wood(merchandises::wood, 20, 10);
+    auto tank = std::make_shared<cars::LoadCar>(cars::Tank(alcohol));
+    auto box = std::make_shared<cars::LoadCar>(cars::Merchandise(wood));
+    train.addCar(tank);
+    train.addCar(box);
+    climate::Climate world;
+    world.track(train);
+
+    // nothing is lost down to the freezing point
+    BOOST_TEST(world.tick(-2, 12) == 0);
+    BOOST_TEST(world.getTemperature(train, tank->getCarId()) == -2, tt::tolerance(0.01f));
+
+    // the loss grows with the cold and the time, whole units are removed
+    BOOST_TEST(world.tick(-102, 0.6) == 0);
+    BOOST_TEST(world.getTemperature(train, tank->getCarId()) == -7, tt::tolerance(0.01f));
+    BOOST_TEST(world.tick(-102, 0.6) == 1);
+    BOOST_TEST(tank->getQuantity() == 19);
+    BOOST_TEST(box->getQuantity() == 20);
+
+    // the whole load freezes eventually, the car keeps its temperature
+    world.tick(-40, 48);
+    BOOST_TEST(tank->isEmpty());
+    BOOST_TEST(box->getQuantity() == 20);
+    BOOST_TEST(world.getTemperature(train, tank->getCarId()) == -40, tt::tolerance(0.01f));
+    BOOST_TEST(world.tick(-40, 48) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testLayout) {
+    // create two trains with a greenhouse each
+    train::Train first;
+    train::Train second;
+    merchandises::MerchLoad plants(merchandises::plants, 10, 10);
+    auto greenhouse = std::make_shared<cars::LoadCar>(cars::BioGreenhouse(plants));
+    auto other = std::make_shared<cars::LoadCar>(cars::BioGreenhouse());
+    first.addCar(greenhouse);
+    second.addCar(other);
+    climate::Climate world;
+    world.track(first);
+    world.track(second);
+    world.tick(-2, 12);
+    BOOST_TEST(world.getTemperature(first, greenhouse->getCarId()) == 4, tt::tolerance(0.01f));
+
+    // cars added to a train start warm, the others keep their temperature
+    auto tank = std::make_shared<cars::LoadCar>(cars::Tank());
+    first.addCar(tank);
+    world.tick(-2, 0);
+    BOOST_TEST(world.getCarCount() == 3);
+    BOOST_TEST(world.getTemperature(first, greenhouse->getCarId()) == 4, tt::tolerance(0.01f));
+    BOOST_TEST(world.getTemperature(first, tank->getCarId()) == 10, tt::tolerance(0.01f));
+    BOOST_TEST(world.getTemperature(second, other->getCarId()) == 4, tt::tolerance(0.01f));
+
+    // plants are lost below the chilling point
+    BOOST_TEST(world.tick(-140, 1) == 1);
+    BOOST_TEST(greenhouse->getQuantity() == 9);
+    BOOST_TEST(world.getTemperature(second, other->getCarId()) == -2, tt::tolerance(0.01f));
+
+    // untracking a train leaves the others
+    BOOST_TEST(world.untrack(first));
+    BOOST_TEST(!world.untrack(first));
+    BOOST_TEST(!world.isTracked(first));
+    BOOST_TEST(world.getCarCount() == 1);
+    world.tick(-2, 24);
+    BOOST_TEST(world.getTemperature(second, other->getCarId()) == -2, tt::tolerance(0.01f));
+    BOOST_TEST(greenhouse->getQuantity() == 9);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
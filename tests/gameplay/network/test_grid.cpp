@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/network/grid.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(network)
+BOOST_AUTO_TEST_SUITE(grid)
+
+BOOST_AUTO_TEST_CASE(testInsert) {
+    network::Grid grid(10);
+
+    // add points
+    grid.insert(0, {1, 1});
+    grid.insert(3, {-25, 4});
+    BOOST_TEST(grid.getSize() == 2);
+    BOOST_CHECK(grid.contains(0));
+    BOOST_CHECK(!grid.contains(1));
+    BOOST_CHECK(grid.contains(3));
+    BOOST_CHECK_THROW(grid.insert(0, {2, 2}), network::PointExistsError);
+
+    // move points, in the same cell and to another one
+    grid.update(0, {2, 2});
+    BOOST_TEST(grid.getPoint(0).x == 2, tt::tolerance(0.01));
+    grid.update(3, {-5, 4});
+    BOOST_TEST(grid.getPoint(3).x == -5, tt::tolerance(0.01));
+    BOOST_CHECK_THROW(grid.update(1, {0, 0}), network::PointNotFoundError);
+
+    // remove points
+    grid.remove(0);
+    BOOST_TEST(grid.getSize() == 1);
+    BOOST_CHECK(!grid.contains(0));
+    BOOST_CHECK_THROW(grid.remove(0), network::PointNotFoundError);
+    BOOST_CHECK_THROW(grid.getPoint(0), network::PointNotFoundError);
+
+    // cells must have a size
+    BOOST_CHECK_THROW(network::Grid(0), network::InvalidCellSizeError);
+    BOOST_CHECK_THROW(network::Grid(-10), network::InvalidCellSizeError);
+    BOOST_CHECK_THROW(network::Grid(std::nan("")), network::InvalidCellSizeError);
+}
+
+BOOST_AUTO_TEST_CASE(testFindNear) {
+    network::Grid grid(10);
+    grid.insert(0, {0, 0});
+    grid.insert(1, {5, 0});
+    grid.insert(2, {0, -9});
+    grid.insert(3, {25, 25});
+
+    // search around a point
+    std::vector<std::uint32_t> found;
+    grid.findNear(0, 10, found);
+    std::sort(found.begin(), found.end());
+    BOOST_TEST(found == std::vector<std::uint32_t>({1, 2}), tt::per_element());
+
+    // search around a location, with a radius larger than a cell
+    grid.findNear(network::Point({0, 0}), 40, found);
+    BOOST_TEST(found.size() == 4);
+
+    // moved points are found at their new location
+    grid.update(3, {1, 1});
+    grid.findNear(0, 2, found);
+    BOOST_TEST(found == std::vector<std::uint32_t>({3}), tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(testFindPairs) {
+    // scatter points, some of them moving
+    network::Grid grid(5);
+    std::vector<network::Point> points;
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<types::coordinate> coordinate(-100, 100);
+
+    for (std::uint32_t index = 0; index < 1000; index++) {
+        points.push_back({coordinate(generator), coordinate(generator)});
+        grid.insert(index, points.back());
+    }
+
+    for (std::uint32_t index = 0; index < 1000; index += 3) {
+        points[index] = {coordinate(generator), coordinate(generator)};
+        grid.update(index, points[index]);
+    }
+
+    // compare with all the pairs, for a radius smaller and larger than a cell
+    for (const types::distance radius : {4.f, 7.f}) {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> expected;
+
+        for (std::uint32_t first = 0; first < points.size(); first++) {
+            for (std::uint32_t second = first + 1; second < points.size(); second++) {
+                types::coordinate x = points[first].x - points[second].x;
+                types::coordinate y = points[first].y - points[second].y;
+
+                if (x * x + y * y <= radius * radius) expected.push_back({first, second});
+            }
+        }
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+        grid.findPairs(radius, pairs);
+        std::sort(pairs.begin(), pairs.end());
+        BOOST_TEST(!expected.empty());
+        BOOST_CHECK(pairs == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testTrain) {
+    network::Network network;
+    network.addNode("first", network::NodeTypes::station, 0, 0);
+    network.addNode("second", network::NodeTypes::station, 100, 0);
+    network.addRail(0, 1, 100);
+    network.build();
+
+    // follow a train along the network
+    train::Train train;
+    network.place(train, 0, 30);
+    network::Grid grid(10);
+    grid.insert(0, {0, 0});
+    grid.update(0, network, train);
+    BOOST_TEST(grid.getPoint(0).x == 30, tt::tolerance(0.01f));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,159 @@
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/network/network.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(network)
+
+/**
+ * Network with a short slow path and a long fast path between two stations,
+ * and an isolated station.
+ */
+struct NetworkFixture {
+    network::Network network;
+    std::uint32_t north, east, west, south, island;
+
+    NetworkFixture() : network() {
+        north = network.addNode("north", network::NodeTypes::station, 0, 10);
+        east = network.addNode("east", network::NodeTypes::junction, 10, 0);
+        west = network.addNode("west", network::NodeTypes::junction, -5, 0);
+        south = network.addNode("south", network::NodeTypes::station, 0, -10);
+        island = network.addNode("island", network::NodeTypes::station, 100, 100);
+        network.addRail(north, east, 10);
+        network.addRail(east, south, 10);
+        network.addRail(north, west, 5, 20);
+        network.addRail(west, south, 5, 20);
+        network.build();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(testBuild) {
+    network::Network network;
+    std::uint32_t first = network.addNode("first", network::NodeTypes::station, 0, 0);
+    std::uint32_t second = network.addNode("second", network::NodeTypes::station, 3, 4);
+    network.addRail(first, second, 5);
+
+    // the network cannot be queried before being built
+    BOOST_CHECK(!network.isBuilt());
+    BOOST_CHECK_THROW(network.getArcCount(), network::NotBuiltError);
+
+    // rails only link existing nodes
+    BOOST_CHECK_THROW(network.addRail(first, 2, 5), network::InvalidIndexError);
+
+    // each rail gives an arc in each direction
+    network.build();
+    BOOST_CHECK(network.isBuilt());
+    BOOST_TEST(network.getNodeCount() == 2);
+    BOOST_TEST(network.getArcCount() == 2);
+    BOOST_TEST(network.getNode(second).name == "second");
+
+    auto arcs = network.getArcs(first);
+    BOOST_TEST(arcs.second - arcs.first == 1);
+    BOOST_TEST(network.getSource(arcs.first) == first);
+    BOOST_TEST(network.getTarget(arcs.first) == second);
+    BOOST_TEST(network.getLength(arcs.first) == 5, tt::tolerance(0.01));
+    BOOST_TEST(network.getSpeedLimit(arcs.first) == traction::speedLimit, tt::tolerance(0.01));
+
+    // adding a node requires a new build
+    network.addNode("third", network::NodeTypes::junction, 0, 0);
+    BOOST_CHECK(!network.isBuilt());
+}
+
+BOOST_FIXTURE_TEST_CASE(testLowerBound, NetworkFixture) {
+    // bounds never exceed the shortest distance
+    BOOST_TEST(network.getLowerBound(north, south) <= 10);
+    BOOST_TEST(network.getLowerBound(north, east) <= 10);
+    BOOST_TEST(network.getLowerBound(north, north) == 0, tt::tolerance(0.01));
+
+    // nothing is known about unreachable nodes
+    BOOST_TEST(network.getLowerBound(north, island) == 0, tt::tolerance(0.01));
+}
+
+BOOST_FIXTURE_TEST_CASE(testShortestPath, NetworkFixture) {
+    network::Router router(network);
+    network::Route route;
+
+    // the shortest path is the slow one
+    router.findShortestPath(north, south, route);
+    BOOST_TEST(route.cost == 10, tt::tolerance(0.01));
+    BOOST_TEST(route.arcs.size() == 2);
+    BOOST_TEST(network.getSource(route.arcs[0]) == north);
+    BOOST_TEST(network.getTarget(route.arcs[0]) == west);
+    BOOST_TEST(network.getTarget(route.arcs[1]) == south);
+
+    // going nowhere is free
+    router.findShortestPath(north, north, route);
+    BOOST_TEST(route.cost == 0, tt::tolerance(0.01));
+    BOOST_TEST(route.arcs.empty());
+
+    // unreachable and unknown nodes
+    BOOST_CHECK_THROW(router.findShortestPath(north, island, route), network::NoRouteError);
+    BOOST_CHECK_THROW(router.findShortestPath(north, 10, route), network::InvalidIndexError);
+}
+
+BOOST_FIXTURE_TEST_CASE(testFastestPath, NetworkFixture) {
+    network::Router router(network);
+    network::Route route;
+
+    // a fast train takes the long path
+    router.findFastestPath(north, south, 50, route);
+    BOOST_TEST(route.cost == 0.4, tt::tolerance(0.01));
+    BOOST_TEST(network.getTarget(route.arcs[0]) == east);
+
+    // a slow train takes the short path
+    router.findFastestPath(north, south, 10, route);
+    BOOST_TEST(route.cost == 1, tt::tolerance(0.01));
+    BOOST_TEST(network.getTarget(route.arcs[0]) == west);
+
+    // a train without locomotive cannot move
+    train::Train train;
+    BOOST_CHECK_THROW(router.findFastestPath(north, south, train, route),
+                      network::NoRouteError);
+
+    // the speed of a train depends on its traction
+    train.addCar(std::make_shared<cars::Locomotive>(1, "locomotive", 400, 1000));
+    router.findFastestPath(north, south, train, route);
+    BOOST_TEST(route.cost == 0.4, tt::tolerance(0.01));
+}
+
+BOOST_FIXTURE_TEST_CASE(testAdvance, NetworkFixture) {
+    network::Router router(network);
+    network::Route route;
+    router.findShortestPath(north, south, route);
+
+    // a train must be placed on the route first
+    train::Train train;
+    BOOST_TEST(train.getPosition().arc == train::noArc);
+    BOOST_CHECK_THROW(network.place(train, 100), network::InvalidIndexError);
+    network.place(train, route.arcs[0]);
+
+    network::Point point = network.getPoint(train.getPosition());
+    BOOST_TEST(point.x == 0, tt::tolerance(0.01));
+    BOOST_TEST(point.y == 10, tt::tolerance(0.01));
+
+    // move to the middle of the first arc
+    BOOST_CHECK(!network.advance(train, route, 2.5));
+    point = network.getPoint(train.getPosition());
+    BOOST_TEST(point.x == -2.5, tt::tolerance(0.01));
+    BOOST_TEST(point.y == 5, tt::tolerance(0.01));
+
+    // move to the second arc
+    BOOST_CHECK(!network.advance(train, route, 5));
+    BOOST_TEST(train.getPosition().leg == 1);
+    BOOST_TEST(train.getPosition().arc == route.arcs[1]);
+    BOOST_TEST(train.getPosition().offset == 2.5, tt::tolerance(0.01));
+
+    // stop at the end of the route
+    BOOST_CHECK(network.advance(train, route, 100));
+    point = network.getPoint(train.getPosition());
+    BOOST_TEST(point.x == 0, tt::tolerance(0.01));
+    BOOST_TEST(point.y == -10, tt::tolerance(0.01));
+
+    // another route must start where the train is
+    network::Route other;
+    router.findShortestPath(north, east, other);
+    BOOST_CHECK_THROW(network.advance(train, other, 1), network::NotOnRouteError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,176 @@
+#include <cstdio>
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/save/autosave.hpp"
+#include "gameplay/train/cars_data.hpp"
+#include "gameplay/train/merchandises_data.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(save)
+
+/**
+ * Get the size of a file.
+ * @param path Path of the file.
+ * @return Size of the file, in bytes.
+ */
+std::streamoff getFileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file.tellg();
+}
+
+/**
+ * Save two trains and read them back.
+ * @param path Path of the save file.
+ * @param isCompressed Compress the save.
+ */
+void checkRoundTrip(const std::string& path, const bool isCompressed) {
+    // create a trader with a loaded car and a damaged empty car
+    train::Train trader;
+    trader.makeOwnedCar<cars::Locomotive>(1, "locomotive", 400, 1000);
+    merchandises::MerchLoad merchLoad(merchandises::fish, 15, 12);
+    auto loaded = std::make_shared<cars::LoadCar>(cars::Merchandise(merchLoad));
+    auto empty = std::make_shared<cars::LoadCar>(cars::Tank());
+    trader.addCar(loaded);
+    trader.addCar(empty);
+    empty->takeDammage(30);
+    trader.addCoal(50);
+    trader.setThrottle(0.5);
+    train::Train raider;
+    raider.addCar(std::make_shared<cars::LoadCar>(cars::MerchandiseXL()));
+
+    {
+        save::Autosave autosave(path, isCompressed);
+        BOOST_TEST(autosave.capture({&trader, &raider}) == 1);
+        autosave.wait();
+        BOOST_TEST(autosave.getWrittenCount() == 1);
+        BOOST_TEST(autosave.getFailedCount() == 0);
+    }
+
+    // check the content of the save
+    save::Save saved = save::read(path);
+    BOOST_TEST(saved.sequence == 1);
+    BOOST_TEST(saved.trains.size() == 2);
+    BOOST_TEST(saved.cars.size() == 4);
+    BOOST_TEST(saved.trains[0].carCount == 3);
+    BOOST_TEST(saved.trains[0].arc == train::noArc);
+    BOOST_TEST(saved.trains[0].coal == 50, tt::tolerance(0.01f));
+    BOOST_TEST(saved.trains[0].throttle == 0.5f, tt::tolerance(0.01f));
+    BOOST_TEST(saved.trains[1].carCount == 1);
+    BOOST_TEST(saved.cars[0].power == 1000, tt::tolerance(0.01f));
+    BOOST_TEST(saved.cars[1].carId == loaded->getCarId());
+    BOOST_TEST(saved.cars[1].model == cars::Merchandise.getId());
+    BOOST_TEST(saved.cars[1].merch == merchandises::fish.getId());
+    BOOST_TEST(saved.cars[1].quantity == 15);
+    BOOST_TEST(saved.cars[1].cost == 12 * merchandises::moneyScale);
+    BOOST_TEST(saved.cars[2].health == 70);
+    BOOST_TEST(saved.cars[2].merch == 0);
+    BOOST_TEST(saved.cars[3].model == cars::MerchandiseXL.getId());
+}
+
+BOOST_AUTO_TEST_CASE(testRoundTrip) {
+    const std::string path = "test_autosave.sav";
+    checkRoundTrip(path, false);
+    std::streamoff rawSize = getFileSize(path);
+    checkRoundTrip(path, true);
+    std::streamoff packedSize = getFileSize(path);
+    BOOST_TEST(packedSize < rawSize);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testDoubleBuffer) {
+    const std::string path = "test_autosave.sav";
+    train::Train train;
+    auto car = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(car);
+    save::Autosave autosave(path, true);
+
+    // snapshots are taken while previous ones are written, the last one wins
+    std::uint64_t sequence = 0;
+
+    for (types::quantity quantity = 1; quantity <= 20; quantity++) {
+        merchandises::MerchLoad merchLoad(merchandises::wood, 1, 10);
+        train.buy(merchLoad, 1);
+        sequence = autosave.capture({&train});
+    }
+
+    autosave.wait();
+    BOOST_TEST(sequence == 20);
+    BOOST_TEST(autosave.getWrittenCount() >= 1);
+    BOOST_TEST(autosave.getWrittenCount() <= 20);
+    save::Save saved = save::read(path);
+    BOOST_TEST(saved.sequence == 20);
+    BOOST_TEST(saved.cars[0].quantity == 20);
+
+    // a save that cannot be written is counted
+    save::Autosave failing("missing/test_autosave.sav");
+    failing.capture({&train});
+    failing.wait();
+    BOOST_TEST(failing.getWrittenCount() == 0);
+    BOOST_TEST(failing.getFailedCount() == 1);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testDestroyed) {
+    const std::string path = "test_autosave.sav";
+    train::Train train;
+    merchandises::MerchLoad merchLoad(merchandises::fish, 15, 12);
+    auto car = std::make_shared<cars::LoadCar>(cars::Merchandise(merchLoad));
+    train.addCar(car);
+    car->takeDammage(200);
+    merchandises::MerchLoad wood(merchandises::wood, 1, 10);
+    wood.add(2, 11);
+    train.addCar(std::make_shared<cars::LoadCar>(cars::Merchandise(wood)));
+
+    // destroyed cars are saved without their load
+    save::Autosave autosave(path);
+    BOOST_TEST(autosave.capture({&train}) == 1);
+    autosave.wait();
+    BOOST_TEST(autosave.getWrittenCount() == 1);
+    save::Save saved = save::read(path);
+    BOOST_TEST(saved.cars[0].health == -100);
+    BOOST_TEST(saved.cars[0].quantity == 0);
+    BOOST_TEST(saved.cars[0].merch == 0);
+
+    // the exact cost of loads is saved
+    BOOST_TEST(saved.cars[1].cost == 106667);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testCorrupted) {
+    const std::string path = "test_autosave.sav";
+    BOOST_CHECK_THROW(save::read(path), save::SaveFileError);
+
+    // save a train
+    train::Train train;
+    train.addCar(std::make_shared<cars::LoadCar>(cars::Merchandise()));
+
+    {
+        save::Autosave autosave(path);
+        autosave.capture({&train});
+    }
+
+    BOOST_CHECK_NO_THROW(save::read(path));
+
+    // flip a byte of the snapshot
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(getFileSize(path) - 1);
+        file.put('\x7f');
+    }
+
+    BOOST_CHECK_THROW(save::read(path), save::SaveFileError);
+
+    // truncate the file
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "TRSAVE00";
+    }
+
+    BOOST_CHECK_THROW(save::read(path), save::SaveFileError);
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
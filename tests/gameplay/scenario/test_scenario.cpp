@@ -0,0 +1,98 @@
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/scenario/scenario.hpp"
+
+BOOST_AUTO_TEST_SUITE(scenario)
+
+BOOST_AUTO_TEST_CASE(testLoad) {
+    std::istringstream stream(
+        "# comment\n"
+        "\n"
+        "train first\n"
+        "locomotive 100 1000\n"
+        "car 101 3\n"
+        "cargo 4 30 10\n"
+        "train second 4096\n"
+        "car \"merchandise XL\"\n"
+        "buy second fish 10 12\n"
+        "repeat 2\n"
+        "tick 0.5\n"
+        "end\n");
+    scenario::Scenario scenario;
+    scenario.load(stream);
+
+    // trains are set up at once
+    BOOST_TEST(scenario.getTrainCount() == 2);
+    BOOST_TEST(scenario.getTrain(0).getSize() == 4);
+    BOOST_CHECK(scenario.getTrain(0).canSell(merchandises::fish, 30));
+    BOOST_CHECK(!scenario.getTrain(0).getArena());
+    BOOST_CHECK(scenario.getTrain(1).getArena());
+
+    // the script is kept for later
+    BOOST_TEST(scenario.getOperationCount() == 4);
+    BOOST_CHECK(!scenario.getTrain(1).canSell(merchandises::fish, 10));
+}
+
+BOOST_AUTO_TEST_CASE(testLoadErrors) {
+    const char* texts[] = {
+        "locomotive 100 1000\n",
+        "train first\ntrain first\n",
+        "train first\ncar 999\n",
+        "train first\ncar 101 many\n",
+        "train first\ncar 101 1 2\n",
+        "train first\ncargo 4 10 10\n",
+        "train first\nbuy second 4 10 10\n",
+        "train first\nbuy first 999 10 10\n",
+        "train first\nfly first\n",
+        "train first\ncar merchandize\n",
+        "train first\ncar \"merchandise XL\n",
+        "train first\ncar 99999999999\n",
+        "repeat 2\n",
+        "end\n",
+    };
+
+    for (const auto text : texts) {
+        std::istringstream stream(text);
+        scenario::Scenario scenario;
+        BOOST_CHECK_THROW(scenario.load(stream), scenario::ParseError);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testRun) {
+    std::istringstream stream(
+        "train first\n"
+        "locomotive 100 1000\n"
+        "car 101 2\n"
+        "coal 10\n"
+        "throttle 1\n"
+        "repeat 3\n"
+        "repeat 2\n"
+        "buy first 4 20 10\n"
+        "end\n"
+        "sell first 4 20\n"
+        "damage first 1 200\n"
+        "repair first 1\n"
+        "move first 2 1\n"
+        "tick 0.1\n"
+        "end\n"
+        "repeat 0\n"
+        "tick 1\n"
+        "end\n");
+    scenario::Scenario scenario;
+    scenario.load(stream);
+    scenario::Statistics statistics = scenario.run();
+
+    // loops are run as many times as requested
+    BOOST_TEST(statistics.operations == 3 * (2 + 4));
+    BOOST_TEST(statistics.ticks == 3);
+
+    // a car is destroyed in each of the first two loops, so repairs fail, and
+    // purchases and sales fail once there is no car left
+    BOOST_TEST(statistics.failures == 1 + 3 + 4);
+    BOOST_TEST(statistics.seconds >= 0);
+    BOOST_TEST(scenario.getTrain(0).getSpeed() > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
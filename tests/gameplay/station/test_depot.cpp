@@ -0,0 +1,150 @@
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/station/depot.hpp"
+#include "gameplay/train/cars_data.hpp"
+
+BOOST_AUTO_TEST_SUITE(station)
+
+BOOST_AUTO_TEST_SUITE(depot)
+
+BOOST_AUTO_TEST_CASE(testPriority) {
+    // create damaged cars
+    cars::LoadCar late = cars::Merchandise(50);
+    cars::LoadCar early = cars::Merchandise(80);
+    cars::LoadCar valuable = cars::Merchandise(50);
+
+    // cars leaving first come first, then cars with more value at stake
+    station::Depot depot(1, 10);
+    depot.submit(late, 1, 10);
+    depot.submit(early, 1, 5);
+    depot.submit(valuable, 3, 10);
+    BOOST_TEST(depot.getSize() == 3);
+    BOOST_TEST(depot.getBusyCrewCount() == 0);
+
+    std::vector<types::id> repaired = depot.tick(2);
+    BOOST_TEST(repaired.size() == 1);
+    BOOST_TEST(repaired[0] == early.getCarId());
+    BOOST_TEST(early.getHealth() == early.getMaxHealth());
+    BOOST_TEST(!depot.contains(early.getCarId()));
+    BOOST_TEST(depot.getBusyCrewCount() == 0);
+
+    // repairs advance at each tick
+    BOOST_TEST(depot.tick(2.5).empty());
+    BOOST_TEST(valuable.getHealth() == 75);
+    BOOST_TEST(late.getHealth() == 50);
+
+    // time left on a car goes to the next one
+    repaired = depot.tick(3);
+    BOOST_TEST(repaired.size() == 1);
+    BOOST_TEST(repaired[0] == valuable.getCarId());
+    BOOST_TEST(late.getHealth() == 55);
+    repaired = depot.tick(10);
+    BOOST_TEST(repaired.size() == 1);
+    BOOST_TEST(depot.getSize() == 0);
+    BOOST_TEST(depot.getBusyCrewCount() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testProgress) {
+    cars::LoadCar car = cars::Merchandise(50);
+    station::Depot depot(2, 3);
+    depot.submit(car, 1, 0);
+
+    // health points are restored as they are fully repaired
+    depot.tick(0.5);
+    BOOST_TEST(car.getHealth() == 51);
+    depot.tick(0.5);
+    BOOST_TEST(car.getHealth() == 53);
+    BOOST_TEST(depot.getBusyCrewCount() == 1);
+
+    // a car being repaired is left to its crew
+    depot.submit(car, 10, 0);
+    BOOST_TEST(depot.getSize() == 1);
+    BOOST_TEST(depot.getBusyCrewCount() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(testRepairedElsewhere) {
+    cars::LoadCar first = cars::Merchandise(50);
+    cars::LoadCar second = cars::Merchandise(50);
+    station::Depot depot(1, 3);
+    depot.submit(first, 1, 0);
+    depot.submit(second, 1, 1);
+    depot.tick(0.5);
+    BOOST_TEST(first.getHealth() == 51);
+
+    // a car repaired another way is done, the crew gains no time from it
+    first.repair();
+    std::vector<types::id> repaired = depot.tick(0.5);
+    BOOST_TEST(repaired.size() == 1);
+    BOOST_TEST(repaired[0] == first.getCarId());
+    BOOST_TEST(second.getHealth() == 51);
+}
+
+BOOST_AUTO_TEST_CASE(testWithdraw) {
+    cars::LoadCar first = cars::Merchandise(50);
+    cars::LoadCar second = cars::Merchandise(50);
+    station::Depot depot(1, 10);
+    depot.submit(first, 1, 1);
+    depot.submit(second, 1, 2);
+
+    // withdraw a car being repaired and a car waiting
+    depot.tick(1);
+    BOOST_TEST(depot.withdraw(first.getCarId()));
+    BOOST_TEST(!depot.withdraw(first.getCarId()));
+    BOOST_TEST(depot.getBusyCrewCount() == 0);
+    BOOST_TEST(depot.withdraw(second.getCarId()));
+    BOOST_TEST(depot.tick(10).empty());
+    BOOST_TEST(first.getHealth() == 60);
+    BOOST_TEST(second.getHealth() == 50);
+
+    // a car submitted again takes its new priority
+    depot.submit(first, 1, 5);
+    depot.submit(second, 1, 6);
+    depot.submit(first, 1, 7);
+    BOOST_TEST(depot.getSize() == 2);
+    BOOST_TEST(depot.tick(4).empty());
+    BOOST_TEST(first.getHealth() == 60);
+    BOOST_TEST(second.getHealth() == 90);
+
+    // destroyed cars are refused
+    cars::LoadCar destroyed = cars::Merchandise(0);
+    BOOST_CHECK_THROW(depot.submit(destroyed, 1, 1), cars::DestroyedCarError);
+    BOOST_CHECK_THROW(station::Depot(0, 10), station::InvalidCrewError);
+    BOOST_CHECK_THROW(station::Depot(1, 0), station::InvalidCrewError);
+}
+
+BOOST_AUTO_TEST_CASE(testFleet) {
+    // queue many cars leaving in a shuffled order
+    const std::size_t carCount = 20000;
+    std::vector<std::unique_ptr<cars::LoadCar>> fleet;
+    station::Depot depot(8, 1000);
+
+    for (std::size_t index = 0; index < carCount; index++) {
+        fleet.emplace_back(new cars::LoadCar(cars::Merchandise(90)));
+        depot.submit(*fleet.back(), 1, (index * 7919) % carCount);
+    }
+
+    // each tick repairs the cars leaving first
+    std::vector<types::id> repaired = depot.tick(1);
+    BOOST_TEST(repaired.size() == 800);
+    std::size_t early = 0;
+
+    for (std::size_t index = 0; index < carCount; index++) {
+        bool isRepaired = fleet[index]->getHealth() == fleet[index]->getMaxHealth();
+
+        if ((index * 7919) % carCount < 800) early += isRepaired;
+    }
+
+    BOOST_TEST(early == 800);
+
+    for (std::size_t tick = 1; tick < 25; tick++) {
+        depot.tick(1);
+    }
+
+    BOOST_TEST(depot.getSize() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
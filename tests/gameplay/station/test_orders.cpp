@@ -0,0 +1,154 @@
+#include <random>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/station/orders.hpp"
+#include "gameplay/train/merchandises_data.hpp"
+
+BOOST_AUTO_TEST_SUITE(station)
+
+BOOST_AUTO_TEST_SUITE(orders)
+
+/**
+ * Create random orders.
+ * @param count Number of orders.
+ * @param seed Seed of the orders.
+ * @return Orders.
+ */
+std::vector<station::Order> createOrders(const std::size_t count, const std::uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<types::id> traders(1, 50);
+    std::uniform_int_distribution<types::id> merchs(1, 16);
+    std::uniform_int_distribution<int> sides(0, 1);
+    std::uniform_int_distribution<types::price> prices(50, 150);
+    std::uniform_int_distribution<types::quantity> quantities(1, 40);
+    std::vector<station::Order> orders;
+
+    for (std::size_t index = 0; index < count; index++) {
+        station::Side side = sides(generator) ? station::Side::buy : station::Side::sell;
+        orders.push_back({traders(generator), merchs(generator), side, prices(generator),
+                          quantities(generator)
+                         });
+    }
+
+    return orders;
+}
+
+/**
+ * Tell if two lists of trades are the same.
+ * @param first First list.
+ * @param second Second list.
+ * @return True if the lists are the same.
+ */
+bool isSame(const std::vector<station::Trade>& first, const std::vector<station::Trade>& second) {
+    if (first.size() != second.size()) return false;
+
+    for (std::size_t index = 0; index < first.size(); index++) {
+        const station::Trade& one = first[index];
+        const station::Trade& other = second[index];
+
+        if (one.merch != other.merch || one.buyer != other.buyer || one.seller != other.seller ||
+                one.price != other.price || one.quantity != other.quantity) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(testSubmit) {
+    // create an empty book
+    station::OrderBook book;
+    BOOST_TEST(book.getSize() == 0);
+
+    // place orders
+    book.buy(1, merchandises::wood, 10, 20);
+    book.sell(2, merchandises::wood, 8, 10);
+    book.submit({3, merchandises::fish.getId(), station::Side::sell, 5, 1});
+    BOOST_TEST(book.getSize() == 3);
+
+    // orders must have a quantity
+    BOOST_CHECK_THROW(book.buy(1, merchandises::wood, 10, 0), station::InvalidOrderError);
+    BOOST_TEST(book.getSize() == 3);
+
+    // books must have shards
+    BOOST_CHECK_THROW(station::OrderBook(0), station::InvalidShardCountError);
+}
+
+BOOST_AUTO_TEST_CASE(testMatch) {
+    station::OrderBook book(4);
+
+    // nothing to match
+    BOOST_TEST(book.match().empty());
+
+    // place crossing and non-crossing orders
+    book.buy(1, merchandises::wood, 10, 20);
+    book.buy(2, merchandises::wood, 14, 5);
+    book.sell(3, merchandises::wood, 8, 15);
+    book.sell(4, merchandises::wood, 12, 30);
+    book.sell(5, merchandises::fish, 20, 10);
+    book.buy(6, merchandises::fish, 19, 10);
+    book.buy(7, merchandises::alcohol, 3, 1);
+    book.sell(7, merchandises::alcohol, 3, 1);
+
+    // the best orders meet first, at the price halfway
+    std::vector<station::Trade> trades = book.match(2);
+    BOOST_TEST(trades.size() == 3);
+    BOOST_TEST(trades[0].merch == merchandises::alcohol.getId());
+    BOOST_TEST(trades[0].buyer == 7);
+    BOOST_TEST(trades[0].seller == 7);
+    BOOST_TEST(trades[0].price == 3);
+    BOOST_TEST(trades[1].merch == merchandises::wood.getId());
+    BOOST_TEST(trades[1].buyer == 2);
+    BOOST_TEST(trades[1].seller == 3);
+    BOOST_TEST(trades[1].price == 11);
+    BOOST_TEST(trades[1].quantity == 5);
+    BOOST_TEST(trades[2].buyer == 1);
+    BOOST_TEST(trades[2].seller == 3);
+    BOOST_TEST(trades[2].price == 9);
+    BOOST_TEST(trades[2].quantity == 10);
+
+    // orders not matched expire
+    BOOST_TEST(book.getSize() == 0);
+    BOOST_TEST(book.match().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testDeterminism) {
+    std::vector<station::Order> orders = createOrders(2000, 42);
+
+    // match the orders placed in order on one thread
+    station::OrderBook book;
+
+    for (const auto& order : orders) {
+        book.submit(order);
+    }
+
+    std::vector<station::Trade> expected = book.match(1);
+    BOOST_TEST(!expected.empty());
+
+    // match the orders placed backwards from several threads
+    station::OrderBook other(3);
+    std::vector<std::thread> threads;
+
+    for (std::size_t thread = 0; thread < 4; thread++) {
+        threads.emplace_back([&other, &orders, thread]() {
+            for (std::size_t index = orders.size() - thread; index > 0; index -= 4) {
+                other.submit(orders[index - 1]);
+
+                if (index <= 4) break;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BOOST_TEST(other.getSize() == orders.size());
+    BOOST_TEST(isSame(other.match(4), expected));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/station/warehouse.hpp"
+#include "gameplay/train/cars_data.hpp"
+#include "gameplay/train/catalogs.hpp"
+#include "gameplay/train/merchandises_data.hpp"
+
+BOOST_AUTO_TEST_SUITE(station)
+
+BOOST_AUTO_TEST_SUITE(warehouse)
+
+BOOST_AUTO_TEST_CASE(testStore) {
+    // create an empty warehouse
+    station::Warehouse warehouse;
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 0);
+    BOOST_TEST(warehouse.getPrice(merchandises::wood) == 0);
+
+    // store merchandise, averaging the price
+    warehouse.store(merchandises::wood, 30, 10);
+    warehouse.store(merchandises::MerchLoad(merchandises::wood, 10, 30));
+    warehouse.store(merchandises::fish, 5, 8);
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 40);
+    BOOST_TEST(warehouse.getPrice(merchandises::wood) == 15);
+    BOOST_TEST(warehouse.getQuantity(merchandises::fish) == 5);
+    BOOST_TEST(warehouse.getQuantity(merchandises::salt) == 0);
+
+    // large stocks do not overflow the average
+    warehouse.store(merchandises::salt, 3000000, 60000);
+    warehouse.store(merchandises::salt, 1000000, 20000);
+    BOOST_TEST(warehouse.getPrice(merchandises::salt) == 50000);
+
+    // merchs out of the catalog are refused
+    merchandises::Merch unknown(9999, "unknown", merchandises::MerchTypes::box);
+    BOOST_CHECK_THROW(warehouse.store(unknown, 1, 1), catalog::EntryNotFoundError);
+}
+
+BOOST_AUTO_TEST_CASE(testTake) {
+    // create a warehouse with merchandise
+    station::Warehouse warehouse;
+    warehouse.store(merchandises::wood, 30, 10);
+
+    // take some merchandise
+    merchandises::MerchLoad merchLoad = warehouse.take(merchandises::wood, 20);
+    BOOST_TEST((merchLoad.getMerch() == merchandises::wood));
+    BOOST_TEST(merchLoad.getQuantity() == 20);
+    BOOST_TEST(merchLoad.getPrice() == 10);
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 10);
+
+    // the exact cost of loads is kept through the warehouse
+    merchandises::MerchLoad fish(merchandises::fish, 1, 10);
+    fish.add(2, 11);
+    warehouse.store(fish);
+    BOOST_TEST(warehouse.getCost(merchandises::fish) == fish.getCost());
+    BOOST_TEST(warehouse.take(merchandises::fish, 3).getCost() == 106667);
+
+    // take too much merchandise
+    BOOST_CHECK_THROW(warehouse.take(merchandises::wood, 11), station::NotEnoughStockError);
+    BOOST_CHECK_THROW(warehouse.take(merchandises::fish, 1), station::NotEnoughStockError);
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 10);
+}
+
+BOOST_AUTO_TEST_CASE(testTrain) {
+    // create a train with cars of different merchs
+    train::Train train;
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.addCar(std::make_shared<cars::Locomotive>(1, "locomotive", 400, 1000));
+
+    // load the train from the warehouse
+    station::Warehouse warehouse;
+    warehouse.store(merchandises::wood, 50, 10);
+    warehouse.store(merchandises::fish, 20, 6);
+    warehouse.loadTrain(train, merchandises::wood, 30);
+    warehouse.loadTrain(train, merchandises::fish, 10);
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 20);
+    BOOST_TEST(warehouse.getQuantity(merchandises::fish) == 10);
+    BOOST_TEST(train.canSell(merchandises::wood, 30));
+    BOOST_TEST(train.canSell(merchandises::fish, 10));
+
+    // loading more than the stock or the space leaves both untouched
+    BOOST_CHECK_THROW(warehouse.loadTrain(train, merchandises::fish, 11),
+                      station::NotEnoughStockError);
+    BOOST_CHECK_THROW(warehouse.loadTrain(train, merchandises::wood, 20), train::CannotBuyError);
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 20);
+    BOOST_TEST(train.canSell(merchandises::wood, 30));
+
+    // unload the whole train in another warehouse
+    station::Warehouse other;
+    other.store(merchandises::wood, 10, 40);
+    BOOST_TEST(other.unloadTrain(train) == 40);
+    BOOST_TEST(!train.canSell(merchandises::wood, 1));
+    BOOST_TEST(!train.canSell(merchandises::fish, 1));
+    BOOST_TEST(other.getQuantity(merchandises::wood) == 40);
+    BOOST_TEST(other.getPrice(merchandises::wood) == 17);
+    BOOST_TEST(other.getQuantity(merchandises::fish) == 10);
+    BOOST_TEST(other.getPrice(merchandises::fish) == 6);
+
+    // an empty train unloads nothing
+    BOOST_TEST(other.unloadTrain(train) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testMove) {
+    // create warehouses with different merchs
+    station::Warehouse warehouse;
+    warehouse.store(merchandises::wood, 10, 10);
+    warehouse.store(merchandises::meat, 5, 20);
+    station::Warehouse other;
+    other.store(merchandises::wood, 30, 30);
+
+    // move all the merchandise
+    warehouse.moveTo(other);
+    BOOST_TEST(warehouse.getQuantity(merchandises::wood) == 0);
+    BOOST_TEST(warehouse.getQuantity(merchandises::meat) == 0);
+    BOOST_TEST(other.getQuantity(merchandises::wood) == 40);
+    BOOST_TEST(other.getPrice(merchandises::wood) == 25);
+    BOOST_TEST(other.getQuantity(merchandises::meat) == 5);
+
+    // moving to itself keeps the merchandise
+    other.moveTo(other);
+    BOOST_TEST(other.getQuantity(merchandises::wood) == 40);
+}
+
+BOOST_AUTO_TEST_CASE(testMemoryUsage) {
+    // an empty warehouse does not allocate
+    station::Warehouse warehouse;
+    BOOST_TEST(warehouse.getMemoryUsage() == sizeof(station::Warehouse));
+
+    // stocks are created up to the last merch stored
+    warehouse.store(merchandises::alcohol, 1, 1);
+    std::size_t index = catalogs::getMerchs().getIndex(merchandises::alcohol.getId());
+    BOOST_TEST(warehouse.getMemoryUsage() ==
+               sizeof(station::Warehouse) + (index + 1) * sizeof(station::Stock));
+
+    // a full warehouse holds one small stock per merch
+    warehouse.store(merchandises::wood, 1, 1);
+    std::size_t full = catalogs::getMerchs().size() * 2 * sizeof(station::Stock);
+    BOOST_TEST(warehouse.getMemoryUsage() <= sizeof(station::Warehouse) + full);
+    BOOST_TEST(sizeof(station::Stock) <= 16);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
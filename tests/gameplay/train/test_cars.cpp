@@ -67,6 +67,13 @@ BOOST_AUTO_TEST_CASE(testRepair) {
     cargo.repair();
     BOOST_TEST(cargo.getHealth() == cargo.getMaxHealth());
 
+    // repair it partly, then more than needed
+    cargo.takeDammage(90);
+    cargo.repair(30);
+    BOOST_TEST(cargo.getHealth() == 40);
+    cargo.repair(100);
+    BOOST_TEST(cargo.getHealth() == cargo.getMaxHealth());
+
     // destroy the car
     cargo.takeDammage(200);
     BOOST_TEST(cargo.getHealth() == -100);
@@ -74,6 +81,7 @@ BOOST_AUTO_TEST_CASE(testRepair) {
 
     // try to repair it
     BOOST_CHECK_THROW(cargo.repair(), cars::DestroyedCarError);
+    BOOST_CHECK_THROW(cargo.repair(10), cars::DestroyedCarError);
 }
 
 BOOST_AUTO_TEST_SUITE_END() // normalCar
@@ -266,6 +274,57 @@ BOOST_AUTO_TEST_CASE(testUnLoad) {
     BOOST_CHECK_THROW(cargo.unLoad(-10), cars::NotEnoughLoadError);
 }
 
+BOOST_AUTO_TEST_CASE(testTransfer) {
+    // create merchs and cars
+    merchandises::Merch lumber(100, "lumber", merchandises::MerchTypes::box);
+    merchandises::Merch whisky(101, "whisky", merchandises::MerchTypes::drinkable);
+    merchandises::MerchLoad lumberInTrain(lumber, 20, 40);
+    merchandises::MerchLoad lumberInCity(lumber, 10, 100);
+    cars::LoadCar cargo1(1, "cargo", 100, 25, merchandises::MerchTypes::box, lumberInTrain);
+    cars::LoadCar cargo2(1, "cargo", 100, 25, merchandises::MerchTypes::box);
+    cars::LoadCar cargo3(1, "cargo", 100, 25, merchandises::MerchTypes::box, lumberInCity);
+    cars::LoadCar tank(2, "tank", 100, 25, merchandises::MerchTypes::drinkable);
+    types::id loadId = cargo1.getMerchLoad()->getLoadId();
+
+    // transfer part of a load to an empty car
+    cargo1.transfer(cargo2, 8);
+    BOOST_TEST(cargo1.getQuantity() == 12);
+    BOOST_TEST(cargo1.getMerchLoad()->getLoadId() == loadId);
+    BOOST_TEST(cargo2.getQuantity() == 8);
+    BOOST_TEST(cargo2.getMerchLoad()->getPrice() == 40);
+    BOOST_TEST(cargo2.getWeight() == 108, tt::tolerance(0.01));
+
+    // transfer to a car holding the same merch, averaging the price in place
+    types::id otherLoadId = cargo3.getMerchLoad()->getLoadId();
+    cargo1.transfer(cargo3, 10);
+    BOOST_TEST(cargo3.getQuantity() == 20);
+    BOOST_TEST(cargo3.getMerchLoad()->getPrice() == 70);
+    BOOST_TEST(cargo3.getMerchLoad()->getLoadId() == otherLoadId);
+
+    // transfers are checked before moving anything
+    BOOST_CHECK_THROW(cargo2.transfer(cargo3, 6), cars::NotEnoughSpaceError);
+    BOOST_CHECK_THROW(cargo2.transfer(cargo1, 9), cars::NotEnoughLoadError);
+    BOOST_CHECK_THROW(cargo2.transfer(tank, 1), cars::CannotLoadError);
+    BOOST_TEST(cargo2.getQuantity() == 8);
+    BOOST_TEST(cargo3.getQuantity() == 20);
+    BOOST_TEST(tank.isEmpty());
+
+    // a whole load is handed over to an empty car
+    cargo2.unLoad(8);
+    cargo1.transfer(cargo2, 2);
+    BOOST_TEST(cargo1.isEmpty());
+    BOOST_TEST(cargo2.getQuantity() == 2);
+    BOOST_TEST(cargo2.getMerchLoad()->getLoadId() == loadId);
+    BOOST_CHECK_THROW(cargo1.transfer(cargo2, 1), cars::NotEnoughLoadError);
+    merchandises::MerchLoad whiskyInCity(whisky, 10, 100);
+    tank.load(whiskyInCity, 5);
+    BOOST_CHECK_THROW(tank.transfer(cargo1, 1), cars::CannotLoadError);
+
+    // destroyed cars cannot transfer
+    cargo3.takeDammage(cargo3.getMaxHealth());
+    BOOST_CHECK_THROW(cargo2.transfer(cargo3, 1), cars::DestroyedCarError);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // loadCar
 
 BOOST_AUTO_TEST_SUITE(loadCarModel)
@@ -303,6 +362,30 @@ BOOST_AUTO_TEST_CASE(testCallOperator) {
     BOOST_TEST(cargo4.getHealth() == 50);
 }
 
+BOOST_AUTO_TEST_CASE(testState) {
+    merchandises::Merch lumber(100, "lumber", merchandises::MerchTypes::box);
+    merchandises::MerchLoad lumberInCity(lumber, 10, 100);
+    const cars::LoadCarModel Cargo(1, "cargo", 45, 20, merchandises::MerchTypes::box);
+
+    // cars of a model share its cold data
+    cars::LoadCar cargo1 = Cargo();
+    cars::LoadCar cargo2 = Cargo(50);
+    BOOST_TEST(cargo1.getInfo() == Cargo.getInfo());
+    BOOST_TEST(cargo2.getInfo() == Cargo.getInfo());
+    BOOST_TEST(cargo1.getInfo()->maxQuantity == 20);
+
+    // the hot state follows the car
+    BOOST_TEST(cargo2.getState().health == 50);
+    BOOST_TEST(cargo1.getState().weight == 45, tt::tolerance(0.01f));
+    BOOST_TEST(cargo1.getState().quantity == 0);
+    cargo1.load(lumberInCity, 4);
+    BOOST_TEST(cargo1.getState().quantity == 4);
+    cargo1.unLoad(4);
+    BOOST_TEST(cargo1.getState().quantity == 0);
+    cargo1.takeDammage(30);
+    BOOST_TEST(cargo1.getState().health == 70);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // loadCarModel
 
 BOOST_AUTO_TEST_SUITE_END() // cars
@@ -0,0 +1,45 @@
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/train/catalogs.hpp"
+
+BOOST_AUTO_TEST_SUITE(catalogs)
+
+BOOST_AUTO_TEST_CASE(testMerchs) {
+    catalogs::MerchCatalog& merchs = catalogs::getMerchs();
+    BOOST_TEST(merchs.size() >= 16);
+
+    // built-in merchs are found by name and by ID
+    BOOST_CHECK(merchs.getByName("wolf meat") == merchandises::meat);
+    BOOST_CHECK(merchs.getById(4) == merchandises::fish);
+    BOOST_TEST(merchs.getById(13).getName() == "rails");
+    BOOST_CHECK((merchs.getByName("oil").getType() == merchandises::MerchTypes::toxic));
+    BOOST_CHECK(!merchs.findByName("wolf"));
+    BOOST_CHECK(!merchs.findById(0));
+}
+
+BOOST_AUTO_TEST_CASE(testCarModels) {
+    catalogs::CarModelCatalog& carModels = catalogs::getCarModels();
+    BOOST_TEST(carModels.size() >= 5);
+
+    // built-in models are found by name and by ID
+    BOOST_TEST(carModels.getByName("oil tank").getId() == cars::OilTank.getId());
+    BOOST_TEST(carModels.getById(102).getName() == "merchandise XL");
+    BOOST_TEST(carModels.getById(101).getMaxQuantity() == 20);
+    BOOST_CHECK(!carModels.findByName("tender"));
+}
+
+BOOST_AUTO_TEST_CASE(testMods) {
+    catalogs::MerchCatalog& merchs = catalogs::getMerchs();
+
+    // mods add their own merchs
+    const merchandises::Merch& ice = merchs.emplace(1001, "ice", merchandises::MerchTypes::box);
+    BOOST_CHECK(merchs.getByName("ice") == ice);
+    BOOST_CHECK(merchs.getById(1001) == ice);
+    BOOST_CHECK(merchs.getByName("fish") == merchandises::fish);
+
+    // built-in merchs cannot be replaced
+    BOOST_CHECK_THROW(merchs.emplace(1002, "fish", merchandises::MerchTypes::box),
+                      catalog::DuplicateEntryError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
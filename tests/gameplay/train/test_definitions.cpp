@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/train/definitions.hpp"
+
+namespace {
+
+/**
+ * Definitions of a small mod.
+ */
+const char* const text =
+    "# a small mod\n"
+    "\n"
+    "merch 1001 ice box\n"
+    "merch 1002 \"reindeer milk\" drinkable\n"
+    "car 201 \"flat car\" 30 25 box\n";
+
+}
+
+BOOST_AUTO_TEST_SUITE(definitions)
+
+BOOST_AUTO_TEST_CASE(testLoadText) {
+    catalogs::MerchCatalog merchs;
+    catalogs::CarModelCatalog carModels;
+    std::istringstream stream(text);
+    BOOST_TEST(definitions::loadText(stream, merchs, carModels) == 3);
+
+    // entries are added to the catalogs
+    BOOST_TEST(merchs.getById(1001).getName() == "ice");
+    BOOST_CHECK((merchs.getByName("reindeer milk").getType() ==
+                 merchandises::MerchTypes::drinkable));
+    BOOST_TEST(carModels.getByName("flat car").getId() == 201);
+    BOOST_TEST(carModels.getById(201).getMaxQuantity() == 25);
+    BOOST_TEST(carModels.getById(201).getWeight() == 30);
+}
+
+BOOST_AUTO_TEST_CASE(testLoadTextErrors) {
+    const char* texts[] = {
+        "train 1 ice box\n",
+        "merch ice box\n",
+        "merch 1 ice\n",
+        "merch 1 ice metal\n",
+        "merch 1 \"ice box\n",
+        "merch 1 ice box box\n",
+        "car 1 \"flat car\" heavy 25 box\n",
+        "car 1 \"flat car\" 30 25 null\n",
+    };
+
+    for (const auto text : texts) {
+        catalogs::MerchCatalog merchs;
+        catalogs::CarModelCatalog carModels;
+        std::istringstream stream(text);
+        BOOST_CHECK_THROW(definitions::loadText(stream, merchs, carModels),
+                          definitions::DefinitionError);
+        BOOST_TEST(merchs.size() == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testLoadTextDuplicates) {
+    const char* texts[] = {
+        "merch 1001 ice box\nmerch 1003 lichen vegetal\nmerch 1001 snow box\n",
+        "merch 1001 ice box\nmerch 1003 lichen vegetal\nmerch 1004 ice box\n",
+        "merch 1001 ice box\ncar 201 \"flat car\" 30 25 box\ncar 202 \"flat car\" 30 25 box\n",
+        "merch 1001 ice box\ncar 201 \"flat car\" 30 25 box\nmerch 1002 \"reindeer milk\" box\n",
+    };
+
+    for (const auto text : texts) {
+        catalogs::MerchCatalog merchs;
+        catalogs::CarModelCatalog carModels;
+        merchs.emplace(1002, "reindeer milk", merchandises::MerchTypes::drinkable);
+
+        // a duplicate on the last line leaves the catalogs untouched
+        std::istringstream stream(text);
+        BOOST_CHECK_THROW(definitions::loadText(stream, merchs, carModels),
+                          catalog::DuplicateEntryError);
+        BOOST_TEST(merchs.size() == 1);
+        BOOST_TEST(carModels.size() == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testLoadCache) {
+    const std::string path = "test_definitions.txt";
+    const std::string cachePath = "test_definitions.cache";
+    std::remove(cachePath.c_str());
+
+    {
+        std::ofstream file(path);
+        file << text;
+    }
+
+    // the first load compiles the cache
+    {
+        catalogs::MerchCatalog merchs;
+        catalogs::CarModelCatalog carModels;
+        BOOST_CHECK(!definitions::load(path, cachePath, merchs, carModels));
+        BOOST_TEST(merchs.size() == 2);
+        BOOST_TEST(carModels.size() == 1);
+    }
+
+    // later loads map it
+    {
+        catalogs::MerchCatalog merchs;
+        catalogs::CarModelCatalog carModels;
+        BOOST_CHECK(definitions::load(path, cachePath, merchs, carModels));
+        BOOST_TEST(merchs.getByName("reindeer milk").getId() == 1002);
+        BOOST_TEST(carModels.getByName("flat car").getMaxQuantity() == 25);
+    }
+
+    // changing the text file makes the cache outdated
+    {
+        std::ofstream file(path, std::ios::app);
+        file << "merch 1003 lichen vegetal\n";
+    }
+
+    {
+        catalogs::MerchCatalog merchs;
+        catalogs::CarModelCatalog carModels;
+        BOOST_CHECK(!definitions::load(path, cachePath, merchs, carModels));
+        BOOST_TEST(merchs.size() == 3);
+    }
+
+    // a corrupted cache is compiled again
+    {
+        std::fstream file(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(0);
+        file << "garbage";
+    }
+
+    {
+        catalogs::MerchCatalog merchs;
+        catalogs::CarModelCatalog carModels;
+        BOOST_CHECK(!definitions::load(path, cachePath, merchs, carModels));
+        BOOST_TEST(merchs.size() == 3);
+    }
+
+    std::remove(path.c_str());
+    std::remove(cachePath.c_str());
+
+    catalogs::MerchCatalog merchs;
+    catalogs::CarModelCatalog carModels;
+    BOOST_CHECK_THROW(definitions::load(path, cachePath, merchs, carModels),
+                      definitions::FileError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
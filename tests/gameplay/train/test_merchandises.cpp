@@ -123,6 +123,33 @@ BOOST_AUTO_TEST_CASE(testAdditions) {
     BOOST_CHECK_THROW(lumberLoad1.split(10), merchandises::NotEnoughLoadError);
 }
 
+BOOST_AUTO_TEST_CASE(testFixedPoint) {
+    merchandises::Merch lumber(1, "lumber", merchandises::MerchTypes::box);
+
+    // merging one unit at a time does not truncate the average
+    merchandises::MerchLoad lumberLoad(lumber, 1, 10);
+
+    for (int index = 0; index < 9; index++) {
+        lumberLoad.add(1, 11);
+    }
+
+    BOOST_TEST(lumberLoad.getCost() == 109000);
+    BOOST_TEST(lumberLoad.getPrice() == 10);
+    BOOST_TEST(lumberLoad.getValue() == 109 * merchandises::moneyScale);
+
+    // the average is rounded to the nearest unit of money
+    lumberLoad.addAtCost(2, 0);
+    BOOST_TEST(lumberLoad.getCost() == 90833);
+
+    // large quantities at high prices do not overflow
+    merchandises::MerchLoad bulkLoad(lumber, 4000000000u, 65535);
+    bulkLoad.add(200000000, 1);
+    BOOST_TEST(bulkLoad.getQuantity() == 4200000000u);
+    BOOST_TEST(bulkLoad.getPrice() == 62414);
+    BOOST_TEST(bulkLoad.getCost() == 624143333);
+    BOOST_TEST(bulkLoad.getValue() == 4200000000ll * 624143333);
+}
+
 BOOST_AUTO_TEST_CASE(testAdditionsError) {
     // create two merchs
     merchandises::Merch lumber(1, "lumber", merchandises::MerchTypes::box);
@@ -0,0 +1,58 @@
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/train/traction.hpp"
+
+namespace tt = boost::test_tools;
+
+BOOST_AUTO_TEST_SUITE(traction)
+
+BOOST_AUTO_TEST_CASE(testCompute) {
+    // compute traction of a train
+    traction::Traction light = traction::compute(400, 1000);
+    BOOST_TEST(light.weight == 400, tt::tolerance(0.01));
+    BOOST_TEST(light.power == 1000, tt::tolerance(0.01));
+    BOOST_TEST(light.maxSpeed == 50, tt::tolerance(0.01));
+    BOOST_TEST(light.coalConsumption == 0.3, tt::tolerance(0.01));
+
+    // a heavier train is slower
+    traction::Traction heavy = traction::compute(800, 1000);
+    BOOST_TEST(heavy.maxSpeed == 25, tt::tolerance(0.01));
+    BOOST_TEST(heavy.acceleration < light.acceleration);
+    BOOST_TEST(heavy.coalConsumption == light.coalConsumption, tt::tolerance(0.01));
+
+    // a very light train is limited by the rails
+    traction::Traction fast = traction::compute(10, 1000);
+    BOOST_TEST(fast.maxSpeed == traction::speedLimit, tt::tolerance(0.01));
+
+    // nothing moves without power
+    traction::Traction none = traction::compute(400, 0);
+    BOOST_TEST(none.maxSpeed == 0, tt::tolerance(0.01));
+    BOOST_TEST(none.acceleration == 0, tt::tolerance(0.01));
+}
+
+BOOST_AUTO_TEST_CASE(testStep) {
+    traction::Traction traction = traction::compute(400, 1000);
+    traction::Motion motion = {0, 10};
+
+    // accelerate at full throttle
+    traction::step(traction, motion, 1, 0.01);
+    BOOST_TEST(motion.speed > 0);
+    BOOST_TEST(motion.speed < traction.maxSpeed);
+    BOOST_TEST(motion.coal == 10 - traction.coalConsumption * 0.01, tt::tolerance(0.01));
+
+    // reach max speed after a while
+    traction::step(traction, motion, 1, 2);
+    BOOST_TEST(motion.speed == traction.maxSpeed, tt::tolerance(0.01));
+
+    // slow down at half throttle
+    traction::step(traction, motion, 0.5, 2);
+    BOOST_TEST(motion.speed == traction.maxSpeed / 2, tt::tolerance(0.01));
+
+    // slow down without coal
+    motion.coal = 0;
+    traction::step(traction, motion, 1, 2);
+    BOOST_TEST(motion.speed < 0.01);
+    BOOST_TEST(motion.coal == 0, tt::tolerance(0.01));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // traction
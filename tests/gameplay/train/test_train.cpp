@@ -1,8 +1,12 @@
 #include <boost/test/unit_test.hpp>
 
 #include "gameplay/train/cars.hpp"
+#include "gameplay/train/cars_data.hpp"
+#include "gameplay/train/merchandises_data.hpp"
 #include "gameplay/train/train.hpp"
 
+namespace tt = boost::test_tools;
+
 BOOST_AUTO_TEST_SUITE(train)
 
 BOOST_AUTO_TEST_SUITE(consist)
@@ -22,6 +26,554 @@ BOOST_AUTO_TEST_CASE(testCreate) {
     BOOST_TEST(train.getCar(cargo2->getCarId()) == cargo2);
 }
 
+BOOST_AUTO_TEST_CASE(testRemove) {
+    // create a train with a locomotive and a cargo
+    train::Train train;
+    auto locomotive = std::make_shared<cars::Locomotive>(1, "locomotive", 355, 1000);
+    auto cargo = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(locomotive);
+    train.addCar(cargo);
+    BOOST_TEST(train.getSize() == 2);
+
+    // remove the cargo
+    BOOST_TEST(train.removeCar(cargo->getCarId()) == cargo);
+    BOOST_TEST(train.getSize() == 1);
+    BOOST_CHECK_THROW(train.getCar(cargo->getCarId()), train::CarNotFoundError);
+
+    // the locomotive cannot be removed
+    BOOST_CHECK_THROW(train.removeCar(locomotive->getCarId()), train::SpecialCarRemoveError);
+}
+
+BOOST_AUTO_TEST_CASE(testHandles) {
+    // create a train with a shared car and an owned car
+    train::Train train;
+    auto shared = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train::CarHandle sharedHandle = train.addCar(shared);
+    train::CarHandle ownedHandle = train.makeOwnedCar<cars::LoadCar>(cars::MerchandiseXL());
+    BOOST_TEST(sizeof(train::CarHandle) <= sizeof(void*));
+
+    // access cars by handle
+    BOOST_TEST(&train.get(sharedHandle) == shared.get());
+    BOOST_TEST(train.get(ownedHandle).getName() == "merchandise XL");
+    types::id ownedId = train.get(ownedHandle).getCarId();
+    BOOST_TEST(train.getHandle(ownedId).index == ownedHandle.index);
+    BOOST_TEST(train.getCar(ownedId).get() == &train.get(ownedHandle));
+
+    // owned cars can be changed and moved as the others
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    static_cast<cars::LoadCar&>(train.get(ownedHandle)).load(fishInCity, 10);
+    BOOST_TEST(train.getWeight() == 45 + 55 + 10, tt::tolerance(0.01));
+    train.moveCar(ownedId, 0);
+    BOOST_TEST(train.getHandleAt(0).index == ownedHandle.index);
+    BOOST_TEST(train.getHandleAt(1).index == sharedHandle.index);
+    BOOST_CHECK_THROW(train.getHandleAt(2), train::CarInvalidPositionError);
+
+    // shared cars cannot be released
+    BOOST_CHECK_THROW(train.releaseCar(sharedHandle), train::NotOwnedCarError);
+
+    // release the owned car, its handle becomes stale
+    std::unique_ptr<cars::Car> owned = train.releaseCar(ownedHandle);
+    BOOST_TEST(owned->getCarId() == ownedId);
+    BOOST_TEST(!train.isValid(ownedHandle));
+    BOOST_CHECK_THROW(train.get(ownedHandle), train::StaleHandleError);
+
+    // the slot is reused, the old handle is still stale
+    train::CarHandle newHandle = train.addCar(std::move(owned));
+    BOOST_TEST(newHandle.index == ownedHandle.index);
+    BOOST_TEST(train.isValid(newHandle));
+    BOOST_TEST(!train.isValid(ownedHandle));
+
+    // removing an owned car gives its ownership
+    std::shared_ptr<cars::Car> removed = train.removeCar(ownedId);
+    BOOST_TEST(removed.use_count() == 1);
+    BOOST_TEST(removed->getObserver() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(testArena) {
+    // create a train using an arena
+    auto train = std::make_shared<train::Train>(4096);
+    std::weak_ptr<arena::Arena> arena = train->getArena();
+    BOOST_TEST(train->getArena()->getCount() == 0);
+
+    // create cars in the arena
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    auto cargo1 = train->makeCar<cars::LoadCar>(cars::Merchandise());
+    auto cargo2 = train->makeCar<cars::LoadCar>(cars::Merchandise());
+    BOOST_TEST(train->getCar(cargo1->getCarId()) == cargo1);
+    BOOST_TEST(cargo1->getArena() == train->getArena().get());
+    BOOST_TEST(train->getArena()->getCount() == 2);
+
+    // loads are created in the arena
+    cargo1->load(fishInCity, 10);
+    BOOST_TEST(train->getArena()->getCount() == 3);
+    cargo1->unLoad(10);
+    BOOST_TEST(train->getArena()->getCount() == 2);
+    BOOST_TEST(train->getMemoryUsage() >= 4096);
+
+    // the arena is released with the train and its cars
+    cargo1.reset();
+    cargo2.reset();
+    train.reset();
+    BOOST_TEST(arena.expired());
+}
+
+BOOST_AUTO_TEST_CASE(testArenaAllocations) {
+    // create a train using an arena, and a first car of the model
+    train::Train train(4096);
+    train.makeCar<cars::LoadCar>(1, "flat car", 30, 20, merchandises::MerchTypes::box);
+    const std::size_t carCount = 100;
+    std::size_t count = train.getArena()->getCount();
+
+    // cars created from an ID and a name are allocated in the arena, and share
+    // the cold data of their model
+    for (std::size_t index = 0; index < carCount; index++) {
+        train.makeCar<cars::LoadCar>(1, "flat car", 30, 20, merchandises::MerchTypes::box);
+    }
+
+    BOOST_TEST(train.getArena()->getCount() - count == carCount);
+
+    for (std::size_t index = 1; index <= carCount; index++) {
+        BOOST_TEST(train.get(train.getHandleAt(index)).getInfo() ==
+                   train.get(train.getHandleAt(0)).getInfo());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testMemoryUsage) {
+    // create a train on the heap
+    train::Train train;
+    std::size_t emptyMemory = train.getMemoryUsage();
+    BOOST_TEST(!train.getArena());
+
+    // cars are counted, but not the cold data shared with their model
+    auto cargo = train.makeCar<cars::LoadCar>(cars::Merchandise());
+    BOOST_TEST(cargo->getMemoryUsage() == sizeof(cars::LoadCar));
+    BOOST_TEST(train.getMemoryUsage() >= emptyMemory + sizeof(cars::LoadCar));
+
+    // short trains store their consist inline
+    std::size_t shortMemory = train.getMemoryUsage();
+
+    for (std::size_t index = 1; index < train::inlineCarCount; index++) {
+        train.addCar(std::make_shared<cars::LoadCar>(cars::Merchandise()));
+    }
+
+    BOOST_TEST(train.getMemoryUsage() == shortMemory + (train::inlineCarCount - 1) *
+               cargo->getMemoryUsage());
+
+    // long trains allocate it
+    std::size_t fullMemory = train.getMemoryUsage();
+    train.addCar(std::make_shared<cars::LoadCar>(cars::Merchandise()));
+    BOOST_TEST(train.getMemoryUsage() > fullMemory + cargo->getMemoryUsage());
+}
+
 BOOST_AUTO_TEST_SUITE_END() // consist
 
+BOOST_AUTO_TEST_SUITE(changes)
+
+BOOST_AUTO_TEST_CASE(testDrainChanges) {
+    // create a train
+    train::Train train;
+    auto cargo1 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    auto cargo2 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    auto cargo3 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(cargo1);
+    train.addCar(cargo2);
+    train.addCar(cargo3);
+
+    // added cars are reported once
+    auto changes = train.drainChanges();
+    BOOST_TEST(changes.size() == 3);
+    BOOST_TEST(changes[0].carId == cargo1->getCarId());
+    BOOST_TEST((changes[0].changes == cars::Change::added));
+    BOOST_TEST(!train.hasChanges());
+    BOOST_TEST(!cargo1->isDirty());
+
+    // change a car several times, it is reported once
+    merchandises::MerchLoad fishInCity(merchandises::fish, 20, 10);
+    cargo2->load(fishInCity, 5);
+    cargo2->takeDammage(10);
+    cargo2->unLoad(2);
+    BOOST_TEST(cargo2->isDirty());
+    changes = train.drainChanges();
+    BOOST_TEST(changes.size() == 1);
+    BOOST_TEST(changes[0].carId == cargo2->getCarId());
+    BOOST_TEST((changes[0].changes == (cars::Change::load | cars::Change::health)));
+
+    // nothing changed
+    BOOST_TEST(train.drainChanges().empty());
+
+    // move a car and remove a changed car
+    train.moveCar(cargo1->getCarId(), 2);
+    cargo3->repair();
+    train.removeCar(cargo3->getCarId());
+    BOOST_TEST(!cargo3->isDirty());
+    changes = train.drainChanges();
+    BOOST_TEST(changes.size() == 2);
+    BOOST_TEST((changes[0].changes == cars::Change::position));
+    BOOST_TEST(changes[1].carId == cargo3->getCarId());
+    BOOST_TEST((changes[1].changes == (cars::Change::health | cars::Change::removed)));
+
+    // removed cars are not watched anymore
+    cargo3->takeDammage(10);
+    BOOST_TEST(!train.hasChanges());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // changes
+
+BOOST_AUTO_TEST_SUITE(hash)
+
+BOOST_AUTO_TEST_CASE(testHash) {
+    // create a train
+    train::Train train;
+    std::uint64_t emptyHash = train.getHash();
+    BOOST_TEST(emptyHash == train.computeHash());
+    train.addCar(std::make_shared<cars::Locomotive>(1, "locomotive", 400, 1000));
+    auto cargo1 = train.makeCar<cars::LoadCar>(cars::Merchandise());
+    auto cargo2 = train.makeCar<cars::LoadCar>(cars::Merchandise());
+    std::uint64_t initialHash = train.getHash();
+    BOOST_TEST(initialHash != emptyHash);
+    BOOST_TEST(initialHash == train.computeHash());
+
+    // the hash follows the health of the cars
+    cargo1->takeDammage(10);
+    BOOST_TEST(train.getHash() != initialHash);
+    BOOST_TEST(train.getHash() == train.computeHash());
+    cargo1->repair();
+    BOOST_TEST(train.getHash() == initialHash);
+
+    // the hash follows the loads
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    cargo2->load(fishInCity, 10);
+    BOOST_TEST(train.getHash() != initialHash);
+    BOOST_TEST(train.getHash() == train.computeHash());
+    cargo2->unLoad(10);
+    BOOST_TEST(train.getHash() == initialHash);
+
+    // the hash follows the order of the cars
+    train.moveCar(cargo2->getCarId(), 1);
+    BOOST_TEST(train.getHash() != initialHash);
+    BOOST_TEST(train.getHash() == train.computeHash());
+    train.moveCar(cargo2->getCarId(), 2);
+    BOOST_TEST(train.getHash() == initialHash);
+
+    // the hash follows the cars
+    train.removeCar(cargo1->getCarId());
+    BOOST_TEST(train.getHash() == train.computeHash());
+    std::uint64_t removedHash = train.getHash();
+    train.removeCar(cargo2->getCarId());
+    BOOST_TEST(train.getHash() == train.computeHash());
+
+    // changes of removed cars do not count
+    cargo1->takeDammage(10);
+    BOOST_TEST(train.getHash() == train.computeHash());
+
+    // a car added back is attached again, so that trackers of the train do not
+    // keep the removed car
+    train.addCar(cargo2);
+    BOOST_TEST(train.getHash() != removedHash);
+    BOOST_TEST(train.getHash() == train.computeHash());
+}
+
+BOOST_AUTO_TEST_CASE(testDeterministic) {
+    // create a train
+    train::Train train;
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.makeCar<cars::LoadCar>(cars::Tank());
+
+    // the hash does not depend on the cars created before
+    auto unrelated = std::make_shared<cars::LoadCar>(cars::Tank());
+    train::Train other;
+    other.makeCar<cars::LoadCar>(cars::Merchandise());
+    other.makeCar<cars::LoadCar>(cars::Tank());
+    BOOST_TEST(other.get(other.getHandleAt(0)).getCarId() !=
+               train.get(train.getHandleAt(0)).getCarId());
+    BOOST_TEST(other.getHash() == train.getHash());
+
+    // but it depends on the order of the cars
+    other.moveCar(other.get(other.getHandleAt(1)).getCarId(), 0);
+    BOOST_TEST(other.getHash() != train.getHash());
+}
+
+BOOST_AUTO_TEST_CASE(testTransaction) {
+    train::Train train;
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.makeCar<cars::LoadCar>(cars::Tank());
+    std::uint64_t initialHash = train.getHash();
+
+    // a cancelled transaction leaves the hash untouched
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    BOOST_CHECK_THROW(train.buy(fishInCity, 30), train::CannotBuyError);
+    BOOST_TEST(train.getHash() == initialHash);
+
+    // trading updates the hash
+    train.buy(fishInCity, 20);
+    BOOST_TEST(train.getHash() == train.computeHash());
+    train.sell(merchandises::fish, 20);
+    BOOST_TEST(train.getHash() == initialHash);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(trade)
+
+BOOST_AUTO_TEST_CASE(testBuy) {
+    // create a train with two box cars and a tank
+    train::Train train;
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.makeCar<cars::LoadCar>(cars::Tank());
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+
+    // buy more than a car can hold
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    BOOST_CHECK(train.canBuy(fishInCity, 30));
+    train.buy(fishInCity, 30);
+    BOOST_TEST(fishInCity.getQuantity() == 20);
+    BOOST_TEST(static_cast<cars::LoadCar&>(train.get(train.getHandleAt(0))).getQuantity() == 20);
+    BOOST_TEST(static_cast<cars::LoadCar&>(train.get(train.getHandleAt(2))).getQuantity() == 10);
+    BOOST_CHECK(static_cast<cars::LoadCar&>(train.get(train.getHandleAt(1))).isEmpty());
+
+    // nothing is bought without enough space or merch
+    BOOST_CHECK(!train.canBuy(fishInCity, 15));
+    BOOST_CHECK_THROW(train.buy(fishInCity, 15), train::CannotBuyError);
+    BOOST_TEST(fishInCity.getQuantity() == 20);
+    merchandises::MerchLoad saltInCity(merchandises::salt, 5, 10);
+    BOOST_CHECK(!train.canBuy(saltInCity, 10));
+}
+
+BOOST_AUTO_TEST_CASE(testSell) {
+    train::Train train;
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    train.buy(fishInCity, 20);
+    merchandises::MerchLoad fishInPort(merchandises::fish, 50, 20);
+    train.buy(fishInPort, 20);
+
+    // sell merch from several cars, at the average price
+    BOOST_CHECK(train.canSell(merchandises::fish, 30));
+    merchandises::MerchLoad sold = train.sell(merchandises::fish, 30);
+    BOOST_TEST(sold.getQuantity() == 30);
+    BOOST_TEST(sold.getPrice() == 13);
+
+    // nothing is sold without enough merch
+    BOOST_CHECK(!train.canSell(merchandises::fish, 20));
+    BOOST_CHECK_THROW(train.sell(merchandises::fish, 20), train::CannotSellError);
+    BOOST_CHECK(!train.canSell(merchandises::salt, 1));
+    BOOST_CHECK(train.canSell(merchandises::fish, 10));
+}
+
+BOOST_AUTO_TEST_CASE(testTransfer) {
+    // create a train with fish in several cars
+    train::Train train;
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    train.buy(fishInCity, 35);
+    merchandises::MerchLoad saltInCity(merchandises::salt, 50, 10);
+    train.buy(saltInCity, 5);
+
+    // create another train with some fish already and a tank
+    train::Train other;
+    other.makeCar<cars::LoadCar>(cars::Tank());
+    other.makeCar<cars::LoadCar>(cars::Merchandise());
+    other.makeCar<cars::LoadCar>(cars::MerchandiseXL());
+    merchandises::MerchLoad fishInPort(merchandises::fish, 50, 20);
+    other.buy(fishInPort, 15);
+    BOOST_CHECK(other.canReceive(merchandises::fish, 45));
+    BOOST_CHECK(!other.canReceive(merchandises::fish, 46));
+
+    // transfer fish over several cars of both trains
+    train.transfer(other, merchandises::fish, 30);
+    auto getCar = [](const train::Train & train, const std::size_t position) {
+        return static_cast<cars::LoadCar&>(train.get(train.getHandleAt(position)));
+    };
+    BOOST_TEST(getCar(train, 0).isEmpty());
+    BOOST_TEST(getCar(train, 1).getQuantity() == 5);
+    BOOST_TEST(getCar(other, 0).isEmpty());
+    BOOST_TEST(getCar(other, 1).getQuantity() == 20);
+    BOOST_TEST(getCar(other, 1).getMerchLoad()->getPrice() == 17);
+    BOOST_TEST(getCar(other, 2).getQuantity() == 25);
+    BOOST_TEST(other.getHash() == other.computeHash());
+    BOOST_TEST(train.getHash() == train.computeHash());
+
+    // nothing is transferred without enough merch or space
+    BOOST_CHECK_THROW(train.transfer(other, merchandises::fish, 6), train::CannotTransferError);
+    BOOST_CHECK_THROW(train.transfer(other, merchandises::salt, 16), train::CannotTransferError);
+    BOOST_CHECK_THROW(other.transfer(train, merchandises::fish, 41), train::CannotTransferError);
+    BOOST_CHECK(train.canSell(merchandises::fish, 5));
+    BOOST_CHECK(other.canSell(merchandises::fish, 45));
+}
+
+BOOST_AUTO_TEST_CASE(testConsolidate) {
+    // create a train with merchs spread thinly
+    train::Train train;
+    std::vector<std::shared_ptr<cars::LoadCar>> loadCars;
+    auto addCar = [&](const cars::LoadCarModel & model, const merchandises::Merch & merch,
+    const types::quantity quantity, const types::price price) {
+        merchandises::MerchLoad merchLoad(merch, quantity, price);
+        loadCars.push_back(std::make_shared<cars::LoadCar>(model(merchLoad)));
+        train.addCar(loadCars.back());
+    };
+    addCar(cars::Merchandise, merchandises::fish, 5, 10);
+    addCar(cars::Merchandise, merchandises::salt, 15, 10);
+    addCar(cars::Merchandise, merchandises::fish, 10, 20);
+    addCar(cars::Tank, merchandises::alcohol, 5, 10);
+    addCar(cars::MerchandiseXL, merchandises::salt, 10, 40);
+    addCar(cars::Merchandise, merchandises::fish, 8, 10);
+    train.makeCar<cars::LoadCar>(cars::Merchandise());
+
+    // repack the merchs into the fewest cars
+    train::Consolidation consolidation = train.consolidate();
+    BOOST_TEST(consolidation.freedCars == 2);
+    BOOST_TEST(consolidation.freedCapacity == 40);
+    BOOST_TEST(loadCars[0]->isEmpty());
+    BOOST_TEST(loadCars[1]->isEmpty());
+    BOOST_TEST(loadCars[2]->getQuantity() == 15);
+    BOOST_TEST(loadCars[2]->getMerchLoad()->getPrice() == 16);
+    BOOST_TEST(loadCars[3]->getQuantity() == 5);
+    BOOST_TEST(loadCars[4]->getQuantity() == 25);
+    BOOST_TEST(loadCars[4]->getMerchLoad()->getPrice() == 22);
+    BOOST_TEST(loadCars[5]->getQuantity() == 8);
+    BOOST_CHECK(train.canSell(merchandises::fish, 23));
+    BOOST_CHECK(train.canSell(merchandises::salt, 25));
+    BOOST_TEST(train.getHash() == train.computeHash());
+
+    // packed cargo stays as is
+    consolidation = train.consolidate();
+    BOOST_TEST(consolidation.freedCars == 0);
+    BOOST_TEST(consolidation.freedCapacity == 0);
+    BOOST_TEST(loadCars[2]->getQuantity() == 15);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(movement)
+
+BOOST_AUTO_TEST_CASE(testTraction) {
+    // create a train with a locomotive and a cargo
+    train::Train train;
+    auto locomotive = std::make_shared<cars::Locomotive>(1, "locomotive", 355, 1000);
+    auto cargo = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(locomotive);
+    train.addCar(cargo);
+    BOOST_TEST(train.getWeight() == 400, tt::tolerance(0.01));
+    BOOST_TEST(train.getPower() == 1000, tt::tolerance(0.01));
+    types::speed emptySpeed = train.getTraction().maxSpeed;
+
+    // load the cargo directly, the train notices it
+    merchandises::MerchLoad fishInCity(merchandises::fish, 20, 10);
+    cargo->load(fishInCity);
+    BOOST_TEST(train.getWeight() == 420, tt::tolerance(0.01));
+    BOOST_TEST(train.getTraction().maxSpeed < emptySpeed);
+
+    // destroy the locomotive
+    locomotive->takeDammage(200);
+    BOOST_TEST(train.getPower() == 0, tt::tolerance(0.01));
+
+    // remove the cargo, the train does not watch it anymore
+    train.removeCar(cargo->getCarId());
+    BOOST_TEST(cargo->getObserver() == nullptr);
+    BOOST_TEST(train.getWeight() == 355, tt::tolerance(0.01));
+}
+
+BOOST_AUTO_TEST_CASE(testValue) {
+    // create two trains with cargos
+    train::Train train;
+    train.makeOwnedCar<cars::Locomotive>(1, "locomotive", 355, 1000);
+    auto cargo = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(cargo);
+    train.makeOwnedCar<cars::LoadCar>(cars::Merchandise());
+    train::Train other;
+    other.makeOwnedCar<cars::LoadCar>(cars::Tank());
+    BOOST_TEST(train.computeValue() == 0);
+
+    // the value follows the loads of the cars
+    merchandises::MerchLoad fishInCity(merchandises::fish, 30, 10);
+    train.buy(fishInCity, 30);
+    BOOST_TEST(train.computeValue() == 300 * merchandises::moneyScale);
+    merchandises::MerchLoad fishInPort(merchandises::fish, 5, 13);
+    train.buy(fishInPort, 5);
+    BOOST_TEST(train.computeValue() == 365 * merchandises::moneyScale);
+    merchandises::MerchLoad alcoholInCity(merchandises::alcohol, 10, 3);
+    other.buy(alcoholInCity, 10);
+    BOOST_TEST(train::computeValue({&train, &other}) == 395 * merchandises::moneyScale);
+
+    // destroyed cars are not counted
+    types::money cargoValue = cargo->getMerchLoad()->getValue();
+    cargo->takeDammage(200);
+    BOOST_TEST(train.computeValue() == 365 * merchandises::moneyScale - cargoValue);
+}
+
+BOOST_AUTO_TEST_CASE(testPackedStates) {
+    // create a train with a locomotive and cargos
+    train::Train train;
+    auto locomotive = std::make_shared<cars::Locomotive>(1, "locomotive", 355, 1000);
+    auto cargo = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(locomotive);
+    train.addCar(cargo);
+    auto other = train.makeOwnedCar<cars::LoadCar>(cars::Tank());
+
+    // the packed states follow the cars, whatever their slot
+    merchandises::MerchLoad fishInCity(merchandises::fish, 20, 10);
+    cargo->load(fishInCity);
+    BOOST_TEST(train.computeTraction().weight == 355 + 45 + 20 + 40, tt::tolerance(0.01f));
+    train.releaseCar(other);
+    BOOST_TEST(train.computeTraction().weight == 355 + 45 + 20, tt::tolerance(0.01f));
+    train.moveCar(cargo->getCarId(), 0);
+    train.addCar(std::make_shared<cars::LoadCar>(cars::Tank()));
+    BOOST_TEST(train.computeTraction().weight == 355 + 45 + 20 + 40, tt::tolerance(0.01f));
+
+    // destroyed cars only count their base weight
+    cargo->takeDammage(200);
+    BOOST_TEST(train.computeTraction().weight == 355 + 45 + 40, tt::tolerance(0.01f));
+    BOOST_TEST(train.computeTraction().weight == train.getWeight(), tt::tolerance(0.01f));
+    BOOST_TEST(train.computeTraction().power == 1000, tt::tolerance(0.01f));
+
+    // loads given by pointer are copied, changing them does not stale the states
+    auto load = std::make_shared<merchandises::MerchLoad>(merchandises::fish, 10, 10);
+    auto sharing = std::make_shared<cars::LoadCar>(1, "cargo", 10, 20,
+                   merchandises::MerchTypes::box, load);
+    train.addCar(sharing);
+    load->add(5, 10);
+    BOOST_TEST(sharing->getQuantity() == 10);
+    BOOST_TEST(train.computeTraction().weight == 355 + 45 + 40 + 10 + 10, tt::tolerance(0.01f));
+    BOOST_TEST(train.computeValue() == 100 * merchandises::moneyScale);
+}
+
+BOOST_AUTO_TEST_CASE(testCopiedStates) {
+    // create a loaded car and a copy of it
+    merchandises::MerchLoad fishInCity(merchandises::fish, 10, 10);
+    cars::LoadCar original = cars::Merchandise(fishInCity);
+    cars::LoadCar copy = original;
+    BOOST_TEST(copy.getMerchLoad() != original.getMerchLoad());
+
+    // loading the copy leaves the original and its packed state untouched
+    merchandises::MerchLoad fishInPort(merchandises::fish, 5, 10);
+    copy.load(fishInPort, 5);
+    BOOST_TEST(copy.getState().quantity == 15);
+    BOOST_TEST(original.getMerchLoad()->getQuantity() == 10);
+    BOOST_TEST(original.getState().quantity == 10);
+    BOOST_TEST(original.getWeight() == 55, tt::tolerance(0.01f));
+}
+
+BOOST_AUTO_TEST_CASE(testTick) {
+    // create a train with a locomotive
+    train::Train train;
+    train.addCar(std::make_shared<cars::Locomotive>(1, "locomotive", 400, 1000));
+    BOOST_CHECK_THROW(train.setThrottle(2), train::InvalidThrottleError);
+
+    // the train does not move without coal
+    train.setThrottle(1);
+    train.tick(0.1);
+    BOOST_TEST(train.getSpeed() == 0, tt::tolerance(0.01));
+
+    // add coal and move
+    train.addCoal(10);
+    train.tick(0.1);
+    BOOST_TEST(train.getSpeed() > 0);
+    BOOST_TEST(train.getCoal() < 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // movement
+
 BOOST_AUTO_TEST_SUITE_END() // train
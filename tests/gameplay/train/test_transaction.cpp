@@ -0,0 +1,127 @@
+#include <boost/test/unit_test.hpp>
+
+#include "gameplay/train/cars.hpp"
+#include "gameplay/train/train.hpp"
+#include "gameplay/train/transaction.hpp"
+
+BOOST_AUTO_TEST_SUITE(train)
+
+BOOST_AUTO_TEST_SUITE(transaction)
+
+BOOST_AUTO_TEST_CASE(testCommit) {
+    // create a train with two cargos
+    train::Train train;
+    auto cargo1 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    auto cargo2 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(cargo1);
+    train.addCar(cargo2);
+
+    // buy fish in both cars
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    train::Transaction transaction = train.beginTransaction();
+    transaction.load(cargo1->getCarId(), fishInCity, 20);
+    transaction.load(cargo2->getCarId(), fishInCity, 15);
+    BOOST_TEST(transaction.getSize() == 2);
+    BOOST_TEST(cargo1->isEmpty());
+
+    transaction.commit();
+    BOOST_TEST(transaction.getSize() == 0);
+    BOOST_TEST(cargo1->getQuantity() == 20);
+    BOOST_TEST(cargo2->getQuantity() == 15);
+    BOOST_TEST(fishInCity.getQuantity() == 15);
+
+    // sell some of it back
+    transaction.unLoad(cargo1->getCarId(), fishInCity, 20);
+    transaction.unLoad(cargo2->getCarId(), fishInCity, 5);
+    transaction.commit();
+    BOOST_TEST(cargo1->isEmpty());
+    BOOST_TEST(cargo2->getQuantity() == 10);
+    BOOST_TEST(fishInCity.getQuantity() == 40);
+
+    // stage operations and cancel them
+    transaction.load(cargo1->getCarId(), fishInCity, 10);
+    transaction.cancel();
+    transaction.commit();
+    BOOST_TEST(cargo1->isEmpty());
+
+    // only cars of the train can be used
+    auto cargo3 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    BOOST_CHECK_THROW(transaction.load(cargo3->getCarId(), fishInCity, 10),
+                      train::CarNotFoundError);
+}
+
+BOOST_AUTO_TEST_CASE(testRollBack) {
+    // create a train with three cargos, the last one almost full
+    train::Train train;
+    auto cargo1 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    auto cargo2 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    merchandises::MerchLoad fishInTrain(merchandises::fish, 15, 30);
+    auto cargo3 = std::make_shared<cars::LoadCar>(cars::Merchandise(fishInTrain));
+    auto crane = std::make_shared<cars::NormalCar>(1, "crane", 50);
+    train.addCar(cargo1);
+    train.addCar(cargo2);
+    train.addCar(cargo3);
+    train.addCar(crane);
+    BOOST_CHECK_THROW(train.beginTransaction().load(crane->getCarId(), fishInTrain, 1),
+                      train::NotLoadCarError);
+
+    // buying in all cars fails on the last one
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    train::Transaction transaction = train.beginTransaction();
+    transaction.load(cargo1->getCarId(), fishInCity, 20);
+    transaction.load(cargo2->getCarId(), fishInCity, 10);
+    transaction.load(cargo3->getCarId(), fishInCity, 10);
+    BOOST_CHECK_THROW(transaction.commit(), cars::NotEnoughSpaceError);
+    BOOST_TEST(transaction.getSize() == 0);
+
+    // nothing changed
+    BOOST_TEST(cargo1->isEmpty());
+    BOOST_TEST(cargo2->isEmpty());
+    BOOST_TEST(cargo3->getQuantity() == 15);
+    BOOST_TEST(cargo3->getMerchLoad()->getPrice() == 30);
+    BOOST_TEST(fishInCity.getQuantity() == 50);
+    BOOST_TEST(fishInCity.getPrice() == 10);
+
+    // selling from an empty car fails after emptying another one
+    transaction.load(cargo3->getCarId(), fishInCity, 5);
+    transaction.unLoad(cargo3->getCarId(), fishInCity, 20);
+    transaction.unLoad(cargo1->getCarId(), fishInCity, 10);
+    BOOST_CHECK_THROW(transaction.commit(), cars::NotEnoughLoadError);
+    BOOST_TEST(cargo3->getQuantity() == 15);
+    BOOST_TEST(cargo3->getMerchLoad()->getPrice() == 30);
+    BOOST_TEST(fishInCity.getQuantity() == 50);
+    BOOST_TEST(fishInCity.getPrice() == 10);
+
+    // selling to a load of another merch fails
+    merchandises::MerchLoad woodInCity(merchandises::wood, 50, 10);
+    transaction.unLoad(cargo3->getCarId(), woodInCity, 5);
+    BOOST_CHECK_THROW(transaction.commit(), merchandises::NotSameMerchError);
+    BOOST_TEST(cargo3->getQuantity() == 15);
+    BOOST_TEST(woodInCity.getQuantity() == 50);
+}
+
+BOOST_AUTO_TEST_CASE(testRemovedCar) {
+    // create a train with two cargos
+    train::Train train;
+    auto cargo1 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    auto cargo2 = std::make_shared<cars::LoadCar>(cars::Merchandise());
+    train.addCar(cargo1);
+    train.addCar(cargo2);
+
+    // stage a load in both cars, then remove the last one
+    merchandises::MerchLoad fishInCity(merchandises::fish, 50, 10);
+    train::Transaction transaction = train.beginTransaction();
+    transaction.load(cargo1->getCarId(), fishInCity, 5);
+    transaction.load(cargo2->getCarId(), fishInCity, 5);
+    train.removeCar(cargo2->getCarId());
+
+    // the commit fails and nothing changed
+    BOOST_CHECK_THROW(transaction.commit(), train::StaleHandleError);
+    BOOST_TEST(cargo1->isEmpty());
+    BOOST_TEST(cargo2->isEmpty());
+    BOOST_TEST(fishInCity.getQuantity() == 50);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // transaction
+
+BOOST_AUTO_TEST_SUITE_END() // train
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gameplay/train/cars_data.hpp"
+#include "gameplay/train/merchandises_data.hpp"
+#include "gameplay/train/train.hpp"
+#include "tools/allocations.hpp"
+
+namespace {
+
+/**
+ * Number of samples timed for each workload.
+ */
+const std::size_t sampleCount = 15;
+
+/**
+ * Slowdown tolerated for workloads added to the baseline.
+ */
+const double defaultTolerance = 1.5;
+
+/**
+ * Number of load cars of the trains of the workloads.
+ */
+const std::size_t carCount = 32;
+
+/**
+ * Results of the queries, so that they are not optimized out.
+ */
+volatile std::uint64_t sink = 0;
+
+/**
+ * Workload run against the train library.
+ */
+struct Workload {
+    /**
+     * Name of the workload, used in the baseline.
+     */
+    std::string name;
+
+    /**
+     * Number of operations per sample.
+     */
+    std::size_t operationCount;
+
+    /**
+     * Operation, keeping alive what it works on.
+     */
+    std::function<void()> operation;
+};
+
+/**
+ * Median costs of an operation.
+ */
+struct Cost {
+    /**
+     * Duration, in nanoseconds.
+     */
+    double nanoseconds;
+
+    /**
+     * Number of allocations.
+     */
+    double allocations;
+
+    /**
+     * Slowdown tolerated, for costs of the baseline.
+     */
+    double tolerance;
+};
+
+/**
+ * Create a train with a locomotive and empty box cars.
+ * @return Train.
+ */
+std::shared_ptr<train::Train> makeTrain() {
+    auto train = std::make_shared<train::Train>();
+    train->makeOwnedCar<cars::Locomotive>(1, "locomotive", 100, 1000);
+
+    for (std::size_t index = 0; index < carCount; index++) {
+        train->makeOwnedCar<cars::LoadCar>(cars::Merchandise());
+    }
+
+    return train;
+}
+
+/**
+ * Create the workloads.
+ * @return Workloads.
+ */
+std::vector<Workload> makeWorkloads() {
+    std::vector<Workload> workloads;
+    const types::quantity capacity = carCount * 20;
+
+    // fill every car of the train and empty it again
+    auto trader = makeTrain();
+    workloads.push_back({"bulk-trade", 200, [trader, capacity]() {
+        merchandises::MerchLoad merchLoad(merchandises::wood, capacity, 10);
+        trader->buy(merchLoad, capacity);
+        sink += trader->sell(merchandises::wood, capacity).getQuantity();
+    }
+                        });
+
+    // move the whole cargo to another train and back
+    auto first = makeTrain();
+    auto second = makeTrain();
+    merchandises::MerchLoad merchLoad(merchandises::wood, capacity, 10);
+    first->buy(merchLoad, capacity);
+    workloads.push_back({"bulk-transfer", 200, [first, second, capacity]() {
+        first->transfer(*second, merchandises::wood, capacity);
+        second->transfer(*first, merchandises::wood, capacity);
+    }
+                        });
+
+    // rotate the consist by moving the last car first
+    auto rotated = makeTrain();
+    workloads.push_back({"consist-moves", 2000, [rotated]() {
+        const cars::Car& car = rotated->get(rotated->getHandleAt(rotated->getSize() - 1));
+        rotated->moveCar(car.getCarId(), 0);
+    }
+                        });
+
+    // query a loaded train as a whole
+    auto queried = makeTrain();
+    merchandises::MerchLoad fish(merchandises::fish, capacity / 2, 12);
+    queried->buy(fish, capacity / 2);
+    workloads.push_back({"aggregate-queries", 2000, [queried, capacity]() {
+        sink += queried->computeTraction().weight;
+        sink += queried->computeHash();
+        sink += queried->canSell(merchandises::fish, capacity / 2);
+        sink += queried->canReceive(merchandises::wood, capacity / 2);
+    }
+                        });
+
+    return workloads;
+}
+
+/**
+ * Measure the median costs of the operation of a workload.
+ * @param workload Workload to measure.
+ * @return Costs of an operation.
+ */
+Cost measure(const Workload& workload) {
+    std::vector<double> durations;
+    std::vector<double> counts;
+
+    // the first sample only warms up the caches and the allocators
+    for (std::size_t sample = 0; sample <= sampleCount; sample++) {
+        std::uint64_t count = allocations::getCount();
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::size_t operation = 0; operation < workload.operationCount; operation++) {
+            workload.operation();
+        }
+
+        std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() -
+                start;
+
+        if (!sample) continue;
+
+        durations.push_back(duration.count() / workload.operationCount);
+        counts.push_back(static_cast<double>(allocations::getCount() - count) /
+                         workload.operationCount);
+    }
+
+    std::sort(durations.begin(), durations.end());
+    std::sort(counts.begin(), counts.end());
+    return {durations[sampleCount / 2], counts[sampleCount / 2], defaultTolerance};
+}
+
+/**
+ * Read a baseline.
+ * Each line gives the name of a workload, the median duration of an
+ * operation in nanoseconds, its number of allocations and the slowdown
+ * tolerated. Empty lines and lines starting with `#` are ignored.
+ * @param path Path of the baseline file.
+ * @param baseline Costs by workload.
+ * @return True if the file could be read.
+ */
+bool readBaseline(const std::string& path, std::map<std::string, Cost>& baseline) {
+    std::ifstream file(path);
+
+    if (!file) return false;
+
+    std::string line;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream stream(line);
+        std::string name;
+        Cost cost;
+
+        if (!(stream >> name >> cost.nanoseconds >> cost.allocations >> cost.tolerance)) {
+            return false;
+        }
+
+        baseline[name] = cost;
+    }
+
+    return true;
+}
+
+/**
+ * Write a baseline.
+ * @param path Path of the baseline file.
+ * @param baseline Costs by workload.
+ * @return True if the file could be written.
+ */
+bool writeBaseline(const std::string& path, const std::map<std::string, Cost>& baseline) {
+    std::ofstream file(path);
+
+    if (!file) return false;
+
+    file << "# Performance baseline of the train library, from a release build." << std::endl;
+    file << "# workload, nanoseconds per operation, allocations per operation, slowdown "
+         "tolerated" << std::endl;
+
+    for (const auto& entry : baseline) {
+        file << entry.first << " " << entry.second.nanoseconds << " " <<
+             entry.second.allocations << " " << entry.second.tolerance << std::endl;
+    }
+
+    return static_cast<bool>(file);
+}
+
+}
+
+/**
+ * Run the workloads and compare their costs to a baseline.
+ * Fails if an operation is slower than tolerated or allocates more. With
+ * `--update`, the baseline is written again with the measured costs, keeping
+ * the tolerances.
+ * Usage: `test-performance BASELINE [--update]`.
+ */
+int main(int argc, char* argv[]) {
+    bool isUpdate = argc == 3 && std::string(argv[2]) == "--update";
+
+    if (argc != 2 && !isUpdate) {
+        std::cerr << "Usage: " << argv[0] << " BASELINE [--update]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::map<std::string, Cost> baseline;
+
+    if (!readBaseline(argv[1], baseline) && !isUpdate) {
+        std::cerr << "Cannot read " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool isRegressed = false;
+
+    for (const auto& workload : makeWorkloads()) {
+        Cost cost = measure(workload);
+        std::cout << workload.name << ": " << cost.nanoseconds << " ns, " <<
+                  cost.allocations << " allocations";
+        auto it = baseline.find(workload.name);
+
+        if (isUpdate) {
+            if (it != baseline.end()) cost.tolerance = it->second.tolerance;
+
+            baseline[workload.name] = cost;
+            std::cout << std::endl;
+            continue;
+        }
+
+        if (it == baseline.end()) {
+            std::cout << ", no baseline" << std::endl;
+            isRegressed = true;
+            continue;
+        }
+
+        // allocation counts do not depend on the machine, so none is tolerated
+        const Cost& expected = it->second;
+        bool isSlower = cost.nanoseconds > expected.nanoseconds * expected.tolerance;
+        bool isAllocating = cost.allocations > expected.allocations + 1e-6;
+        std::cout << " (baseline " << expected.nanoseconds << " ns, " << expected.allocations <<
+                  " allocations)" << (isSlower ? ", slower" : "") <<
+                  (isAllocating ? ", allocates more" : "") << std::endl;
+        isRegressed = isRegressed || isSlower || isAllocating;
+    }
+
+    if (isUpdate && !writeBaseline(argv[1], baseline)) {
+        std::cerr << "Cannot write " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return isRegressed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
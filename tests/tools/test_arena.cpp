@@ -0,0 +1,52 @@
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/arena.hpp"
+
+BOOST_AUTO_TEST_SUITE(arena)
+
+BOOST_AUTO_TEST_CASE(testAllocate) {
+    arena::Arena arena(1024);
+    BOOST_TEST(arena.getReserved() == 0);
+
+    // allocate in the same block
+    void* first = arena.allocate(10);
+    void* second = arena.allocate(20);
+    BOOST_TEST(arena.getReserved() == 1024);
+    BOOST_TEST(arena.getCount() == 2);
+    BOOST_TEST(arena.getUsed() == arena::alignment + 2 * arena::alignment);
+    BOOST_TEST(reinterpret_cast<std::size_t>(second) % arena::alignment == 0);
+    BOOST_TEST(first != second);
+
+    // freed memory is reused for the same size
+    arena.deallocate(first, 10);
+    BOOST_TEST(arena.getCount() == 1);
+    BOOST_TEST(arena.allocate(12) == first);
+
+    // large allocations get their own block
+    arena.allocate(2000);
+    BOOST_TEST(arena.getReserved() == 1024 + 2000);
+}
+
+BOOST_AUTO_TEST_CASE(testMakeShared) {
+    auto arena = std::make_shared<arena::Arena>();
+
+    // objects are allocated from the arena
+    auto value = arena::makeShared<int>(arena.get(), 42);
+    BOOST_TEST(*value == 42);
+    BOOST_TEST(arena->getCount() == 1);
+
+    // objects keep the arena alive
+    std::weak_ptr<arena::Arena> weakArena = arena;
+    arena.reset();
+    BOOST_TEST(!weakArena.expired());
+    value.reset();
+    BOOST_TEST(weakArena.expired());
+
+    // objects can be allocated on the heap
+    auto heapValue = arena::makeShared<int>(nullptr, 42);
+    BOOST_TEST(*heapValue == 42);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // arena
@@ -0,0 +1,145 @@
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/catalog.hpp"
+
+namespace {
+
+/**
+ * Entry of test catalogs.
+ */
+struct Entry {
+    /**
+     * ID of the entry.
+     */
+    types::id id;
+
+    /**
+     * Name of the entry.
+     */
+    std::string name;
+
+    /**
+     * Usual constructor.
+     * @param id ID of the entry.
+     * @param name Name of the entry.
+     */
+    Entry(const types::id id, const std::string& name) :
+        id(id), name(name) {}
+
+    /**
+     * Getter for ID.
+     * @return ID.
+     */
+    types::id getId() const {
+        return id;
+    }
+
+    /**
+     * Getter for name.
+     * @return Name.
+     */
+    std::string getName() const {
+        return name;
+    }
+};
+
+/**
+ * Names of built-in entries.
+ */
+constexpr const char* names[] = {"coal", "iron", "steel"};
+
+/**
+ * Seed of the names of built-in entries.
+ */
+constexpr std::uint64_t nameSeed = catalog::findSeed(names, 3);
+
+/**
+ * IDs of built-in entries.
+ */
+constexpr types::id ids[] = {7, 8, 9};
+
+/**
+ * Seed of the IDs of built-in entries.
+ */
+constexpr std::uint64_t idSeed = catalog::findSeed(ids, 3);
+
+}
+
+BOOST_AUTO_TEST_SUITE(catalog)
+
+BOOST_AUTO_TEST_CASE(testHash) {
+    // texts hash the same at compile time and at runtime
+    constexpr std::uint64_t hash = hash::hashString("coal", 3);
+    BOOST_TEST(hash == hash::hashString(std::string("coal"), 3));
+    BOOST_TEST(hash != hash::hashString(std::string("coal"), 4));
+    BOOST_TEST(hash != hash::hashString(std::string("coat"), 3));
+}
+
+BOOST_AUTO_TEST_CASE(testFindSeed) {
+    static_assert(nameSeed != catalog::noSeed, "Names are unique");
+    static_assert(idSeed != catalog::noSeed, "IDs are unique");
+
+    // duplicate keys never fit
+    constexpr const char* duplicates[] = {"coal", "iron", "coal"};
+    static_assert(catalog::findSeed(duplicates, 3) == catalog::noSeed, "Names are duplicate");
+
+    BOOST_TEST(catalog::getTableSize(3) == 16);
+    BOOST_TEST(catalog::getTableSize(0) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(testFind) {
+    std::vector<std::unique_ptr<Entry>> builtIns;
+
+    for (std::size_t index = 0; index < 3; index++) {
+        builtIns.emplace_back(new Entry(ids[index], names[index]));
+    }
+
+    catalog::Catalog<Entry> entries(std::move(builtIns), nameSeed, idSeed);
+    BOOST_TEST(entries.size() == 3);
+
+    // find by name and by ID
+    BOOST_TEST(entries.getByName("iron").getId() == 8);
+    BOOST_TEST(entries.getById(9).getName() == "steel");
+    BOOST_TEST(&entries.get(0) == entries.findByName("coal"));
+    BOOST_TEST(&entries.get(entries.getIndex(9)) == &entries.getById(9));
+
+    // unknown entries
+    BOOST_CHECK(!entries.findByName("copper"));
+    BOOST_CHECK(!entries.findById(10));
+    BOOST_CHECK_THROW(entries.getByName("copper"), catalog::EntryNotFoundError);
+    BOOST_CHECK_THROW(entries.getById(10), catalog::EntryNotFoundError);
+    BOOST_CHECK_THROW(entries.getIndex(10), catalog::EntryNotFoundError);
+}
+
+BOOST_AUTO_TEST_CASE(testAdd) {
+    catalog::Catalog<Entry> entries;
+    BOOST_CHECK(!entries.findByName("coal"));
+    BOOST_CHECK(!entries.findById(0));
+
+    // add many entries, rebuilding the tables on the way
+    for (types::id id = 0; id < 5000; id++) {
+        entries.emplace(id, "entry " + std::to_string(id));
+    }
+
+    const Entry& first = entries.getById(0);
+    entries.emplace(5000, "coal");
+
+    for (types::id id = 0; id < 5000; id++) {
+        BOOST_TEST(entries.getByName("entry " + std::to_string(id)).getId() == id);
+        BOOST_TEST(entries.getById(id).getName() == "entry " + std::to_string(id));
+    }
+
+    // entries are not moved
+    BOOST_TEST(&entries.getById(0) == &first);
+    BOOST_TEST(entries.getByName("coal").getId() == 5000);
+    BOOST_TEST(entries.getIndex(5000) == 5000);
+
+    // names and IDs are unique
+    BOOST_CHECK_THROW(entries.emplace(5001, "coal"), catalog::DuplicateEntryError);
+    BOOST_CHECK_THROW(entries.emplace(5000, "iron"), catalog::DuplicateEntryError);
+    BOOST_TEST(entries.size() == 5001);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#include <memory>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/containers.hpp"
+
+BOOST_AUTO_TEST_SUITE(containers)
+
+BOOST_AUTO_TEST_CASE(testInline) {
+    containers::SmallVector<int, 4> vector;
+    BOOST_CHECK(vector.empty());
+    BOOST_TEST(vector.capacity() == 4);
+
+    // elements fit inline
+    for (int value = 0; value < 4; value++) {
+        vector.push_back(value);
+    }
+
+    BOOST_CHECK(vector.isInline());
+    BOOST_TEST(vector.getHeapUsage() == 0);
+    BOOST_TEST(vector.size() == 4);
+    BOOST_TEST(vector.back() == 3);
+
+    // more elements go to the heap
+    vector.push_back(4);
+    BOOST_CHECK(!vector.isInline());
+    BOOST_TEST(vector.capacity() == 8);
+    BOOST_TEST(vector.getHeapUsage() == 8 * sizeof(int));
+
+    for (int value = 0; value < 5; value++) {
+        BOOST_TEST(vector[value] == value);
+    }
+
+    // the storage is kept when clearing
+    vector.clear();
+    BOOST_CHECK(vector.empty());
+    BOOST_TEST(vector.capacity() == 8);
+}
+
+BOOST_AUTO_TEST_CASE(testInsertErase) {
+    containers::SmallVector<int, 2> vector;
+    vector.push_back(1);
+    vector.push_back(3);
+
+    // insert in the middle, growing the vector
+    auto it = vector.insert(vector.begin() + 1, 2);
+    BOOST_TEST(*it == 2);
+    BOOST_TEST(vector.size() == 3);
+
+    // insert a copy of an element of the vector
+    vector.insert(vector.begin(), vector.back());
+    int expected[] = {3, 1, 2, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(vector.begin(), vector.end(), expected, expected + 4);
+
+    // erase elements
+    it = vector.erase(vector.begin());
+    BOOST_TEST(*it == 1);
+    vector.erase(vector.end() - 1);
+    vector.pop_back();
+    BOOST_TEST(vector.size() == 1);
+    BOOST_TEST(vector[0] == 1);
+}
+
+BOOST_AUTO_TEST_CASE(testObjects) {
+    auto counter = std::make_shared<int>(0);
+
+    {
+        // move only elements
+        containers::SmallVector<std::unique_ptr<std::string>, 2> vector;
+        vector.emplace_back(new std::string("first"));
+        vector.emplace_back(new std::string("second"));
+        vector.emplace_back(new std::string("third"));
+        vector.erase(vector.begin());
+        BOOST_TEST(*vector[0] == "second");
+        BOOST_TEST(*vector[1] == "third");
+
+        // elements are destroyed with the vector
+        containers::SmallVector<std::shared_ptr<int>, 2> shared;
+
+        for (int index = 0; index < 5; index++) {
+            shared.push_back(counter);
+        }
+
+        BOOST_TEST(counter.use_count() == 6);
+
+        // copy and move the vector
+        containers::SmallVector<std::shared_ptr<int>, 2> copy(shared);
+        BOOST_TEST(counter.use_count() == 11);
+        containers::SmallVector<std::shared_ptr<int>, 2> moved(std::move(copy));
+        BOOST_TEST(counter.use_count() == 11);
+        BOOST_CHECK(copy.empty());
+        BOOST_TEST(moved.size() == 5);
+        copy = moved;
+        BOOST_TEST(counter.use_count() == 16);
+    }
+
+    BOOST_TEST(counter.use_count() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
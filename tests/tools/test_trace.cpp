@@ -0,0 +1,60 @@
+#include <sstream>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/trace.hpp"
+
+BOOST_AUTO_TEST_SUITE(trace)
+
+BOOST_AUTO_TEST_CASE(testStatistics) {
+    trace::clear();
+
+    // record events in two threads
+    for (int i = 0; i < 3; i++) {
+        trace::Scope scope("main");
+    }
+
+    std::thread worker([]() {
+        trace::Scope scope("worker");
+    });
+    worker.join();
+
+    // count calls
+    auto statistics = trace::computeStatistics();
+    BOOST_TEST(statistics.size() == 2);
+    BOOST_TEST(statistics["main"].count == 3);
+    BOOST_TEST(statistics["worker"].count == 1);
+
+    // every call is in the histogram
+    std::uint64_t total = 0;
+
+    for (const auto count : statistics["main"].histogram) {
+        total += count;
+    }
+
+    BOOST_TEST(total == 3);
+
+    // discard events
+    trace::clear();
+    BOOST_TEST(trace::computeStatistics().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testExportChromeTrace) {
+    trace::clear();
+    trace::record({"event \"quoted\"", 1000, 2000});
+
+    // export events
+    std::ostringstream stream;
+    trace::exportChromeTrace(stream);
+    std::string json = stream.str();
+    BOOST_TEST(json.find("\"traceEvents\"") != std::string::npos);
+    BOOST_TEST(json.find("\"name\":\"event \\\"quoted\\\"\"") != std::string::npos);
+    BOOST_TEST(json.find("\"ph\":\"X\"") != std::string::npos);
+    BOOST_TEST(json.find("\"ts\":1.000,\"dur\":2.000") != std::string::npos);
+    BOOST_TEST(json.find("\"count\":1") != std::string::npos);
+
+    trace::clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END() // trace